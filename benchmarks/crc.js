@@ -0,0 +1,68 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Compares the synchronous crc32/crc32c functions with the async ones, which split large inputs across the libuv
+ * thread pool, with crc32c_parts, and with zlib.crc32 where node has it (node 20.15+/22.2+).
+ *
+ *     node benchmarks/crc.js [sizes in MB...]
+ *
+ * Inputs above 1 GB are checksummed one 1 GB buffer at a time, passing the previous checksum along, so that the 5 GB
+ * case doesn't need 5 GB of memory.
+ */
+const crypto = require("crypto");
+const zlib = require("zlib");
+const { native_module, time_ms, report } = require("./util");
+
+const checksums = native_module("checksums");
+
+const MB = 1024 * 1024;
+const MAX_BUFFER = 1024 * MB;
+const PART_SIZE = 8 * MB;
+
+const sizes = (process.argv.length > 2) ?
+    process.argv.slice(2).map((mb) => parseInt(mb) * MB) :
+    [MB, 100 * MB, 5120 * MB];
+
+/* Runs fn(buffer, previous) over size bytes of buffer, repeating it as needed */
+async function over(size, buffer, fn) {
+    let previous = undefined;
+    for (let done = 0; done < size; done += buffer.length) {
+        const chunk = (size - done < buffer.length) ? buffer.subarray(0, size - done) : buffer;
+        previous = await fn(chunk, previous);
+    }
+    return previous;
+}
+
+async function main() {
+    const buffer = crypto.randomBytes(Math.min(Math.max(...sizes), MAX_BUFFER));
+
+    for (const size of sizes) {
+        console.log(`\n${size / MB} MB`);
+        const min_ms = size > MAX_BUFFER ? 0 : 1000;
+
+        report("crc32", await time_ms(() => over(size, buffer, checksums.crc32), min_ms), size);
+        report("crc32_async", await time_ms(() => over(size, buffer, checksums.crc32_async), min_ms), size);
+        if (typeof zlib.crc32 === "function") {
+            report("node:zlib crc32", await time_ms(() => over(size, buffer, zlib.crc32), min_ms), size);
+        }
+
+        report("crc32c", await time_ms(() => over(size, buffer, checksums.crc32c), min_ms), size);
+        report("crc32c_async", await time_ms(() => over(size, buffer, checksums.crc32c_async), min_ms), size);
+
+        const parts = [];
+        for (let offset = 0; offset < Math.min(size, buffer.length); offset += PART_SIZE) {
+            parts.push(buffer.subarray(offset, Math.min(offset + PART_SIZE, size)));
+        }
+        const rounds = Math.ceil(size / buffer.length);
+        report(`crc32c_parts (${PART_SIZE / MB} MB parts)`, await time_ms(() => {
+            for (let i = 0; i < rounds; ++i) {
+                checksums.crc32c_parts(parts);
+            }
+        }, min_ms), parts.reduce((sum, part) => sum + part.length, 0) * rounds);
+    }
+}
+
+main();
@@ -0,0 +1,51 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Compares hashing many small inputs with hash_sha256_many against a hash_sha256 call per input and node:crypto.
+ *
+ *     node benchmarks/hash_sha256_many.js [count]
+ */
+const crypto = require("crypto");
+const { native_module, time_ms, report } = require("./util");
+
+const crt_crypto = native_module("crypto");
+
+const count = parseInt(process.argv[2] || "1000");
+
+async function main() {
+    for (const size of [64, 1024, 16 * 1024]) {
+        const inputs = [];
+        for (let i = 0; i < count; ++i) {
+            inputs.push(crypto.randomBytes(size));
+        }
+        const out = new ArrayBuffer(32 * count);
+        const total = size * count;
+
+        console.log(`\n${count} inputs of ${size} bytes, time per batch`);
+
+        report("hash_sha256 per input", await time_ms(() => {
+            for (const input of inputs) {
+                crt_crypto.hash_sha256(input);
+            }
+        }), total);
+
+        report("hash_sha256_many", await time_ms(() => {
+            crt_crypto.hash_sha256_many(inputs);
+        }), total);
+
+        report("hash_sha256_many (reused out)", await time_ms(() => {
+            crt_crypto.hash_sha256_many(inputs, out);
+        }), total);
+
+        report("node:crypto createHash per input", await time_ms(() => {
+            for (const input of inputs) {
+                crypto.createHash("sha256").update(input).digest();
+            }
+        }), total);
+    }
+}
+
+main();
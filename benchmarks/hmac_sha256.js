@@ -0,0 +1,50 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Measures repeated HMAC-SHA256 with one key over many SigV4 sized strings-to-sign, the case a keyed HMAC context
+ * would speed up, against node:crypto.
+ *
+ *     node benchmarks/hmac_sha256.js [count]
+ */
+const crypto = require("crypto");
+const { native_module, time_ms, report } = require("./util");
+
+const crt_crypto = native_module("crypto");
+
+const count = parseInt(process.argv[2] || "1000");
+
+async function main() {
+    const signing_key = crypto.randomBytes(32);
+    const strings_to_sign = [];
+    for (let i = 0; i < count; ++i) {
+        strings_to_sign.push(crypto.randomBytes(256).toString("hex"));
+    }
+    const total = strings_to_sign.reduce((sum, string) => sum + string.length, 0);
+
+    console.log(`${count} strings-to-sign of 512 bytes with one key, time per batch`);
+
+    report("hmac_sha256 per string", await time_ms(() => {
+        for (const string of strings_to_sign) {
+            crt_crypto.hmac_sha256(signing_key, string);
+        }
+    }), total);
+
+    report("Sha256Hmac per string", await time_ms(() => {
+        for (const string of strings_to_sign) {
+            const hmac = new crt_crypto.Sha256Hmac(signing_key);
+            hmac.update(string);
+            hmac.finalize();
+        }
+    }), total);
+
+    report("node:crypto createHmac per string", await time_ms(() => {
+        for (const string of strings_to_sign) {
+            crypto.createHmac("sha256", signing_key).update(string).digest();
+        }
+    }), total);
+}
+
+main();
@@ -0,0 +1,65 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Measures throughput of the chunked buffer behind a Readable-backed InputStream: data is appended the way
+ * InputStream forwards 'data' events, and read back out the way an HTTP stream pulls a request body, with about 1MB
+ * buffered in between. Reads happen on this thread rather than an event loop, so the numbers are for the buffer alone.
+ *
+ *     node benchmarks/input_stream.js [total_mb]
+ */
+const { native_module, report } = require("./util");
+
+const crt_native = native_module("binding").default;
+
+const total = parseInt(process.argv[2] || "4096") * 1024 * 1024;
+/* matches what InputStream passes to io_input_stream_new */
+const chunk_size = 16 * 1024;
+const buffered_target = 1024 * 1024;
+
+function run(append_size, read_size) {
+    const stream = crt_native.io_input_stream_new(chunk_size);
+    const source = Buffer.alloc(append_size, "a");
+    const dest = Buffer.alloc(read_size);
+
+    let appended = 0;
+    let read = 0;
+    let ended = false;
+    const start = process.hrtime.bigint();
+    while (read < total) {
+        while (appended < total && appended - read < buffered_target) {
+            crt_native.io_input_stream_append(stream, source);
+            appended += append_size;
+        }
+        if (appended >= total && !ended) {
+            crt_native.io_input_stream_append(stream, undefined);
+            ended = true;
+        }
+        let length = 0;
+        while ((length = crt_native.io_input_stream_read(stream, dest)) > 0) {
+            read += length;
+            if (appended - read < buffered_target / 2 && appended < total) {
+                break;
+            }
+        }
+    }
+    const ms = Number(process.hrtime.bigint() - start) / 1e6;
+
+    if (!crt_native.io_input_stream_is_end_of_stream(stream)) {
+        throw new Error("stream did not reach end of stream");
+    }
+    return ms;
+}
+
+console.log(`${(total / (1024 * 1024)).toFixed(0)} MB through one stream, total time`);
+for (const [append_size, read_size] of [
+    [1024, 64 * 1024],          /* small appends, packed into the tail chunk */
+    [64 * 1024, 16 * 1024],     /* typical fs.ReadStream chunks, reads smaller than a chunk */
+    [64 * 1024, 64 * 1024],
+    [1024 * 1024, 64 * 1024],   /* appends larger than the chunk size */
+    [64 * 1024, 1000],          /* odd read size, reads straddle chunks */
+]) {
+    report(`append ${append_size} / read ${read_size}`, run(append_size, read_size), total);
+}
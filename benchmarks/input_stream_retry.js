@@ -0,0 +1,68 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Measures sending a Readable-backed request body several times, as a retry (or a signer that hashes the payload
+ * first) does. With a replay window covering the body, each attempt after the first seeks back to 0 and reads the
+ * native copy again. Without one, the body has to come from JS again, which is modelled here by appending it to a new
+ * stream for every attempt.
+ *
+ *     node benchmarks/input_stream_retry.js [attempts]
+ */
+const { native_module, time_ms, report } = require("./util");
+
+const crt_native = native_module("binding").default;
+
+const attempts = parseInt(process.argv[2] || "3");
+/* matches what InputStream passes to io_input_stream_new */
+const chunk_size = 16 * 1024;
+const append_size = 64 * 1024;
+const read_size = 64 * 1024;
+
+function append_body(stream, body) {
+    for (let offset = 0; offset < body.length; offset += append_size) {
+        crt_native.io_input_stream_append(stream, body.subarray(offset, offset + append_size));
+    }
+    crt_native.io_input_stream_append(stream, undefined);
+}
+
+function read_body(stream, dest) {
+    let read = 0;
+    let length = 0;
+    while ((length = crt_native.io_input_stream_read(stream, dest)) > 0) {
+        read += length;
+    }
+    return read;
+}
+
+async function main() {
+    const dest = Buffer.alloc(read_size);
+
+    for (const size of [1024 * 1024, 16 * 1024 * 1024, 256 * 1024 * 1024]) {
+        const body = Buffer.alloc(size, "b");
+        console.log(`\n${size / (1024 * 1024)} MB body sent ${attempts} times, time per request`);
+
+        report("replay window, seek back to 0", await time_ms(() => {
+            const stream = crt_native.io_input_stream_new(chunk_size, 0, 0, undefined, Number.MAX_SAFE_INTEGER);
+            append_body(stream, body);
+            for (let attempt = 0; attempt < attempts; ++attempt) {
+                if (attempt > 0) {
+                    crt_native.io_input_stream_seek(stream, 0, false);
+                }
+                read_body(stream, dest);
+            }
+        }), size * attempts);
+
+        report("no replay window, append again", await time_ms(() => {
+            for (let attempt = 0; attempt < attempts; ++attempt) {
+                const stream = crt_native.io_input_stream_new(chunk_size);
+                append_body(stream, body);
+                read_body(stream, dest);
+            }
+        }), size * attempts);
+    }
+}
+
+main();
@@ -0,0 +1,67 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Measures how long it takes a fresh process to load the native binding, how much resident memory loading it adds,
+ * and how long the first calls into the lazily initialized libraries take. Run `npm run tsc` (or `npm install`) first
+ * so that dist/ exists.
+ *
+ *     node benchmarks/startup.js [iterations]
+ */
+const child_process = require("child_process");
+const path = require("path");
+
+const iterations = parseInt(process.argv[2] || "30");
+const binding_path = path.resolve(__dirname, "..", "dist", "native", "binding.js");
+
+/* Runs in each child: prints load and first call times in milliseconds, and RSS in MB around the load, as JSON */
+const child_source = `
+const ms = (start) => Number(process.hrtime.bigint() - start) / 1e6;
+const mb = () => process.memoryUsage().rss / (1024 * 1024);
+const rss_before = mb();
+let start = process.hrtime.bigint();
+const binding = require(${JSON.stringify(binding_path)}).default;
+const load = ms(start);
+const rss_after = mb();
+
+start = process.hrtime.bigint();
+binding.hash_sha256_compute("startup");
+const first_cal = ms(start);
+
+start = process.hrtime.bigint();
+new binding.HttpHeaders().add("name", "value");
+const first_http = ms(start);
+
+console.log(JSON.stringify({ load, first_cal, first_http, rss_before, rss_after, rss_load: rss_after - rss_before }));
+`;
+
+function run_once() {
+    const start = process.hrtime.bigint();
+    const output = child_process.execFileSync(process.execPath, ["-e", child_source], { encoding: "utf8" });
+    const total = Number(process.hrtime.bigint() - start) / 1e6;
+    return Object.assign(JSON.parse(output), { process: total });
+}
+
+function percentile(sorted, p) {
+    return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+/* one untimed run to warm the file system cache */
+run_once();
+
+const samples = [];
+for (let i = 0; i < iterations; ++i) {
+    samples.push(run_once());
+}
+
+console.log(`${iterations} fresh processes, node ${process.version}, times in ms, rss in MB`);
+console.log("metric".padEnd(12) + "p50".padStart(10) + "p90".padStart(10) + "min".padStart(10));
+for (const metric of ["load", "first_cal", "first_http", "process", "rss_before", "rss_after", "rss_load"]) {
+    const sorted = samples.map((sample) => sample[metric]).sort((a, b) => a - b);
+    console.log(metric.padEnd(12) +
+        percentile(sorted, 0.5).toFixed(2).padStart(10) +
+        percentile(sorted, 0.9).toFixed(2).padStart(10) +
+        sorted[0].toFixed(2).padStart(10));
+}
@@ -0,0 +1,69 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Measures the cost of passing JS strings into native code: one-shot hashing of strings below and above the small
+ * string storage size (256 bytes, see AWS_NAPI_SMALL_STRING_STORAGE_SIZE), and class binder string arguments through
+ * HttpHeaders and HttpRequest. Short strings are copied into stack storage, longer ones are measured and allocated.
+ *
+ * To compare before and after aws_byte_buf_init_from_napi_with_storage, run this against a build of the commit before
+ * it and a build of the current tree, passing a label to tell the runs apart:
+ *
+ *     node benchmarks/string_args.js before
+ *     node benchmarks/string_args.js after
+ */
+const { native_module, time_ms, report } = require("./util");
+
+const crt_crypto = native_module("crypto");
+const crt_http = native_module("http");
+
+const label = process.argv[2] || "current";
+const count = 1000;
+
+async function main() {
+    console.log(`${label}: ${count} calls per batch, time per batch`);
+
+    console.log("\nhash_sha256 of a string");
+    for (const size of [16, 64, 200, 255, 256, 1024, 16 * 1024]) {
+        const data = "a".repeat(size);
+        report(`${size} ascii bytes`, await time_ms(() => {
+            for (let i = 0; i < count; ++i) {
+                crt_crypto.hash_sha256(data);
+            }
+        }), size * count);
+    }
+    /* multi-byte strings take the fallback path once their utf8 length no longer fits */
+    for (const size of [64, 255, 256, 1024]) {
+        const data = "é".repeat(size / 2);
+        report(`${size} utf8 bytes (2 byte chars)`, await time_ms(() => {
+            for (let i = 0; i < count; ++i) {
+                crt_crypto.hash_sha256(data);
+            }
+        }), size * count);
+    }
+
+    console.log("\nclass binder string arguments");
+    for (const size of [16, 200, 1024]) {
+        const name = "x-amz-" + "n".repeat(Math.max(0, size - 6));
+        const value = "v".repeat(size);
+
+        const headers = new crt_http.HttpHeaders();
+        report(`HttpHeaders set/get, ${size} byte strings`, await time_ms(() => {
+            for (let i = 0; i < count; ++i) {
+                headers.set(name, value);
+                headers.get(name);
+            }
+        }), 3 * size * count);
+
+        const path = "/" + "p".repeat(size - 1);
+        report(`new HttpRequest, ${size} byte path`, await time_ms(() => {
+            for (let i = 0; i < count; ++i) {
+                new crt_http.HttpRequest("GET", path);
+            }
+        }), size * count);
+    }
+}
+
+main();
@@ -0,0 +1,67 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Compares creating many ClientTlsContexts with identical options with and without use_context_cache: the time to
+ * create them, and the native io memory they hold while alive, from native_memory_breakdown().io. Without the cache
+ * every context loads the system trust store again.
+ *
+ *     node --expose-gc benchmarks/tls_ctx_cache.js [count]
+ */
+const { native_module } = require("./util");
+
+const io = native_module("io");
+const crt = native_module("crt");
+
+const count = parseInt(process.argv[2] || "100");
+
+function collect() {
+    if (global.gc) {
+        global.gc();
+    }
+}
+
+function run(use_context_cache) {
+    collect();
+    const before = crt.native_memory_breakdown().io;
+
+    const contexts = [];
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < count; ++i) {
+        const options = new io.TlsContextOptions();
+        options.verify_peer = true;
+        options.use_context_cache = use_context_cache;
+        contexts.push(new io.ClientTlsContext(options));
+    }
+    const ms = Number(process.hrtime.bigint() - start) / 1e6;
+
+    const after = crt.native_memory_breakdown().io;
+    return {
+        ms,
+        bytes: after.bytes_active - before.bytes_active,
+        allocations: after.allocations_active - before.allocations_active,
+        live: contexts.length,
+    };
+}
+
+if (!global.gc) {
+    console.log("run with --expose-gc so that contexts from one run are released before the next");
+}
+
+/* one untimed run of each to load the trust store from disk into the page cache */
+run(false);
+run(true);
+
+console.log(`${count} ClientTlsContexts with identical options, kept alive until measured`);
+console.log("use_context_cache".padEnd(20) +
+    "total ms".padStart(12) + "ms each".padStart(12) + "io KB".padStart(12) + "io allocs".padStart(12));
+for (const use_context_cache of [false, true]) {
+    const result = run(use_context_cache);
+    console.log(String(use_context_cache).padEnd(20) +
+        result.ms.toFixed(1).padStart(12) +
+        (result.ms / result.live).toFixed(3).padStart(12) +
+        (result.bytes / 1024).toFixed(1).padStart(12) +
+        String(result.allocations).padStart(12));
+}
@@ -0,0 +1,44 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+/*
+ * Helpers shared by the benchmark scripts. The scripts run against the compiled package, so run `npm run tsc` (or
+ * `npm install`) first so that dist/ exists.
+ */
+const path = require("path");
+
+/** Loads a compiled module from dist/native, e.g. native_module("crypto") */
+function native_module(name) {
+    return require(path.resolve(__dirname, "..", "dist", "native", name + ".js"));
+}
+
+/**
+ * Calls fn repeatedly for at least min_ms (after a short warm up) and returns the mean milliseconds per call. fn may
+ * return a promise, in which case calls are made one after another.
+ */
+async function time_ms(fn, min_ms = 1000) {
+    await fn();
+
+    let calls = 0;
+    const start = process.hrtime.bigint();
+    let elapsed = 0;
+    do {
+        await fn();
+        calls++;
+        elapsed = Number(process.hrtime.bigint() - start) / 1e6;
+    } while (elapsed < min_ms);
+
+    return elapsed / calls;
+}
+
+/** Prints one result row: the name, the time per call, and the throughput for bytes processed per call */
+function report(name, ms_per_call, bytes_per_call) {
+    const mb_per_s = (bytes_per_call / (1024 * 1024)) / (ms_per_call / 1000);
+    console.log(name.padEnd(40) +
+        `${ms_per_call.toFixed(3)} ms`.padStart(14) +
+        `${mb_per_s.toFixed(1)} MB/s`.padStart(16));
+}
+
+module.exports = { native_module, time_ms, report };
@@ -10,7 +10,7 @@
  * @module binding
  */
 
-import { InputStream, TlsContextOptions } from "./io";
+import { HostAddress, InputStream, TlsContextOptions } from "./io";
 import {AwsSigningConfig, CognitoCredentialsProviderConfig, X509CredentialsConfig} from "./auth";
 import { HttpHeader, HttpHeaders as CommonHttpHeaders } from "../common/http";
 import { OnMessageCallback, QoS } from "../common/mqtt";
@@ -19,6 +19,8 @@ import * as mqtt5_packet from "../common/mqtt5_packet";
 import { PublishCompletionResult } from "../common/mqtt5";
 import * as eventstream from "./eventstream";
 import { ConnectionStatistics } from "./mqtt";
+import { NativeMemoryBreakdown, NativeMemoryPoolStatistics } from "./crt";
+import { DigestEncoding } from "./crypto";
 
 
 /**
@@ -38,6 +40,13 @@ export function native_memory(): number;
 /** @internal */
 export function native_memory_dump(): void;
 /** @internal */
+export function native_memory_pool_statistics(): NativeMemoryPoolStatistics;
+/** @internal */
+export function native_memory_pool_exercise(rounds: number, count: number):
+    { max_bytes_kept: number, cache_limit_bytes: number, cache_count: number };
+/** @internal */
+export function native_memory_breakdown(): NativeMemoryBreakdown;
+/** @internal */
 export function error_code_to_string(error_code: number): string;
 /** @internal */
 export function error_code_to_name(error_code: number): string;
@@ -48,10 +57,47 @@ export function disable_threadsafe_function(): number;
 /** @internal */
 export function io_logging_enable(log_level: number): void;
 /** @internal */
+export function io_logging_enable_file(
+    path: string,
+    log_level: number,
+    buffer_size?: number,
+    flush_interval_ms?: number,
+    max_file_size?: number,
+    max_files?: number,
+): void;
+/** @internal */
+export function io_logging_disable_file(): void;
+/** @internal */
+export function io_logging_set_subject_level(subject: string | number, log_level?: number): void;
+/** @internal */
+export function io_logging_set_subject_rate_limit(
+    subject: string | number,
+    messages_per_second: number,
+    burst?: number,
+): void;
+/** @internal */
+export function io_logging_get_subject_level(subject: string | number): number;
+/** @internal */
+export function io_logging_log(subject: string | number, log_level: number, message: string): void;
+/** @internal */
 export function is_alpn_available(): boolean;
 /* wraps aws_client_bootstrap #TODO: Wrap with ClassBinder */
 /** @internal */
-export function io_client_bootstrap_new(): NativeHandle;
+export function io_client_bootstrap_new(event_loop_thread_count?: number, host_resolver?: NativeHandle): NativeHandle;
+/** @internal */
+export function io_set_default_event_loop_thread_count(thread_count: number): void;
+/** @internal */
+export function io_set_default_host_resolver_options(max_entries?: number, max_ttl_secs?: number): void;
+/** @internal */
+export function io_host_resolver_new(use_default: boolean, max_entries?: number, max_ttl_secs?: number): NativeHandle;
+/** @internal */
+export function io_host_resolver_resolve(
+    resolver: NativeHandle,
+    host: StringLike,
+    on_resolved: (error_code: number, addresses: HostAddress[]) => void
+): void;
+/** @internal */
+export function io_host_resolver_prefetch(resolver: NativeHandle, hosts: StringLike[]): void;
 /* wraps aws_tls_context #TODO: Wrap with ClassBinder */
 /** @internal */
 export function io_tls_ctx_new(
@@ -69,7 +115,10 @@ export function io_tls_ctx_new(
     pkcs11_options?: TlsContextOptions.Pkcs11Options,
     windows_cert_store_path?: StringLike,
     verify_peer?: boolean,
+    use_cache?: boolean,
 ): NativeHandle;
+/** @internal */
+export function io_tls_ctx_cache_statistics(): { entry_count: number, external_count: number };
 /* wraps aws_tls_connection_options #TODO: Wrap with ClassBinder */
 /** @internal */
 export function io_tls_connection_options_new(
@@ -91,9 +140,30 @@ export function io_socket_options_new(
 
 /* wraps aws_input_stream #TODO: Wrap with ClassBinder */
 /** @internal */
-export function io_input_stream_new(capacity: number): NativeHandle;
+export function io_input_stream_new(
+    capacity: number,
+    high_watermark?: number,
+    low_watermark?: number,
+    on_resume?: () => void,
+    replay_window?: number
+): NativeHandle;
+/** @internal */
+export function io_input_stream_append(stream: NativeHandle, data?: Buffer): boolean;
 /** @internal */
-export function io_input_stream_append(stream: NativeHandle, data?: Buffer): void;
+export function io_input_stream_new_from_file(
+    path: string,
+    offset: number,
+    length: number | undefined,
+    mmap: boolean
+): NativeHandle;
+/** @internal */
+export function io_input_stream_get_length(stream: NativeHandle): number | undefined;
+/** @internal */
+export function io_input_stream_read(stream: NativeHandle, dest: Buffer): number;
+/** @internal */
+export function io_input_stream_is_end_of_stream(stream: NativeHandle): boolean;
+/** @internal */
+export function io_input_stream_seek(stream: NativeHandle, offset: number, from_end: boolean): void;
 
 /* wraps aws_pkcs11_lib */
 /** @internal */
@@ -102,6 +172,16 @@ export function io_pkcs11_lib_new(path: string, behavior: number): NativeHandle;
 export function io_pkcs11_lib_close(pkcs11_lib: NativeHandle): void;
 
 /* Crypto */
+/**
+ * Where a digest is written: a string selects an encoding to return, a buffer is written into at an offset
+ * @internal
+ */
+export type DigestOutput = DigestEncoding | ArrayBuffer | ArrayBufferView;
+/**
+ * The encoded digest, or the number of bytes written into the output buffer
+ * @internal
+ */
+export type DigestResult = string | number;
 /* wraps aws_hash structures #TODO: Wrap with ClassBinder */
 /** @internal */
 export function hash_md5_new(): void;
@@ -113,13 +193,21 @@ export function hash_sha1_new(): void;
 export function hash_update(handle: NativeHandle, data: StringLike): void;
 /** @internal */
 export function hash_digest(handle: NativeHandle, truncate_to?: number): DataView;
+/** @internal */
+export function hash_digest(handle: NativeHandle, truncate_to: number | undefined, output: DigestOutput, offset?: number): DigestResult;
 
 /** @internal */
 export function hash_md5_compute(data: StringLike, truncate_to?: number): DataView;
 /** @internal */
+export function hash_md5_compute(data: StringLike, truncate_to: number | undefined, output: DigestOutput, offset?: number): DigestResult;
+/** @internal */
 export function hash_sha256_compute(data: StringLike, truncate_to?: number): DataView;
 /** @internal */
+export function hash_sha256_compute(data: StringLike, truncate_to: number | undefined, output: DigestOutput, offset?: number): DigestResult;
+/** @internal */
 export function hash_sha1_compute(data: StringLike, truncate_to?: number): DataView;
+/** @internal */
+export function hash_sha1_compute(data: StringLike, truncate_to: number | undefined, output: DigestOutput, offset?: number): DigestResult;
 
 /** @internal */
 export function hmac_md5_new(secret: StringLike): void;
@@ -129,11 +217,43 @@ export function hmac_sha256_new(secret: StringLike): void;
 export function hmac_update(handle: NativeHandle, data: StringLike): void;
 /** @internal */
 export function hmac_digest(handle: NativeHandle, truncate_to?: number): DataView;
+/** @internal */
+export function hmac_digest(handle: NativeHandle, truncate_to: number | undefined, output: DigestOutput, offset?: number): DigestResult;
 
 /** @internal */
 export function hmac_md5_compute(secret: StringLike, data: StringLike, truncate_to?: number): DataView;
 /** @internal */
 export function hmac_sha256_compute(secret: StringLike, data: StringLike, truncate_to?: number): DataView;
+/** @internal */
+export function hmac_sha256_compute(
+    secret: StringLike,
+    data: StringLike,
+    truncate_to: number | undefined,
+    output: DigestOutput,
+    offset?: number,
+): DigestResult;
+
+/** @internal */
+export type HashCompleteCallback = (error_code: number, digest?: DataView) => void;
+/** @internal */
+export function hash_md5_compute_async(data: StringLike, truncate_to: number | undefined, on_complete: HashCompleteCallback): void;
+/** @internal */
+export function hash_sha1_compute_async(data: StringLike, truncate_to: number | undefined, on_complete: HashCompleteCallback): void;
+/** @internal */
+export function hash_sha256_compute_async(data: StringLike, truncate_to: number | undefined, on_complete: HashCompleteCallback): void;
+/** @internal */
+export function hmac_sha256_compute_async(
+    secret: StringLike,
+    data: StringLike,
+    truncate_to: number | undefined,
+    on_complete: HashCompleteCallback,
+): void;
+/** @internal */
+export function hash_update_async(handle: NativeHandle, data: StringLike, on_complete: HashCompleteCallback): void;
+/** @internal */
+export function hmac_update_async(handle: NativeHandle, data: StringLike, on_complete: HashCompleteCallback): void;
+/** @internal */
+export function hash_sha256_many<T extends ArrayBuffer | ArrayBufferView = DataView>(data: StringLike[], out?: T): T;
 
 /* Checksums */
 /* wraps aws_checksums functions */
@@ -142,6 +262,18 @@ export function hmac_sha256_compute(secret: StringLike, data: StringLike, trunca
 export function checksums_crc32(data: StringLike, previous?: number): number;
 /** @internal */
 export function checksums_crc32c(data: StringLike, previous?: number): number;
+/** @internal */
+export function checksums_crc32_combine(crc_a: number, crc_b: number, len_b: number): number;
+/** @internal */
+export function checksums_crc32c_combine(crc_a: number, crc_b: number, len_b: number): number;
+/** @internal */
+export type ChecksumCompleteCallback = (error_code: number, checksum?: number) => void;
+/** @internal */
+export function checksums_crc32_async(data: StringLike, previous: number | undefined, on_complete: ChecksumCompleteCallback): void;
+/** @internal */
+export function checksums_crc32c_async(data: StringLike, previous: number | undefined, on_complete: ChecksumCompleteCallback): void;
+/** @internal */
+export function checksums_crc32c_parts(parts: StringLike[]): { parts: number[], checksum: number };
 
 /* MQTT5 Client */
 
@@ -154,7 +286,7 @@ export function mqtt5_client_new(
     on_connection_success_handler: (client: Mqtt5Client, connack: mqtt5_packet.ConnackPacket, settings: NegotiatedSettings) => void,
     on_connection_failure_handler: (client: Mqtt5Client, errorCode: number, connack?: mqtt5_packet.ConnackPacket) => void,
     on_disconnection_handler: (client: Mqtt5Client, errorCode: number, disconnect?: mqtt5_packet.DisconnectPacket) => void,
-    on_message_received_handler: (client: Mqtt5Client, message: mqtt5_packet.PublishPacket) => void,
+    on_message_received_handler: (client: Mqtt5Client, messages: mqtt5_packet.PublishPacket[]) => void,
     client_bootstrap?: NativeHandle,
     socket_options?: NativeHandle,
     tls_ctx?: NativeHandle,
@@ -308,7 +440,7 @@ export function http_stream_new(
     request: HttpRequest,
     on_complete: (error_code: Number) => void,
     on_response: (status_code: Number, headers: HttpHeader[]) => void,
-    on_body: (data: ArrayBuffer) => void,
+    on_body: (chunks: ArrayBuffer[]) => void,
 ): NativeHandle;
 
 /** @internal */
@@ -515,6 +647,8 @@ export function event_stream_client_stream_send_message(
 ) : void;
 
 export const cRuntime: string;
+/** @internal Path the native addon was loaded from, so that worker threads can load it too */
+export const bindingPath: string;
 export const CRuntimeType: {
     NON_LINUX: string,
     MUSL: string,
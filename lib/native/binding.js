@@ -63,10 +63,12 @@ const search_paths = [
 ];
 
 let binding;
+let bindingPath;
 for (const p of search_paths) {
     const target = p + '.node';
     if (existsSync(target)) {
         binding = require(target);
+        bindingPath = target;
         break;
     }
 }
@@ -87,4 +89,4 @@ if (process.versions.hasOwnProperty('electron')) {
 
 
 export default binding;
-export { CRuntimeType, cRuntime };
+export { CRuntimeType, cRuntime, bindingPath };
@@ -81,4 +81,37 @@ test('crc32c_large_buffer', () => {
     const output = checksums.crc32c(arr);
     const expected = 0xfb5b991d
     expect(output).toEqual(expected);
-});
\ No newline at end of file
+});
+
+test('crc32_combine_matches_one_shot', () => {
+    const arr = Uint8Array.from(Array(1000).keys());
+    for (const split of [0, 1, 37, 500, 999, 1000]) {
+        const a = arr.subarray(0, split);
+        const b = arr.subarray(split);
+        expect(checksums.crc32_combine(checksums.crc32(a), checksums.crc32(b), b.length)).toEqual(checksums.crc32(arr));
+        expect(checksums.crc32c_combine(checksums.crc32c(a), checksums.crc32c(b), b.length))
+            .toEqual(checksums.crc32c(arr));
+    }
+});
+
+test('crc32_async_large_buffer', async () => {
+    const arr = new Uint8Array(25 * 2**20);
+    expect(await checksums.crc32_async(arr)).toEqual(0x72103906);
+    expect(await checksums.crc32c_async(arr)).toEqual(0xfb5b991d);
+});
+
+test('crc32_async_previous', async () => {
+    const arr = Uint8Array.from(Array(4 * 2**20).keys());
+    const previous = checksums.crc32c('previous');
+    expect(await checksums.crc32c_async(arr, previous)).toEqual(checksums.crc32c(arr, previous));
+    expect(await checksums.crc32_async('small', 5)).toEqual(checksums.crc32('small', 5));
+});
+
+test('crc32c_parts', () => {
+    const middle = Uint8Array.from(Array(3000).keys());
+    const parts = ['', 'part one', middle, Buffer.from('part three')];
+    const whole = Buffer.concat([Buffer.from('part one'), middle, Buffer.from('part three')]);
+    const result = checksums.crc32c_parts(parts);
+    expect(result.parts).toEqual(parts.map((part) => checksums.crc32c(part)));
+    expect(result.checksum).toEqual(checksums.crc32c(whole));
+});
@@ -14,7 +14,15 @@
 
  import crt_native from './binding';
  import { Hashable } from "../common/crypto";
+ import { hashable_async } from "./crypto";
 
+/**
+ * Inputs smaller than this many bytes are checksummed synchronously by the async functions, since handing them to
+ * other threads would cost more than checksumming them.
+ *
+ * @category Crypto
+ */
+export const ASYNC_CHECKSUM_THRESHOLD = 1024 * 1024;
 
 /**
  * Computes an crc32 checksum.
@@ -38,4 +46,92 @@ export function crc32(data: Hashable, previous?: number): number {
  */
  export function crc32c(data: Hashable, previous?: number): number {
     return crt_native.checksums_crc32c(data, previous);
-}
\ No newline at end of file
+}
+
+/**
+ * Computes the crc32 checksum of the concatenation of two inputs from their individual checksums, without the data.
+ *
+ * @param crc_a crc32 checksum of the first input
+ * @param crc_b crc32 checksum of the second input
+ * @param len_b length of the second input, in bytes
+ *
+ * @category Crypto
+ */
+export function crc32_combine(crc_a: number, crc_b: number, len_b: number): number {
+    return crt_native.checksums_crc32_combine(crc_a, crc_b, len_b);
+}
+
+/**
+ * Computes the crc32c checksum of the concatenation of two inputs from their individual checksums, without the data.
+ *
+ * @param crc_a crc32c checksum of the first input
+ * @param crc_b crc32c checksum of the second input
+ * @param len_b length of the second input, in bytes
+ *
+ * @category Crypto
+ */
+export function crc32c_combine(crc_a: number, crc_b: number, len_b: number): number {
+    return crt_native.checksums_crc32c_combine(crc_a, crc_b, len_b);
+}
+
+/**
+ * Computes a crc32 checksum without blocking the event loop. Inputs of at least {@link ASYNC_CHECKSUM_THRESHOLD} bytes
+ * are split across the libuv thread pool and the partial checksums combined; Buffers must not be modified until the
+ * returned promise settles.
+ *
+ * @param data The data to checksum
+ * @param previous previous crc32 checksum result. Used if you are buffering large input.
+ *
+ * @category Crypto
+ */
+export function crc32_async(data: Hashable, previous?: number): Promise<number> {
+    return hashable_async<number, number>(
+        data,
+        ASYNC_CHECKSUM_THRESHOLD,
+        () => crc32(data, previous),
+        (on_complete) => crt_native.checksums_crc32_async(data, previous, on_complete),
+        (checksum) => checksum as number);
+}
+
+/**
+ * Computes a crc32c checksum without blocking the event loop. Inputs of at least {@link ASYNC_CHECKSUM_THRESHOLD}
+ * bytes are split across the libuv thread pool and the partial checksums combined; Buffers must not be modified until
+ * the returned promise settles.
+ *
+ * @param data The data to checksum
+ * @param previous previous crc32c checksum result. Used if you are buffering large input.
+ *
+ * @category Crypto
+ */
+export function crc32c_async(data: Hashable, previous?: number): Promise<number> {
+    return hashable_async<number, number>(
+        data,
+        ASYNC_CHECKSUM_THRESHOLD,
+        () => crc32c(data, previous),
+        (on_complete) => crt_native.checksums_crc32c_async(data, previous, on_complete),
+        (checksum) => checksum as number);
+}
+
+/**
+ * Checksums of the parts of a multipart payload
+ *
+ * @category Crypto
+ */
+export interface ChecksumParts {
+    /** Checksum of each part, in order */
+    parts: number[];
+
+    /** Checksum of all of the parts concatenated */
+    checksum: number;
+}
+
+/**
+ * Computes the crc32c checksum of each part of a multipart payload, and of the whole payload, in a single call.
+ *
+ * @param parts The parts to checksum, in order
+ *
+ * @category Crypto
+ */
+export function crc32c_parts(parts: Hashable[]): ChecksumParts {
+    return crt_native.checksums_crc32c_parts(parts);
+}
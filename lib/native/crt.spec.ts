@@ -7,6 +7,7 @@
 // Make sure env "AWS_SDK_MEMORY_TRACING=2"
 
 import * as crt from './crt';
+import crt_native from './binding';
 
 test('Native Memory', () => {
     let tracingLevel = 0;
@@ -18,3 +19,33 @@ test('Native Memory', () => {
     }
 });
 
+
+test('Native Memory Pool Stays Bounded Across Threads', () => {
+    const before = crt.native_memory_pool_statistics();
+
+    /* allocated on a worker thread, freed on this one, with far more blocks per round than a cache may keep */
+    const first = crt_native.native_memory_pool_exercise(20, 2048);
+    expect(first.max_bytes_kept).toBeLessThanOrEqual(first.cache_limit_bytes);
+
+    /* the worker's cache was given up when it exited, and handed its blocks back */
+    const after = crt.native_memory_pool_statistics();
+    expect(after.bytes_reserved).toBeLessThanOrEqual(before.bytes_reserved);
+    expect(after.thread_count).toBe(before.thread_count);
+
+    /* the next worker adopts the orphaned cache instead of making another one */
+    const second = crt_native.native_memory_pool_exercise(20, 2048);
+    expect(second.max_bytes_kept).toBeLessThanOrEqual(second.cache_limit_bytes);
+    expect(second.cache_count).toBe(first.cache_count);
+    expect(crt.native_memory_pool_statistics().thread_count).toBe(before.thread_count);
+});
+
+test('Native Memory Breakdown', () => {
+    const breakdown = crt.native_memory_breakdown();
+    for (const tag of Object.keys(breakdown)) {
+        const usage = (breakdown as any)[tag];
+        expect(usage.bytes_active).toBeGreaterThanOrEqual(0);
+        expect(usage.bytes_peak).toBeGreaterThanOrEqual(usage.bytes_active);
+    }
+    /* the module's own bookkeeping and the logger are always allocated once loaded */
+    expect(breakdown.general.allocations_active).toBeGreaterThan(0);
+});
@@ -46,3 +46,72 @@ export function native_memory() {
 export function native_memory_dump() {
     return crt_native.native_memory_dump();
 }
+
+/**
+ * Native memory usage of a single subsystem.
+ *
+ * @category System
+ */
+export interface NativeMemoryUsage {
+    /** Bytes currently allocated */
+    bytes_active: number;
+    /** Number of allocations currently outstanding */
+    allocations_active: number;
+    /** Highest value bytes_active has reached */
+    bytes_peak: number;
+}
+
+/**
+ * Native memory usage broken down by the subsystem that allocated it.
+ *
+ * @category System
+ */
+export interface NativeMemoryBreakdown {
+    /** Memory not attributed to a specific subsystem, such as hashing and argument conversion */
+    general: NativeMemoryUsage;
+    mqtt5: NativeMemoryUsage;
+    mqtt3: NativeMemoryUsage;
+    http: NativeMemoryUsage;
+    event_stream: NativeMemoryUsage;
+    auth: NativeMemoryUsage;
+    io: NativeMemoryUsage;
+    logger: NativeMemoryUsage;
+}
+
+/**
+ * Returns native memory usage per subsystem. Unlike {@link native_memory}, this does not require
+ * ```AWS_CRT_MEMORY_TRACING``` to be set, and is cheap enough to poll periodically.
+ *
+ * @category System
+ */
+export function native_memory_breakdown(): NativeMemoryBreakdown {
+    return crt_native.native_memory_breakdown();
+}
+
+/**
+ * Counters for the pool used for the small structs that carry native events to node.
+ *
+ * @category System
+ */
+export interface NativeMemoryPoolStatistics {
+    /** Number of allocations served by reusing a block freed earlier */
+    reused_count: number;
+    /** Number of allocations that needed a new block from the general allocator */
+    new_count: number;
+    /** Number of allocations too large for the pool, which went straight to the general allocator */
+    oversized_count: number;
+    /** Bytes of pooled blocks currently allocated from the general allocator, whether in use or cached */
+    bytes_reserved: number;
+    /** Number of live threads that have allocated from the pool, each of which has its own cache */
+    thread_count: number;
+}
+
+/**
+ * Returns reuse counters and usage of the native small object pool. Unlike {@link native_memory}, this does not
+ * require ```AWS_CRT_MEMORY_TRACING``` to be set.
+ *
+ * @category System
+ */
+export function native_memory_pool_statistics(): NativeMemoryPoolStatistics {
+    return crt_native.native_memory_pool_statistics();
+}
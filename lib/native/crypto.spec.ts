@@ -95,3 +95,90 @@ test('hmac-256 one-shot matches', () => {
 
     expect(native_hash).toEqual(browser_hash);
 });
+
+test('SHA256 one-shot matches for strings around the small string size', () => {
+    /* ascii and multi-byte strings that land on either side of the native stack buffer */
+    for (const unit of ['a', 'é', '€', '😀']) {
+        for (let count = 1; count < 270; ++count) {
+            const data = unit.repeat(count);
+            if (Buffer.byteLength(data) >= 240) {
+                expect(native.hash_sha256(data)).toEqual(browser.hash_sha256(data));
+            }
+        }
+    }
+});
+
+test('Async hashes match their synchronous versions', async () => {
+    const large = Buffer.alloc(native.ASYNC_HASH_THRESHOLD * 4, 'x');
+    const small = 'ABC123XYZ';
+    for (const data of [large, small]) {
+        expect(new Uint8Array((await native.hash_md5_async(data)).buffer))
+            .toEqual(new Uint8Array(native.hash_md5(data).buffer));
+        expect(new Uint8Array((await native.hash_sha1_async(data)).buffer))
+            .toEqual(new Uint8Array(native.hash_sha1(data).buffer));
+        expect(new Uint8Array((await native.hash_sha256_async(data, 16)).buffer))
+            .toEqual(new Uint8Array(native.hash_sha256(data, 16).buffer));
+        expect(new Uint8Array((await native.hmac_sha256_async('TEST', data)).buffer))
+            .toEqual(new Uint8Array(native.hmac_sha256('TEST', data).buffer));
+    }
+    expect((await native.hash_sha256_async(large)).byteLength).toBe(32);
+});
+
+test('Async updates are applied in order', async () => {
+    const parts = [Buffer.alloc(native.ASYNC_HASH_THRESHOLD, 'a'), 'small', Buffer.alloc(native.ASYNC_HASH_THRESHOLD, 'b')];
+    const sync_sha = new native.Sha256Hash();
+    const async_sha = new native.Sha256Hash();
+    parts.forEach(part => sync_sha.update(part));
+    const updates = parts.map(part => async_sha.update_async(part));
+    expect(() => async_sha.finalize()).toThrow();
+    await Promise.all(updates);
+
+    expect(new Uint8Array(async_sha.finalize().buffer)).toEqual(new Uint8Array(sync_sha.finalize().buffer));
+});
+
+test('SHA256 of many inputs matches individual hashes', () => {
+    const parts = ['', 'ABC123XYZ', Buffer.alloc(1000, 'z'), new ArrayBuffer(7)];
+    const expected = Buffer.concat(parts.map(part => Buffer.from(native.hash_sha256(part).buffer)));
+
+    const digests = native.hash_sha256_many(parts);
+    expect(Buffer.from(digests.buffer, digests.byteOffset, digests.byteLength)).toEqual(expected);
+
+    const out = Buffer.alloc(parts.length * 32 + 8);
+    expect(native.hash_sha256_many(parts, out)).toBe(out);
+    expect(out.subarray(0, parts.length * 32)).toEqual(expected);
+
+    expect(() => native.hash_sha256_many(parts, Buffer.alloc(32))).toThrow();
+    for (const invalid of [5, true, Symbol('out')]) {
+        expect(() => native.hash_sha256_many(parts, invalid as any)).toThrow(TypeError);
+    }
+});
+
+test('Digests can be written into buffers or returned encoded', () => {
+    const data = 'ABC123XYZ';
+    const expected = Buffer.from(native.hash_sha256(data).buffer);
+
+    const out = Buffer.alloc(40, 0xff);
+    expect(native.hash_sha256_into(data, out, 4)).toBe(32);
+    expect(out.subarray(4, 36)).toEqual(expected);
+    expect(out[3]).toBe(0xff);
+    expect(out[36]).toBe(0xff);
+    expect(() => native.hash_sha256_into(data, out, 10)).toThrow();
+
+    /* invalid output types must throw rather than crash, for every function sharing the output parsing */
+    for (const invalid of [1, false, Symbol('output')]) {
+        expect(() => native.hash_sha256_into(data, invalid as any)).toThrow(TypeError);
+        expect(() => native.hash_md5_into(data, invalid as any)).toThrow(TypeError);
+        expect(() => native.hmac_sha256_into('key', data, invalid as any)).toThrow(TypeError);
+        expect(() => new native.Sha1Hash().finalize_into(invalid as any)).toThrow(TypeError);
+    }
+
+    expect(native.hash_sha256_encoded(data, 'hex')).toBe(expected.toString('hex'));
+    expect(native.hash_sha256_encoded(data, 'base64')).toBe(expected.toString('base64'));
+    expect(native.hash_md5_encoded(data, 'hex')).toBe(Buffer.from(native.hash_md5(data).buffer).toString('hex'));
+    expect(native.hmac_sha256_encoded('TEST', data, 'hex'))
+        .toBe(Buffer.from(native.hmac_sha256('TEST', data).buffer).toString('hex'));
+
+    const sha = new native.Sha1Hash();
+    sha.update(data);
+    expect(sha.finalize_encoded('hex')).toBe(Buffer.from(native.hash_sha1(data).buffer).toString('hex'));
+});
@@ -13,33 +13,147 @@
 
 import crt_native from './binding';
 import { NativeResource } from "./native_resource";
+import { CrtError } from "./error";
 import { Hashable } from "../common/crypto";
 
 export { Hashable } from "../common/crypto";
 
+/**
+ * Text encodings that digests can be returned in directly, without creating an intermediate buffer
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export type DigestEncoding = 'hex' | 'base64';
+
+/**
+ * Inputs smaller than this many bytes are hashed synchronously by the async functions, since handing them to another
+ * thread would cost more than hashing them.
+ *
+ * @category Crypto
+ */
+export const ASYNC_HASH_THRESHOLD = 64 * 1024;
+
+function hashable_length(data: Hashable): number {
+    return (typeof data === 'string') ? Buffer.byteLength(data) : data.byteLength;
+}
+
+/**
+ * Runs sync() if data is smaller than threshold bytes, otherwise starts the native work and settles with result() of
+ * the value it calls back with. Shared by the async hash and checksum functions.
+ * @internal
+ */
+export function hashable_async<T, R>(
+    data: Hashable,
+    threshold: number,
+    sync: () => T,
+    start: (on_complete: (error_code: number, value?: R) => void) => void,
+    result: (value?: R) => T): Promise<T> {
+
+    if (hashable_length(data) < threshold) {
+        try {
+            return Promise.resolve(sync());
+        } catch (err) {
+            return Promise.reject(err);
+        }
+    }
+
+    return new Promise<T>((resolve, reject) => {
+        start((error_code: number, value?: R) => {
+            if (error_code != 0) {
+                reject(new CrtError(error_code));
+            } else {
+                resolve(result(value));
+            }
+        });
+    });
+}
+
 /**
  * Object that allows for continuous hashing of data.
  *
  * @internal
  */
 abstract class Hash extends NativeResource {
+    private pending = Promise.resolve();
+    private pending_count = 0;
+
     /**
      * Hash additional data.
      * @param data Additional data to hash
      */
     update(data: Hashable) {
+        this.ensure_idle();
         crt_native.hash_update(this.native_handle(), data);
     }
 
+    /**
+     * Hash additional data without blocking the event loop. Inputs of at least {@link ASYNC_HASH_THRESHOLD} bytes are
+     * hashed on a background thread. Calls are applied in order; other methods may not be used until all of them
+     * have settled. Buffers must not be modified until the returned promise settles.
+     *
+     * @param data Additional data to hash
+     */
+    update_async(data: Hashable): Promise<void> {
+        const run = () => hashable_async<void, DataView>(
+            data,
+            ASYNC_HASH_THRESHOLD,
+            () => crt_native.hash_update(this.native_handle(), data),
+            (on_complete) => crt_native.hash_update_async(this.native_handle(), data, on_complete),
+            () => undefined);
+
+        /* settle is chained before the caller can chain anything, so the hash is idle again by the time they resume */
+        const settle = () => { this.pending_count--; };
+        this.pending_count++;
+        const result = this.pending.then(run);
+        this.pending = result.then(settle, settle);
+        return result;
+    }
+
     /**
      * Completes the hash computation and returns the final hash digest.
      *
      * @param truncate_to The maximum number of bytes to receive. Leave as undefined or 0 to receive the entire digest.
      */
     finalize(truncate_to?: number): DataView {
+        this.ensure_idle();
         return crt_native.hash_digest(this.native_handle(), truncate_to);
     }
 
+    /**
+     * Completes the hash computation and writes the digest into a caller supplied buffer.
+     *
+     * @param out The buffer to write the digest into
+     * @param offset The byte offset in out to start writing at. Defaults to 0.
+     * @param truncate_to The maximum number of bytes to write. Leave as undefined or 0 to write the entire digest.
+     * @returns The number of bytes written
+     *
+     * nodejs only.
+     */
+    finalize_into(out: ArrayBuffer | ArrayBufferView, offset?: number, truncate_to?: number): number {
+        this.ensure_idle();
+        return crt_native.hash_digest(this.native_handle(), truncate_to, out, offset) as number;
+    }
+
+    /**
+     * Completes the hash computation and returns the digest as an encoded string.
+     *
+     * @param encoding The encoding to return the digest in
+     * @param truncate_to The maximum number of bytes to encode. Leave as undefined or 0 to encode the entire digest.
+     *
+     * nodejs only.
+     */
+    finalize_encoded(encoding: DigestEncoding, truncate_to?: number): string {
+        this.ensure_idle();
+        return crt_native.hash_digest(this.native_handle(), truncate_to, encoding) as string;
+    }
+
+    private ensure_idle() {
+        if (this.pending_count > 0) {
+            throw new CrtError("Hash cannot be used while update_async() calls are pending");
+        }
+    }
+
     constructor(hash_handle: any) {
         super(hash_handle);
     }
@@ -69,6 +183,58 @@ export function hash_md5(data: Hashable, truncate_to?: number): DataView {
     return crt_native.hash_md5_compute(data, truncate_to);
 }
 
+/**
+ * Computes an MD5 hash and writes the digest into a caller supplied buffer.
+ *
+ * @param data The data to hash
+ * @param out The buffer to write the digest into
+ * @param offset The byte offset in out to start writing at. Defaults to 0.
+ * @param truncate_to The maximum number of bytes to write. Leave as undefined or 0 to write the entire digest.
+ * @returns The number of bytes written
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hash_md5_into(
+    data: Hashable,
+    out: ArrayBuffer | ArrayBufferView,
+    offset?: number,
+    truncate_to?: number): number {
+    return crt_native.hash_md5_compute(data, truncate_to, out, offset) as number;
+}
+
+/**
+ * Computes an MD5 hash and returns the digest as an encoded string.
+ *
+ * @param data The data to hash
+ * @param encoding The encoding to return the digest in
+ * @param truncate_to The maximum number of bytes to encode. Leave as undefined or 0 to encode the entire digest.
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hash_md5_encoded(data: Hashable, encoding: DigestEncoding, truncate_to?: number): string {
+    return crt_native.hash_md5_compute(data, truncate_to, encoding) as string;
+}
+
+/**
+ * Computes an MD5 hash without blocking the event loop. Inputs of at least {@link ASYNC_HASH_THRESHOLD} bytes are
+ * hashed on a background thread; Buffers must not be modified until the returned promise settles.
+ *
+ * @param data The data to hash
+ * @param truncate_to The maximum number of bytes to receive. Leave as undefined or 0 to receive the entire digest.
+ *
+ * @category Crypto
+ */
+export function hash_md5_async(data: Hashable, truncate_to?: number): Promise<DataView> {
+    return hashable_async<DataView, DataView>(
+        data,
+        ASYNC_HASH_THRESHOLD,
+        () => hash_md5(data, truncate_to),
+        (on_complete) => crt_native.hash_md5_compute_async(data, truncate_to, on_complete),
+        (digest) => digest as DataView);
+}
+
 /**
  * Object that allows for continuous SHA256 hashing of data.
  *
@@ -94,6 +260,75 @@ export function hash_sha256(data: Hashable, truncate_to?: number): DataView {
     return crt_native.hash_sha256_compute(data, truncate_to);
 }
 
+/**
+ * Computes an SHA256 hash and writes the digest into a caller supplied buffer.
+ *
+ * @param data The data to hash
+ * @param out The buffer to write the digest into
+ * @param offset The byte offset in out to start writing at. Defaults to 0.
+ * @param truncate_to The maximum number of bytes to write. Leave as undefined or 0 to write the entire digest.
+ * @returns The number of bytes written
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hash_sha256_into(
+    data: Hashable,
+    out: ArrayBuffer | ArrayBufferView,
+    offset?: number,
+    truncate_to?: number): number {
+    return crt_native.hash_sha256_compute(data, truncate_to, out, offset) as number;
+}
+
+/**
+ * Computes an SHA256 hash and returns the digest as an encoded string.
+ *
+ * @param data The data to hash
+ * @param encoding The encoding to return the digest in
+ * @param truncate_to The maximum number of bytes to encode. Leave as undefined or 0 to encode the entire digest.
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hash_sha256_encoded(data: Hashable, encoding: DigestEncoding, truncate_to?: number): string {
+    return crt_native.hash_sha256_compute(data, truncate_to, encoding) as string;
+}
+
+/**
+ * Computes an SHA256 hash without blocking the event loop. Inputs of at least {@link ASYNC_HASH_THRESHOLD} bytes are
+ * hashed on a background thread; Buffers must not be modified until the returned promise settles.
+ *
+ * @param data The data to hash
+ * @param truncate_to The maximum number of bytes to receive. Leave as undefined or 0 to receive the entire digest.
+ *
+ * @category Crypto
+ */
+export function hash_sha256_async(data: Hashable, truncate_to?: number): Promise<DataView> {
+    return hashable_async<DataView, DataView>(
+        data,
+        ASYNC_HASH_THRESHOLD,
+        () => hash_sha256(data, truncate_to),
+        (on_complete) => crt_native.hash_sha256_compute_async(data, truncate_to, on_complete),
+        (digest) => digest as DataView);
+}
+
+/**
+ * Computes the SHA256 hash of each of many inputs in a single native call. The 32 byte digests are written back to back,
+ * in input order, into one buffer, avoiding the per-call overhead and per-digest allocations of {@link hash_sha256}.
+ *
+ * @param data The inputs to hash
+ * @param out Optional buffer to write the digests into, which must be at least `32 * data.length` bytes. If not
+ *            provided, a new one is allocated.
+ * @returns out, or the newly allocated buffer
+ *
+ * @category Crypto
+ */
+export function hash_sha256_many(data: Hashable[]): DataView;
+export function hash_sha256_many<T extends ArrayBuffer | ArrayBufferView>(data: Hashable[], out: T): T;
+export function hash_sha256_many(data: Hashable[], out?: ArrayBuffer | ArrayBufferView): ArrayBuffer | ArrayBufferView {
+    return crt_native.hash_sha256_many(data, out);
+}
+
 /**
  * Object that allows for continuous SHA1 hashing of data.
  *
@@ -119,30 +354,144 @@ export function hash_sha1(data: Hashable, truncate_to?: number): DataView {
     return crt_native.hash_sha1_compute(data, truncate_to);
 }
 
+/**
+ * Computes an SHA1 hash and writes the digest into a caller supplied buffer.
+ *
+ * @param data The data to hash
+ * @param out The buffer to write the digest into
+ * @param offset The byte offset in out to start writing at. Defaults to 0.
+ * @param truncate_to The maximum number of bytes to write. Leave as undefined or 0 to write the entire digest.
+ * @returns The number of bytes written
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hash_sha1_into(
+    data: Hashable,
+    out: ArrayBuffer | ArrayBufferView,
+    offset?: number,
+    truncate_to?: number): number {
+    return crt_native.hash_sha1_compute(data, truncate_to, out, offset) as number;
+}
+
+/**
+ * Computes an SHA1 hash and returns the digest as an encoded string.
+ *
+ * @param data The data to hash
+ * @param encoding The encoding to return the digest in
+ * @param truncate_to The maximum number of bytes to encode. Leave as undefined or 0 to encode the entire digest.
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hash_sha1_encoded(data: Hashable, encoding: DigestEncoding, truncate_to?: number): string {
+    return crt_native.hash_sha1_compute(data, truncate_to, encoding) as string;
+}
+
+/**
+ * Computes an SHA1 hash without blocking the event loop. Inputs of at least {@link ASYNC_HASH_THRESHOLD} bytes are
+ * hashed on a background thread; Buffers must not be modified until the returned promise settles.
+ *
+ * @param data The data to hash
+ * @param truncate_to The maximum number of bytes to receive. Leave as undefined or 0 to receive the entire digest.
+ *
+ * @category Crypto
+ */
+export function hash_sha1_async(data: Hashable, truncate_to?: number): Promise<DataView> {
+    return hashable_async<DataView, DataView>(
+        data,
+        ASYNC_HASH_THRESHOLD,
+        () => hash_sha1(data, truncate_to),
+        (on_complete) => crt_native.hash_sha1_compute_async(data, truncate_to, on_complete),
+        (digest) => digest as DataView);
+}
+
 /**
  * Object that allows for continuous hashing of data with an hmac secret.
  *
  * @category Crypto
  */
 abstract class Hmac extends NativeResource {
+    private pending = Promise.resolve();
+    private pending_count = 0;
+
     /**
      * Hash additional data.
      *
      * @param data additional data to hash
      */
     update(data: Hashable) {
+        this.ensure_idle();
         crt_native.hmac_update(this.native_handle(), data);
     }
 
+    /**
+     * Hash additional data without blocking the event loop. Inputs of at least {@link ASYNC_HASH_THRESHOLD} bytes are
+     * hashed on a background thread. Calls are applied in order; other methods may not be used until all of them
+     * have settled. Buffers must not be modified until the returned promise settles.
+     *
+     * @param data additional data to hash
+     */
+    update_async(data: Hashable): Promise<void> {
+        const run = () => hashable_async<void, DataView>(
+            data,
+            ASYNC_HASH_THRESHOLD,
+            () => crt_native.hmac_update(this.native_handle(), data),
+            (on_complete) => crt_native.hmac_update_async(this.native_handle(), data, on_complete),
+            () => undefined);
+
+        /* settle is chained before the caller can chain anything, so the hash is idle again by the time they resume */
+        const settle = () => { this.pending_count--; };
+        this.pending_count++;
+        const result = this.pending.then(run);
+        this.pending = result.then(settle, settle);
+        return result;
+    }
+
     /**
      * Completes the hash computation and returns the final hmac digest.
      *
      * @param truncate_to The maximum number of bytes to receive. Leave as undefined or 0 to receive the entire digest.
      */
     finalize(truncate_to?: number): DataView {
+        this.ensure_idle();
         return crt_native.hmac_digest(this.native_handle(), truncate_to);
     }
 
+    /**
+     * Completes the hmac computation and writes the digest into a caller supplied buffer.
+     *
+     * @param out The buffer to write the digest into
+     * @param offset The byte offset in out to start writing at. Defaults to 0.
+     * @param truncate_to The maximum number of bytes to write. Leave as undefined or 0 to write the entire digest.
+     * @returns The number of bytes written
+     *
+     * nodejs only.
+     */
+    finalize_into(out: ArrayBuffer | ArrayBufferView, offset?: number, truncate_to?: number): number {
+        this.ensure_idle();
+        return crt_native.hmac_digest(this.native_handle(), truncate_to, out, offset) as number;
+    }
+
+    /**
+     * Completes the hmac computation and returns the digest as an encoded string.
+     *
+     * @param encoding The encoding to return the digest in
+     * @param truncate_to The maximum number of bytes to encode. Leave as undefined or 0 to encode the entire digest.
+     *
+     * nodejs only.
+     */
+    finalize_encoded(encoding: DigestEncoding, truncate_to?: number): string {
+        this.ensure_idle();
+        return crt_native.hmac_digest(this.native_handle(), truncate_to, encoding) as string;
+    }
+
+    private ensure_idle() {
+        if (this.pending_count > 0) {
+            throw new CrtError("Hmac cannot be used while update_async() calls are pending");
+        }
+    }
+
     constructor(hash_handle: any) {
         super(hash_handle);
     }
@@ -172,3 +521,63 @@ export class Sha256Hmac extends Hmac {
 export function hmac_sha256(secret: Hashable, data: Hashable, truncate_to?: number): DataView {
     return crt_native.hmac_sha256_compute(secret, data, truncate_to);
 }
+
+/**
+ * Computes an SHA256 HMAC and writes the digest into a caller supplied buffer.
+ *
+ * @param secret The key to use for the HMAC process
+ * @param data The data to hash
+ * @param out The buffer to write the digest into
+ * @param offset The byte offset in out to start writing at. Defaults to 0.
+ * @param truncate_to The maximum number of bytes to write. Leave as undefined or 0 to write the entire digest.
+ * @returns The number of bytes written
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hmac_sha256_into(
+    secret: Hashable,
+    data: Hashable,
+    out: ArrayBuffer | ArrayBufferView,
+    offset?: number,
+    truncate_to?: number): number {
+    return crt_native.hmac_sha256_compute(secret, data, truncate_to, out, offset) as number;
+}
+
+/**
+ * Computes an SHA256 HMAC and returns the digest as an encoded string.
+ *
+ * @param secret The key to use for the HMAC process
+ * @param data The data to hash
+ * @param encoding The encoding to return the digest in
+ * @param truncate_to The maximum number of bytes to encode. Leave as undefined or 0 to encode the entire digest.
+ *
+ * nodejs only.
+ * @category Crypto
+ */
+export function hmac_sha256_encoded(
+    secret: Hashable,
+    data: Hashable,
+    encoding: DigestEncoding,
+    truncate_to?: number): string {
+    return crt_native.hmac_sha256_compute(secret, data, truncate_to, encoding) as string;
+}
+
+/**
+ * Computes an SHA256 HMAC without blocking the event loop. Inputs of at least {@link ASYNC_HASH_THRESHOLD} bytes are
+ * hashed on a background thread; Buffers must not be modified until the returned promise settles.
+ *
+ * @param secret The key to use for the HMAC process
+ * @param data The data to hash
+ * @param truncate_to The maximum number of bytes to receive. Leave as undefined or 0 to receive the entire digest.
+ *
+ * @category Crypto
+ */
+export function hmac_sha256_async(secret: Hashable, data: Hashable, truncate_to?: number): Promise<DataView> {
+    return hashable_async<DataView, DataView>(
+        data,
+        ASYNC_HASH_THRESHOLD,
+        () => hmac_sha256(secret, data, truncate_to),
+        (on_complete) => crt_native.hmac_sha256_compute_async(secret, data, truncate_to, on_complete),
+        (digest) => digest as DataView);
+}
@@ -270,8 +270,11 @@ export class HttpClientConnection extends HttpConnection {
             stream._on_response(status_code, headers);
         }
 
-        const on_body_impl = (data: ArrayBuffer) => {
-            stream._on_body(data);
+        const on_body_impl = (chunks: ArrayBuffer[]) => {
+            /* chunks that arrive while node is busy are delivered together */
+            for (const data of chunks) {
+                stream._on_body(data);
+            }
         }
 
         const on_complete_impl = (error_code: Number) => {
@@ -4,9 +4,15 @@
  */
 
 import * as io from './io';
+import * as crt from './crt';
 import { Pkcs11Lib } from './io';
 import { CrtError } from './error';
-import {cRuntime, CRuntimeType} from "./binding";
+import crt_native, {cRuntime, CRuntimeType} from "./binding";
+import * as test_env from "@test/test_env";
+import { Readable } from "stream";
+import * as fs from "fs";
+import * as os from "os";
+import * as path from "path";
 
 const conditional_test = (condition: any) => condition ? it : it.skip;
 
@@ -41,3 +47,371 @@ pkcs11_test('Pkcs11Lib exception', () => {
     }).toThrow(/AWS_IO_SHARED_LIBRARY_LOAD_FAILURE/);
 });
 
+
+test('ClientBootstrap with its own event loop group', () => {
+    const bootstrap = new io.ClientBootstrap({ event_loop_thread_count: 2 });
+    expect(bootstrap.native_handle()).toBeDefined();
+});
+
+test('Default event loop thread count cannot change once the default group exists', () => {
+    // creating a default bootstrap forces the default event loop group into existence
+    new io.ClientBootstrap();
+    expect(() => {
+        io.set_default_event_loop_thread_count(4);
+    }).toThrow();
+});
+
+test('InputStream pauses its source once the native buffer is full', async () => {
+    const chunk = Buffer.alloc(64 * 1024, 'a');
+    let pushed = 0;
+    const source = new Readable({
+        read() {
+            if (pushed < 4 * io.InputStream.HIGH_WATERMARK) {
+                pushed += chunk.length;
+                this.push(chunk);
+            } else {
+                this.push(null);
+            }
+        }
+    });
+
+    new io.InputStream(source);
+
+    /* nothing reads from the native stream, so the source should stop soon after the high watermark */
+    await new Promise((resolve) => setTimeout(resolve, 100));
+    expect(source.isPaused()).toBe(true);
+    expect(pushed).toBeLessThan(2 * io.InputStream.HIGH_WATERMARK);
+});
+
+test('InputStream from a file knows its length', () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'crt-input-stream-'));
+    const file = path.join(dir, 'body.bin');
+    fs.writeFileSync(file, Buffer.alloc(10000, 'b'));
+    try {
+        expect(io.InputStream.fromFile(file).length).toBe(10000);
+        expect(io.InputStream.fromFile(file, { offset: 1000 }).length).toBe(9000);
+        expect(io.InputStream.fromFile(file, { offset: 1000, length: 500 }).length).toBe(500);
+        expect(io.InputStream.fromFile(file, { offset: 1000, length: 500, mmap: true }).length).toBe(500);
+        expect(() => {
+            io.InputStream.fromFile(file, { offset: 9000, length: 2000 });
+        }).toThrow();
+    } finally {
+        fs.unlinkSync(file);
+        fs.rmdirSync(dir);
+    }
+});
+
+/* deterministic bytes for stream offsets [offset, offset + length) */
+function stream_bytes(offset: number, length: number): Buffer {
+    const bytes = Buffer.alloc(length);
+    for (let i = 0; i < length; ++i) {
+        bytes[i] = (offset + i) % 251;
+    }
+    return bytes;
+}
+
+/* reads from a native stream, read_size bytes at a time, until it has nothing more to give right now */
+function read_available(stream: any, read_size: number): Buffer {
+    const reads: Buffer[] = [];
+    const dest = Buffer.alloc(read_size);
+    let length = 0;
+    while ((length = crt_native.io_input_stream_read(stream, dest)) > 0) {
+        reads.push(Buffer.from(dest.subarray(0, length)));
+    }
+    return Buffer.concat(reads);
+}
+
+test('InputStream takes an append larger than its chunk size in one piece', () => {
+    const stream = crt_native.io_input_stream_new(16);
+    crt_native.io_input_stream_append(stream, stream_bytes(0, 1000));
+    expect(read_available(stream, 4096)).toEqual(stream_bytes(0, 1000));
+});
+
+test('InputStream packs small appends into the tail chunk', () => {
+    const stream = crt_native.io_input_stream_new(1024);
+    const allocations_before = crt.native_memory_breakdown().io.allocations_active;
+    for (let offset = 0; offset < 1000; offset += 10) {
+        crt_native.io_input_stream_append(stream, stream_bytes(offset, 10));
+    }
+
+    /* a hundred appends fit in a single 1KB chunk */
+    expect(crt.native_memory_breakdown().io.allocations_active - allocations_before).toBeLessThanOrEqual(1);
+    expect(read_available(stream, 4096)).toEqual(stream_bytes(0, 1000));
+});
+
+test('InputStream reads span chunks', () => {
+    const stream = crt_native.io_input_stream_new(16);
+    let appended = 0;
+    for (const length of [10, 10, 10, 40, 3, 100, 7]) {
+        crt_native.io_input_stream_append(stream, stream_bytes(appended, length));
+        appended += length;
+    }
+
+    /* an odd read size, so that most reads start in one chunk and end in another */
+    expect(read_available(stream, 37)).toEqual(stream_bytes(0, appended));
+});
+
+test('InputStream reports end of stream only once buffered data is read', () => {
+    const stream = crt_native.io_input_stream_new(16);
+    crt_native.io_input_stream_append(stream, stream_bytes(0, 40));
+    crt_native.io_input_stream_append(stream, undefined);
+    expect(crt_native.io_input_stream_is_end_of_stream(stream)).toBe(false);
+
+    const dest = Buffer.alloc(25);
+    expect(crt_native.io_input_stream_read(stream, dest)).toBe(25);
+    expect(crt_native.io_input_stream_is_end_of_stream(stream)).toBe(false);
+    expect(crt_native.io_input_stream_read(stream, dest)).toBe(15);
+    expect(crt_native.io_input_stream_is_end_of_stream(stream)).toBe(true);
+    expect(crt_native.io_input_stream_read(stream, dest)).toBe(0);
+});
+
+/* 200 bytes in 16 byte chunks, with the first 150 read and a replay window of 100 */
+function partly_read_stream(): any {
+    const stream = crt_native.io_input_stream_new(16, 0, 0, undefined, 100);
+    for (let offset = 0; offset < 200; offset += 10) {
+        crt_native.io_input_stream_append(stream, stream_bytes(offset, 10));
+    }
+    expect(crt_native.io_input_stream_read(stream, Buffer.alloc(150))).toBe(150);
+    return stream;
+}
+
+test('InputStream seeks back anywhere inside its replay window', () => {
+    /* every position from the start of the window to the read position, most of them inside a chunk */
+    for (let position = 50; position <= 150; ++position) {
+        const stream = partly_read_stream();
+        crt_native.io_input_stream_seek(stream, position, false);
+        expect(read_available(stream, 7)).toEqual(stream_bytes(position, 200 - position));
+    }
+
+    /* relative to the end, and back and forth within the window */
+    const stream = partly_read_stream();
+    crt_native.io_input_stream_seek(stream, -130, true);
+    expect(read_available(stream, 33)).toEqual(stream_bytes(70, 130));
+    crt_native.io_input_stream_seek(stream, 120, false);
+    crt_native.io_input_stream_seek(stream, 101, false);
+    expect(read_available(stream, 64)).toEqual(stream_bytes(101, 99));
+});
+
+test('InputStream cannot seek before its replay window or past its data', () => {
+    const stream = partly_read_stream();
+    expect(() => crt_native.io_input_stream_seek(stream, 40, false)).toThrow();
+    expect(() => crt_native.io_input_stream_seek(stream, 0, false)).toThrow();
+    expect(() => crt_native.io_input_stream_seek(stream, -1, false)).toThrow();
+    expect(() => crt_native.io_input_stream_seek(stream, 201, false)).toThrow();
+    expect(() => crt_native.io_input_stream_seek(stream, 1, true)).toThrow();
+
+    /* a failed seek leaves the read position where it was */
+    expect(read_available(stream, 64)).toEqual(stream_bytes(150, 50));
+});
+
+test('InputStream with an unlimited replay window seeks anywhere after end of stream', async () => {
+    const body = stream_bytes(0, 100 * 1024);
+    const source = Readable.from([body.subarray(0, 30000), body.subarray(30000, 70000), body.subarray(70000)]);
+    const stream = new io.InputStream(source, { replay_window: Infinity });
+    await new Promise((resolve) => source.on('end', resolve));
+
+    const handle = stream.native_handle();
+    expect(read_available(handle, 16 * 1024)).toEqual(body);
+    expect(crt_native.io_input_stream_is_end_of_stream(handle)).toBe(true);
+
+    crt_native.io_input_stream_seek(handle, 0, false);
+    expect(crt_native.io_input_stream_is_end_of_stream(handle)).toBe(false);
+    expect(read_available(handle, 5000)).toEqual(body);
+
+    crt_native.io_input_stream_seek(handle, -10, true);
+    expect(read_available(handle, 64)).toEqual(body.subarray(body.length - 10));
+    crt_native.io_input_stream_seek(handle, 0, true);
+    expect(crt_native.io_input_stream_is_end_of_stream(handle)).toBe(true);
+    expect(stream.length).toBe(body.length);
+});
+
+test('InputStream reads the same bytes again after each rewind', () => {
+    const stream = crt_native.io_input_stream_new(16, 0, 0, undefined, 64);
+    crt_native.io_input_stream_append(stream, stream_bytes(0, 100));
+    crt_native.io_input_stream_append(stream, undefined);
+
+    /* as a signer or a retry would: read part of the body, then go back to the start */
+    const dest = Buffer.alloc(40);
+    for (let attempt = 0; attempt < 3; ++attempt) {
+        expect(crt_native.io_input_stream_read(stream, dest)).toBe(40);
+        expect(dest).toEqual(stream_bytes(0, 40));
+        crt_native.io_input_stream_seek(stream, 0, false);
+    }
+    expect(read_available(stream, 64)).toEqual(stream_bytes(0, 100));
+});
+
+test('ClientTlsContext shares one native context between identical options', () => {
+    const cache_options = (alpn: string) => {
+        const options = new io.TlsContextOptions();
+        /* unique to this test, so that contexts created elsewhere in the process can't share the entries */
+        options.alpn_list = [alpn];
+        options.use_context_cache = true;
+        return options;
+    };
+
+    const before = crt_native.io_tls_ctx_cache_statistics();
+
+    const contexts = [];
+    for (let i = 0; i < 8; ++i) {
+        contexts.push(new io.ClientTlsContext(cache_options('io-spec-cache-a')));
+    }
+    let stats = crt_native.io_tls_ctx_cache_statistics();
+    expect(stats.entry_count).toBe(before.entry_count + 1);
+    expect(stats.external_count).toBe(before.external_count + 8);
+
+    /* different options get a context of their own */
+    contexts.push(new io.ClientTlsContext(cache_options('io-spec-cache-b')));
+    stats = crt_native.io_tls_ctx_cache_statistics();
+    expect(stats.entry_count).toBe(before.entry_count + 2);
+    expect(stats.external_count).toBe(before.external_count + 9);
+
+    /* and so do contexts that didn't ask for the cache */
+    const uncached = new io.TlsContextOptions();
+    uncached.alpn_list = ['io-spec-cache-a'];
+    contexts.push(new io.ClientTlsContext(uncached));
+    stats = crt_native.io_tls_ctx_cache_statistics();
+    expect(stats.entry_count).toBe(before.entry_count + 2);
+    expect(stats.external_count).toBe(before.external_count + 9);
+
+    for (const context of contexts) {
+        expect(context.native_handle()).toBeDefined();
+    }
+});
+
+const pkcs11_tls_test =
+    conditional_test(cRuntime !== CRuntimeType.MUSL && test_env.AWS_IOT_ENV.mqtt311_is_valid_pkcs11());
+
+pkcs11_tls_test('ClientTlsContext with PKCS#11 options bypasses the context cache', () => {
+    const pkcs11_lib = new Pkcs11Lib(test_env.AWS_IOT_ENV.MQTT311_PKCS11_LIB_PATH);
+    const options = io.TlsContextOptions.create_client_with_mtls_pkcs11({
+        pkcs11_lib: pkcs11_lib,
+        user_pin: test_env.AWS_IOT_ENV.MQTT311_PKCS11_PIN,
+        token_label: test_env.AWS_IOT_ENV.MQTT311_PKCS11_TOKEN_LABEL,
+        private_key_object_label: test_env.AWS_IOT_ENV.MQTT311_PKCS11_PRIVATE_KEY_LABEL,
+        cert_file_path: test_env.AWS_IOT_ENV.MQTT311_PKCS11_CERT,
+    });
+    options.use_context_cache = true;
+
+    const before = crt_native.io_tls_ctx_cache_statistics();
+    const contexts = [new io.ClientTlsContext(options), new io.ClientTlsContext(options)];
+    const after = crt_native.io_tls_ctx_cache_statistics();
+
+    expect(after.entry_count).toBe(before.entry_count);
+    expect(after.external_count).toBe(before.external_count);
+    for (const context of contexts) {
+        expect(context.native_handle()).toBeDefined();
+    }
+});
+
+test('HostResolver resolves localhost', async () => {
+    const resolver = new io.HostResolver({ max_entries: 16, max_ttl_secs: 10 });
+    const addresses = await resolver.resolve('localhost');
+    expect(addresses.length).toBeGreaterThan(0);
+    for (const address of addresses) {
+        expect([4, 6]).toContain(address.family);
+        expect(typeof address.address).toBe('string');
+    }
+});
+
+test('Default HostResolver prefetch and a bootstrap sharing a resolver', async () => {
+    const resolver = io.HostResolver.getDefault();
+    resolver.prefetch(['localhost']);
+    expect((await resolver.resolve('localhost')).length).toBeGreaterThan(0);
+
+    const bootstrap = new io.ClientBootstrap({ host_resolver: new io.HostResolver() });
+    expect(bootstrap.native_handle()).toBeDefined();
+});
+
+test('Logging to a file writes from a native thread', async () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'crt-log-'));
+    const file = path.join(dir, 'crt.log');
+    try {
+        io.enable_logging_to_file(file, io.LogLevel.TRACE, { flush_interval_ms: 10 });
+        new io.ClientBootstrap();
+        await new Promise((resolve) => setTimeout(resolve, 200));
+        io.disable_logging_to_file();
+        io.enable_logging(io.LogLevel.NONE);
+        const size = fs.statSync(file).size;
+        expect(size).toBeGreaterThan(0);
+
+        /* once disabled, nothing more reaches the file */
+        io.enable_logging(io.LogLevel.TRACE);
+        new io.ClientBootstrap();
+        await new Promise((resolve) => setTimeout(resolve, 100));
+        io.enable_logging(io.LogLevel.NONE);
+        expect(fs.statSync(file).size).toEqual(size);
+    } finally {
+        io.disable_logging_to_file();
+        try {
+            fs.unlinkSync(file);
+            fs.rmdirSync(dir);
+        } catch (err) { }
+    }
+});
+
+test('Log subjects can be configured individually', () => {
+    expect(() => {
+        io.set_log_subject_level('not-a-real-subject', io.LogLevel.DEBUG);
+    }).toThrow();
+
+    /* subject 0 is aws-c-common's general subject, which has no override here */
+    io.enable_logging(io.LogLevel.WARN);
+    try {
+        expect(crt_native.io_logging_get_subject_level('node')).toBe(io.LogLevel.WARN);
+        expect(crt_native.io_logging_get_subject_level(0)).toBe(io.LogLevel.WARN);
+
+        io.set_log_subject_level('node', io.LogLevel.DEBUG);
+        expect(crt_native.io_logging_get_subject_level('node')).toBe(io.LogLevel.DEBUG);
+        expect(crt_native.io_logging_get_subject_level(0)).toBe(io.LogLevel.WARN);
+
+        io.set_log_subject_level('node', io.LogLevel.ERROR);
+        expect(crt_native.io_logging_get_subject_level('node')).toBe(io.LogLevel.ERROR);
+        expect(crt_native.io_logging_get_subject_level(0)).toBe(io.LogLevel.WARN);
+
+        io.set_log_subject_level('node');
+        expect(crt_native.io_logging_get_subject_level('node')).toBe(io.LogLevel.WARN);
+    } finally {
+        io.set_log_subject_level('node');
+        io.enable_logging(io.LogLevel.NONE);
+    }
+});
+
+test('Log subject overrides and rate limits apply to what is written', async () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'crt-log-'));
+    const file = path.join(dir, 'crt.log');
+    try {
+        io.enable_logging_to_file(file, io.LogLevel.INFO, { flush_interval_ms: 10 });
+
+        io.set_log_subject_level('node', io.LogLevel.ERROR);
+        crt_native.io_logging_log('node', io.LogLevel.INFO, 'io-spec below the subject level');
+        crt_native.io_logging_log(0, io.LogLevel.INFO, 'io-spec other subject at the global level');
+        io.set_log_subject_level('node');
+
+        /* two lines at once, then one every 100ms */
+        io.set_log_subject_rate_limit('node', 10, 2);
+        for (let i = 0; i < 10; ++i) {
+            crt_native.io_logging_log('node', io.LogLevel.INFO, `io-spec limited ${i}`);
+        }
+        await new Promise((resolve) => setTimeout(resolve, 300));
+        crt_native.io_logging_log('node', io.LogLevel.INFO, 'io-spec after the limit');
+
+        await new Promise((resolve) => setTimeout(resolve, 200));
+        io.disable_logging_to_file();
+
+        const lines = fs.readFileSync(file, 'utf8').split('\n');
+        expect(lines.filter((line) => line.includes('io-spec below the subject level')).length).toBe(0);
+        expect(lines.filter((line) => line.includes('io-spec other subject at the global level')).length).toBe(1);
+        expect(lines.filter((line) => line.includes('io-spec limited')).length).toBe(2);
+        expect(lines.filter((line) => line.includes('8 log messages suppressed by rate limit')).length).toBe(1);
+        expect(lines.filter((line) => line.includes('io-spec after the limit')).length).toBe(1);
+    } finally {
+        io.set_log_subject_rate_limit('node', 0);
+        io.set_log_subject_level('node');
+        io.disable_logging_to_file();
+        io.enable_logging(io.LogLevel.NONE);
+        try {
+            fs.unlinkSync(file);
+            fs.rmdirSync(dir);
+        } catch (err) { }
+    }
+});
@@ -88,6 +88,98 @@ export function enable_logging(level: LogLevel) {
     crt_native.io_logging_enable(level);
 }
 
+/**
+ * Options for {@link enable_logging_to_file}
+ *
+ * nodejs only.
+ * @category Logging
+ */
+export interface LogFileOptions {
+    /**
+     * Size in bytes of the buffer lines are collected in between writes. Lines that arrive while a full buffer is
+     * still being written are dropped and counted. Defaults to 256KB.
+     */
+    buffer_size?: number;
+
+    /** Longest time, in milliseconds, a line will wait in the buffer before it is written. Defaults to 1000. */
+    flush_interval_ms?: number;
+
+    /** Rotate the file once a write would take it past this many bytes. Defaults to 0, which never rotates. */
+    max_file_size?: number;
+
+    /**
+     * Number of rotated files to keep, named `<path>.1` (newest) through `<path>.N`. 0 truncates the file on
+     * rotation instead. Defaults to 5.
+     */
+    max_files?: number;
+}
+
+/**
+ * Enables logging of the native AWS CRT libraries directly to a file.
+ *
+ * Unlike {@link enable_logging}, log lines never pass through the JavaScript thread: they are batched and written by a
+ * dedicated native thread, so logging at high levels does not compete with application work and is not lost while the
+ * event loop is blocked. Calling this again replaces the previous file, and {@link disable_logging_to_file} stops it.
+ *
+ * @param path - The file to append logs to. It is created if it does not exist.
+ * @param level - The logging level to filter to.
+ * @param options - Buffering and rotation options
+ *
+ * nodejs only.
+ * @category Logging
+ */
+export function enable_logging_to_file(path: string, level: LogLevel, options?: LogFileOptions) {
+    crt_native.io_logging_enable_file(
+        path,
+        level,
+        options?.buffer_size,
+        options?.flush_interval_ms,
+        options?.max_file_size,
+        options?.max_files);
+}
+
+/**
+ * Stops logging to the file set up by {@link enable_logging_to_file}, after writing out any buffered lines, and goes
+ * back to logging through node at the current level. Does nothing if logging to a file was never enabled.
+ *
+ * nodejs only.
+ * @category Logging
+ */
+export function disable_logging_to_file() {
+    crt_native.io_logging_disable_file();
+}
+
+/**
+ * Overrides the logging level for a single log subject, leaving all other subjects at the level given to
+ * {@link enable_logging} or {@link enable_logging_to_file}. The override can be more or less verbose than the global
+ * level. Lines filtered out this way are discarded before they are formatted.
+ *
+ * @param subject - The registered name of the subject (for example `'mqtt5-client'` or `'tls-handler'`), or its
+ *                  numeric id
+ * @param level - The level for this subject, or undefined to go back to following the global level
+ *
+ * nodejs only.
+ * @category Logging
+ */
+export function set_log_subject_level(subject: string | number, level?: LogLevel) {
+    crt_native.io_logging_set_subject_level(subject, level);
+}
+
+/**
+ * Limits how fast a single log subject may log. Lines over the limit are discarded before they are formatted, and the
+ * number discarded is logged once lines are let through again.
+ *
+ * @param subject - The registered name of the subject, or its numeric id
+ * @param messages_per_second - Average number of lines allowed per second, or 0 to remove the limit
+ * @param burst - Number of lines allowed at once after a quiet period. Defaults to messages_per_second.
+ *
+ * nodejs only.
+ * @category Logging
+ */
+export function set_log_subject_rate_limit(subject: string | number, messages_per_second: number, burst?: number) {
+    crt_native.io_logging_set_subject_rate_limit(subject, messages_per_second, burst);
+}
+
 /**
  * Returns true if ALPN is available on this platform natively
  * @return true if ALPN is supported natively, false otherwise
@@ -99,24 +191,250 @@ export function is_alpn_available(): boolean {
     return crt_native.is_alpn_available();
 }
 
+/**
+ * Options for an {@link InputStream} wrapping a ```Readable```
+ *
+ * nodejs only.
+ * @category IO
+ */
+export interface InputStreamOptions {
+    /**
+     * Number of bytes, already read natively, to keep in memory so that the native reader can seek back and read them
+     * again, for instance to retry or re-sign a request without going back to the source. Pass ```Infinity``` to keep
+     * the whole body. Defaults to 0, which releases data as soon as it has been read.
+     */
+    replay_window?: number;
+}
+
+/**
+ * Options for {@link InputStream.fromFile}
+ *
+ * nodejs only.
+ * @category IO
+ */
+export interface InputStreamFileOptions {
+    /** Offset within the file to start reading from, defaults to 0 */
+    offset?: number;
+
+    /** Number of bytes to read, defaults to everything from offset to the end of the file */
+    length?: number;
+
+    /**
+     * Read the file through a private read-only memory mapping instead of regular file reads. The file must not be
+     * truncated while the stream is in use. Ignored on Windows.
+     */
+    mmap?: boolean;
+}
+
 /**
  * Wraps a ```Readable``` for reading by native code, used to stream
  *  data into the AWS CRT libraries.
  *
+ * The source is paused while more than {@link InputStream.HIGH_WATERMARK} bytes are waiting to be read natively, and
+ * resumed once the native reader has brought that down to {@link InputStream.LOW_WATERMARK}, so memory use stays
+ * bounded no matter how large the body is.
+ *
  * nodejs only.
  * @category IO
  */
 export class InputStream extends NativeResource {
-    constructor(private source: Readable) {
-        super(crt_native.io_input_stream_new(16 * 1024));
-        this.source.on('data', (data) => {
+    /** Number of buffered bytes above which the source is paused */
+    static readonly HIGH_WATERMARK = 1024 * 1024;
+    /** Number of buffered bytes at or below which a paused source is resumed */
+    static readonly LOW_WATERMARK = 256 * 1024;
+
+    constructor(source: Readable, options?: InputStreamOptions);
+    /** @internal */
+    constructor(source: undefined, options: undefined, native_handle: any);
+    constructor(private source: Readable | undefined, options?: InputStreamOptions, native_handle?: any) {
+        super(native_handle ?? crt_native.io_input_stream_new(
+            16 * 1024,
+            InputStream.HIGH_WATERMARK,
+            InputStream.LOW_WATERMARK,
+            () => { source?.resume(); },
+            InputStream.toNativeLength(options?.replay_window ?? 0)));
+        if (native_handle) {
+            return;
+        }
+
+        const readable = this.source as Readable;
+        readable.on('data', (data) => {
             data = Buffer.isBuffer(data) ? data : Buffer.from(data.toString());
-            crt_native.io_input_stream_append(this.native_handle(), data);
+            if (crt_native.io_input_stream_append(this.native_handle(), data)) {
+                readable.pause();
+            }
         });
-        this.source.on('end', () => {
+        readable.on('end', () => {
             crt_native.io_input_stream_append(this.native_handle(), undefined);
         })
     }
+
+    /**
+     * Creates a stream that reads a file, or a range of it, natively. The data does not pass through node, and the
+     * stream knows its length up front.
+     *
+     * @param path - path of the file to read
+     * @param options - optional range and read mode
+     *
+     * nodejs only.
+     */
+    static fromFile(path: string, options?: InputStreamFileOptions): InputStream {
+        return new InputStream(undefined, undefined, crt_native.io_input_stream_new_from_file(
+            path,
+            options?.offset ?? 0,
+            options?.length,
+            options?.mmap ?? false));
+    }
+
+    /**
+     * Total number of bytes the stream will produce, or undefined if that is not known yet. A stream wrapping a
+     * ```Readable``` only knows its length once the source has ended.
+     */
+    get length(): number | undefined {
+        return crt_native.io_input_stream_get_length(this.native_handle());
+    }
+
+    /* native code reads lengths as int64, which turns Infinity into 0 */
+    private static toNativeLength(length: number): number {
+        return Math.min(length, Number.MAX_SAFE_INTEGER);
+    }
+}
+
+/**
+ * Sets the number of threads in the default event loop group, which is shared by every connection that is not
+ * given its own {@link ClientBootstrap}. A value of 0 uses one thread per processor.
+ *
+ * The default group is created the first time a connection or client bootstrap needs it, so this must be called
+ * before then. If it is never called, the ```AWS_CRT_EVENT_LOOP_THREAD_COUNT``` environment variable is used, and
+ * failing that a single thread.
+ *
+ * @param thread_count - number of native I/O threads to use for the default event loop group
+ *
+ * nodejs only.
+ * @category IO
+ */
+export function set_default_event_loop_thread_count(thread_count: number) {
+    crt_native.io_set_default_event_loop_thread_count(thread_count);
+}
+
+/**
+ * Options for a host resolver's DNS cache
+ *
+ * nodejs only.
+ * @category IO
+ */
+export interface HostResolverOptions {
+    /** Maximum number of host names to keep resolved addresses for. Defaults to 64. */
+    max_entries?: number;
+
+    /** Maximum number of seconds to keep a resolved address before resolving the host again. Defaults to 30. */
+    max_ttl_secs?: number;
+}
+
+/**
+ * Sets the size and TTL of the default host resolver, which is used by every connection that is not given its own
+ * {@link ClientBootstrap}, and by {@link HostResolver.getDefault}.
+ *
+ * The default resolver is created along with the default event loop group, so this must be called before the first
+ * connection or client bootstrap is created.
+ *
+ * @param options - cache settings for the default host resolver. Settings left undefined keep their defaults.
+ *
+ * nodejs only.
+ * @category IO
+ */
+export function set_default_host_resolver_options(options: HostResolverOptions) {
+    crt_native.io_set_default_host_resolver_options(options.max_entries, options.max_ttl_secs);
+}
+
+/**
+ * An address found for a host name, in the same shape as the results of ```dns.lookup()```
+ *
+ * nodejs only.
+ * @category IO
+ */
+export interface HostAddress {
+    /** IPv4 or IPv6 address, as a string */
+    address: string;
+
+    /** 4 or 6 */
+    family: number;
+}
+
+/**
+ * Native DNS resolver with a cache of resolved addresses. Once a host has been resolved, connections made through a
+ * {@link ClientBootstrap} using the same resolver find its addresses without waiting on a lookup. Lookups run on
+ * native threads, not on the libuv threadpool.
+ *
+ * nodejs only.
+ * @category IO
+ */
+export class HostResolver extends NativeResource {
+    /**
+     * Creates a resolver with its own cache
+     *
+     * @param options - cache settings
+     */
+    constructor(options?: HostResolverOptions);
+    /** @internal */
+    constructor(options: HostResolverOptions | undefined, use_default: boolean);
+    constructor(options?: HostResolverOptions, use_default: boolean = false) {
+        super(crt_native.io_host_resolver_new(use_default, options?.max_entries, options?.max_ttl_secs));
+    }
+
+    /**
+     * Returns the resolver behind the default client bootstrap, so that lookups and prefetches made through it warm
+     * the cache used by connections that are not given their own {@link ClientBootstrap}.
+     */
+    static getDefault(): HostResolver {
+        return new HostResolver(undefined, true);
+    }
+
+    /**
+     * Resolves a host name, using cached addresses if there are any
+     *
+     * @param host - host name to resolve
+     * @returns a Promise that resolves to the addresses found for host
+     */
+    resolve(host: string): Promise<HostAddress[]> {
+        return new Promise<HostAddress[]>((resolve, reject) => {
+            crt_native.io_host_resolver_resolve(this.native_handle(), host, (error_code, addresses) => {
+                if (error_code == 0) {
+                    resolve(addresses);
+                } else {
+                    reject(new CrtError(error_code));
+                }
+            });
+        });
+    }
+
+    /**
+     * Starts resolving a list of host names in the background, so that later connections and lookups find them cached
+     *
+     * @param hosts - host names to resolve
+     */
+    prefetch(hosts: string[]) {
+        crt_native.io_host_resolver_prefetch(this.native_handle(), hosts);
+    }
+}
+
+/**
+ * Options for creating a {@link ClientBootstrap}.
+ *
+ * nodejs only.
+ * @category IO
+ */
+export interface ClientBootstrapOptions {
+    /**
+     * If set, the bootstrap creates its own event loop group with this many threads, rather than using
+     * the default group. A value of 0 uses one thread per processor.
+     */
+    event_loop_thread_count?: number;
+
+    /**
+     * Resolver to look up hosts with. If not set, the bootstrap creates a private resolver caching up to 64 hosts.
+     */
+    host_resolver?: HostResolver;
 }
 
 /**
@@ -128,8 +446,10 @@ export class InputStream extends NativeResource {
  * @category IO
  */
 export class ClientBootstrap extends NativeResource {
-    constructor() {
-        super(crt_native.io_client_bootstrap_new());
+    constructor(options?: ClientBootstrapOptions) {
+        super(crt_native.io_client_bootstrap_new(
+            options?.event_loop_thread_count,
+            options?.host_resolver?.native_handle()));
     }
 }
 
@@ -220,6 +540,15 @@ export class TlsContextOptions {
      */
     public verify_peer: boolean = true;
 
+    /**
+     * Share one native context between every {@link TlsContext} created from identical options, instead of loading
+     * and parsing certificates and keys again for each one. The shared context is released once the last context
+     * using it is garbage collected. Options naming files are matched by path, so a context created after a file has
+     * changed may still use its old contents while an earlier one is alive. Has no effect with PKCS#11 options.
+     * Defaults to false.
+     */
+    public use_context_cache: boolean = false;
+
     /**
      * Overrides the default system trust store.
      * @param ca_dirpath - Only used on Unix-style systems where all trust anchors are
@@ -446,7 +775,8 @@ export abstract class TlsContext extends NativeResource {
             ctx_opt.pkcs12_password,
             ctx_opt.pkcs11_options,
             ctx_opt.windows_cert_store_path,
-            ctx_opt.verify_peer));
+            ctx_opt.verify_peer,
+            ctx_opt.use_context_cache));
     }
 }
 
@@ -455,6 +785,10 @@ export abstract class TlsContext extends NativeResource {
  * options are supplied, the context will default to enabling peer verification
  * only.
  *
+ * Creating a context loads and parses its trust store and key material, so create one and share it between every
+ * connection and client that uses the same settings. TLS session resumption is not supported: each connection
+ * performs a full handshake.
+ *
  * nodejs only.
  * @category TLS
  */
@@ -622,6 +622,8 @@ test_utils.conditional_test(test_utils.ClientEnvironmentalConfig.hasIotCoreEnvir
     let statistics : mqtt5.ClientStatistics = client.getOperationalStatistics();
     expect(statistics.incompleteOperationCount).toBeLessThanOrEqual(0);
     expect(statistics.incompleteOperationSize).toBeLessThanOrEqual(0);
+    expect(statistics.pendingMessageCount).toBeDefined();
+    expect(statistics.droppedMessageCount).toEqual(0);
     // Skip checking unacked operations - it heavily depends on socket speed and makes tests flakey
     // TODO - find a way to test unacked operations reliably without worrying about socket speed.
 
@@ -728,3 +730,35 @@ test_utils.conditional_test(test_utils.ClientEnvironmentalConfig.hasIotCoreEnvir
 
     client.close();
 });
+
+test_utils.conditional_test(test_utils.ClientEnvironmentalConfig.hasIotCoreEnvironment())('Close while received messages are above the high watermark', async () => {
+    let clientConfig : mqtt5.Mqtt5ClientConfig = createDirectIotCoreClientConfig();
+    clientConfig.maxPendingMessages = 8;
+    let client : mqtt5.Mqtt5Client = new mqtt5.Mqtt5Client(clientConfig);
+    client.on('messageReceived', (eventData: mqtt5.MessageReceivedEvent) => {});
+
+    let connectionSuccess = once(client, mqtt5.Mqtt5Client.CONNECTION_SUCCESS);
+    client.start();
+    await connectionSuccess;
+
+    let topic : string = `test-${uuid()}`;
+    await client.subscribe({
+        subscriptions: [{ topicFilter: topic, qos: mqtt5.QoS.AtMostOnce }]
+    });
+
+    for (let i = 0; i < 32; ++i) {
+        client.publish({ topicName: topic, qos: mqtt5.QoS.AtMostOnce, payload: Buffer.from(`message ${i}`) }).catch(() => {});
+    }
+
+    /* keep the node thread busy so that the echoed messages back up past the high watermark (6) */
+    const pendingMessages = () => client.getOperationalStatistics().pendingMessageCount ?? 0;
+    const busyUntil = Date.now() + 3000;
+    while (Date.now() < busyUntil && pendingMessages() < 6) {}
+    expect(pendingMessages()).toBeGreaterThanOrEqual(6);
+
+    /* tear the client down with the backlog still queued, the drains that follow must not touch the freed binding */
+    client.stop();
+    client.close();
+
+    await new Promise((resolve) => setTimeout(resolve, 2000));
+});
@@ -61,6 +61,22 @@ export interface ClientStatistics {
      * they can be completed.
      */
     unackedOperationSize : number;
+
+    /**
+     * Number of received messages that are waiting to be delivered to the node thread.
+     */
+    pendingMessageCount? : number;
+
+    /**
+     * Highest number of received messages that have been waiting for delivery at the same time.
+     */
+    peakPendingMessageCount? : number;
+
+    /**
+     * Total number of received messages dropped because {@link Mqtt5ClientConfig.maxPendingMessages} were already
+     * waiting for delivery.
+     */
+    droppedMessageCount? : number;
 };
 
 /**
@@ -203,6 +219,15 @@ export interface Mqtt5ClientConfig {
      */
     ackTimeoutSeconds? : number;
 
+    /**
+     * Maximum number of received messages that may be waiting for delivery to the node thread, for example while it
+     * is blocked by garbage collection or a slow event handler.  Further messages are dropped, and counted in
+     * {@link ClientStatistics.droppedMessageCount}, until the backlog drains.  If undefined or 0, there is no limit.
+     *
+     * @group Node-only
+     */
+    maxPendingMessages? : number;
+
     /**
      * Additional controls for client behavior with respect to topic alias usage.
      *
@@ -291,7 +316,7 @@ export class Mqtt5Client extends NativeResourceMixin(BufferedEventEmitter) imple
             (client: Mqtt5Client, connack : mqtt5_packet.ConnackPacket, settings: mqtt5.NegotiatedSettings) => { Mqtt5Client._s_on_connection_success(client, connack, settings); },
             (client: Mqtt5Client, errorCode: number, connack? : mqtt5_packet.ConnackPacket) => { Mqtt5Client._s_on_connection_failure(client, new CrtError(errorCode), connack); },
             (client: Mqtt5Client, errorCode: number, disconnect? : mqtt5_packet.DisconnectPacket) => { Mqtt5Client._s_on_disconnection(client, new CrtError(errorCode), disconnect); },
-            (client: Mqtt5Client, message : mqtt5_packet.PublishPacket) => { Mqtt5Client._s_on_message_received(client, message); },
+            (client: Mqtt5Client, messages : mqtt5_packet.PublishPacket[]) => { Mqtt5Client._s_on_messages_received(client, messages); },
             config.clientBootstrap ? config.clientBootstrap.native_handle() : null,
             config.socketOptions ? config.socketOptions.native_handle() : null,
             config.tlsCtx ? config.tlsCtx.native_handle() : null,
@@ -662,13 +687,16 @@ export class Mqtt5Client extends NativeResourceMixin(BufferedEventEmitter) imple
         }
     }
 
-    private static _s_on_message_received(client: Mqtt5Client, message : mqtt5_packet.PublishPacket) {
-        let messageReceivedEvent: mqtt5.MessageReceivedEvent = {
-            message: message
-        };
-
+    /* messages that arrive while node is busy are delivered together, in the order they were received */
+    private static _s_on_messages_received(client: Mqtt5Client, messages : mqtt5_packet.PublishPacket[]) {
         process.nextTick(() => {
-            client.emit(Mqtt5Client.MESSAGE_RECEIVED, messageReceivedEvent);
+            for (const message of messages) {
+                let messageReceivedEvent: mqtt5.MessageReceivedEvent = {
+                    message: message
+                };
+
+                client.emit(Mqtt5Client.MESSAGE_RECEIVED, messageReceivedEvent);
+            }
         });
     }
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+import { bindingPath } from './binding';
+import * as crypto from './crypto';
+
+/* worker_threads is not available without a flag on older versions of node */
+let worker_threads: any = undefined;
+try {
+    worker_threads = require('worker_threads');
+} catch (err) { }
+
+const conditional_test = (condition: any) => condition ? it : it.skip;
+
+/* Each worker loads its own copy of the module, uses the shared event loop group, does some work and exits */
+const WORKER_SOURCE = `
+const { parentPort, workerData } = require('worker_threads');
+const crt = require(workerData.bindingPath);
+
+const bootstrap = crt.io_client_bootstrap_new();
+let digest = undefined;
+for (let i = 0; i < workerData.iterations; ++i) {
+    digest = crt.hash_sha256_compute('worker ' + i, undefined);
+}
+crt.native_memory();
+parentPort.postMessage({ bootstrap: bootstrap !== undefined, digest: digest.byteLength });
+`;
+
+function run_worker(iterations: number): Promise<any> {
+    return new Promise((resolve, reject) => {
+        const worker = new worker_threads.Worker(WORKER_SOURCE, {
+            eval: true,
+            workerData: { bindingPath: bindingPath, iterations: iterations },
+        });
+        let result: any = undefined;
+        worker.on('message', (message: any) => { result = message; });
+        worker.on('error', reject);
+        worker.on('exit', (code: number) => {
+            if (code != 0) {
+                reject(new Error(`Worker exited with code ${code}`));
+            } else {
+                resolve(result);
+            }
+        });
+    });
+}
+
+conditional_test(worker_threads && bindingPath)('Workers start and stop while the main thread is busy', async () => {
+    for (let round = 0; round < 4; ++round) {
+        const workers = [];
+        for (let i = 0; i < 4; ++i) {
+            workers.push(run_worker(1000));
+        }
+
+        /* keep the main environment using the module while workers come and go */
+        for (let i = 0; i < 1000; ++i) {
+            crypto.hash_sha256('main ' + i);
+        }
+
+        const results = await Promise.all(workers);
+        for (const result of results) {
+            expect(result).toEqual({ bootstrap: true, digest: 32 });
+        }
+    }
+}, 60000);
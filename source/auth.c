@@ -46,6 +46,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
         .method = s_creds_provider_constructor,
         .num_arguments = 1,
         .arg_types = {napi_external},
+        .libraries = AWS_NAPI_LIBRARY_AUTH,
     };
 
     static const struct aws_napi_method_info s_creds_provider_methods[] = {
@@ -55,6 +56,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
             .num_arguments = 1,
             .arg_types = {napi_undefined},
             .attributes = napi_static,
+            .libraries = AWS_NAPI_LIBRARY_AUTH,
         },
         {
             .name = "newStatic",
@@ -62,6 +64,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
             .num_arguments = 2,
             .arg_types = {napi_string, napi_string, napi_string},
             .attributes = napi_static,
+            .libraries = AWS_NAPI_LIBRARY_AUTH,
         },
         {
             .name = "newCognito",
@@ -69,6 +72,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
             .num_arguments = 4,
             .arg_types = {napi_undefined, napi_undefined, napi_undefined, napi_undefined},
             .attributes = napi_static,
+            .libraries = AWS_NAPI_LIBRARY_AUTH,
         },
         {
             .name = "newX509",
@@ -76,6 +80,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
             .num_arguments = 3,
             .arg_types = {napi_undefined, napi_undefined, napi_undefined},
             .attributes = napi_static,
+            .libraries = AWS_NAPI_LIBRARY_AUTH,
         }};
 
     AWS_NAPI_CALL(
@@ -96,6 +101,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
         .method = s_aws_sign_request,
         .num_arguments = 3,
         .arg_types = {napi_object, napi_object, napi_function},
+        .libraries = AWS_NAPI_LIBRARY_AUTH,
     };
 
     AWS_NAPI_CALL(env, aws_napi_define_function(env, exports, &s_signer_request_method), { return status; });
@@ -105,6 +111,7 @@ napi_status aws_napi_auth_bind(napi_env env, napi_value exports) {
         .method = s_aws_verify_sigv4a_signing,
         .num_arguments = 6,
         .arg_types = {napi_object, napi_object, napi_string, napi_string, napi_string, napi_string},
+        .libraries = AWS_NAPI_LIBRARY_AUTH,
     };
 
     AWS_NAPI_CALL(env, aws_napi_define_function(env, exports, &s_verify_sigv4a_signing_method), { return status; });
@@ -153,7 +160,7 @@ static napi_value s_creds_provider_new_default(napi_env env, const struct aws_na
 
     AWS_FATAL_ASSERT(cb_info->num_args == 1);
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     const struct aws_napi_argument *arg = NULL;
 
     aws_napi_method_next_argument(napi_external, cb_info, &arg);
@@ -184,7 +191,7 @@ static napi_value s_creds_provider_new_static(napi_env env, const struct aws_nap
 
     AWS_FATAL_ASSERT(cb_info->num_args >= 2);
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     const struct aws_napi_argument *arg = NULL;
 
     struct aws_credentials_provider_static_options options;
@@ -258,7 +265,7 @@ static int s_aws_cognito_credentials_provider_config_init(
     struct aws_byte_buf identity_provider_token_buf;
     AWS_ZERO_STRUCT(identity_provider_token_buf);
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     if (aws_array_list_init_dynamic(
             &config->logins, allocator, 0, sizeof(struct aws_cognito_identity_provider_token_pair)) ||
         aws_array_list_init_dynamic(&config->login_buffers, allocator, 0, sizeof(struct aws_byte_buf))) {
@@ -391,7 +398,7 @@ static napi_value s_creds_provider_new_cognito(napi_env env, const struct aws_na
     AWS_FATAL_ASSERT(cb_info->num_args == 4);
 
     napi_value node_provider = NULL;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     struct aws_credentials_provider *provider = NULL;
     struct aws_cognito_credentials_provider_config provider_config;
     AWS_ZERO_STRUCT(provider_config);
@@ -515,7 +522,7 @@ static napi_value s_creds_provider_new_x509(napi_env env, const struct aws_napi_
     AWS_FATAL_ASSERT(cb_info->num_args == 3);
 
     napi_value node_provider = NULL;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     struct aws_credentials_provider *provider = NULL;
     struct aws_x509_credentials_provider_config provider_config;
     AWS_ZERO_STRUCT(provider_config);
@@ -663,7 +670,7 @@ static void s_aws_sign_request_complete_call(napi_env env, napi_value on_complet
 static void s_aws_sign_request_complete(struct aws_signing_result *result, int error_code, void *userdata) {
 
     struct signer_sign_request_state *state = userdata;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
 
     state->error_code = error_code;
     if (error_code == AWS_ERROR_SUCCESS) {
@@ -912,7 +919,7 @@ done:
 
 static napi_value s_aws_sign_request(napi_env env, const struct aws_napi_callback_info *cb_info) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     const struct aws_napi_argument *arg = NULL;
 
     struct signer_sign_request_state *state = aws_mem_calloc(allocator, 1, sizeof(struct signer_sign_request_state));
@@ -1028,7 +1035,7 @@ static napi_value s_aws_verify_sigv4a_signing(napi_env env, const struct aws_nap
 
     AWS_NAPI_ENSURE(env, napi_get_boolean(env, false, &result));
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_AUTH);
     const struct aws_napi_argument *arg = NULL;
 
     struct signer_sign_request_state *state = aws_mem_calloc(allocator, 1, sizeof(struct signer_sign_request_state));
@@ -7,9 +7,29 @@
 
 #include <aws/checksums/crc.h>
 
+#include <stdio.h>
+
+/* reversed (LSB first) generator polynomials, as used by the table driven implementations */
+#define CRC32_POLYNOMIAL 0xEDB88320
+#define CRC32C_POLYNOMIAL 0x82F63B78
+
+typedef uint32_t(crc_fn)(const uint8_t *, int, uint32_t);
+
+/* The checksum functions take an int length, so anything longer is fed to them in INT_MAX slices */
+static uint32_t s_crc_buffer(crc_fn *checksum_fn, const uint8_t *buffer, size_t length, uint32_t previous) {
+    uint32_t val = previous;
+    while (length > INT_MAX) {
+        val = checksum_fn(buffer, INT_MAX, val);
+        buffer += (size_t)INT_MAX;
+        length -= (size_t)INT_MAX;
+    }
+    return checksum_fn(buffer, (int)length, val);
+}
+
 napi_value crc_common(napi_env env, napi_callback_info info, uint32_t (*checksum_fn)(const uint8_t *, int, uint32_t)) {
     napi_value node_args[2];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
+    uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
     struct aws_byte_buf to_hash;
     AWS_ZERO_STRUCT(to_hash);
     // struct aws_byte_buf *to_hash_ptr = (struct aws_byte_buf*)NULL;
@@ -24,7 +44,8 @@ napi_value crc_common(napi_env env, napi_callback_info info, uint32_t (*checksum
         goto done;
     }
 
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[0])) {
+    if (aws_byte_buf_init_from_napi_with_storage(
+            &to_hash, env, node_args[0], to_hash_storage, sizeof(to_hash_storage))) {
         napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
         goto done;
     }
@@ -39,13 +60,7 @@ napi_value crc_common(napi_env env, napi_callback_info info, uint32_t (*checksum
         }
     }
 
-    uint32_t val = previous;
-    while (length > INT_MAX) {
-        val = checksum_fn(buffer, INT_MAX, val);
-        buffer += (size_t)INT_MAX;
-        length -= (size_t)INT_MAX;
-    }
-    val = checksum_fn(buffer, (int)length, val);
+    uint32_t val = s_crc_buffer(checksum_fn, buffer, length, previous);
     AWS_NAPI_CALL(env, napi_create_uint32(env, val, &node_val), { goto done; });
 
 done:
@@ -61,3 +76,441 @@ napi_value aws_napi_checksums_crc32(napi_env env, napi_callback_info info) {
 napi_value aws_napi_checksums_crc32c(napi_env env, napi_callback_info info) {
     return crc_common(env, info, aws_checksums_crc32c);
 }
+
+/*******************************************************************************
+ * Combine
+ ******************************************************************************/
+
+/*
+ * Appending a zero bit to the message is a linear map on the crc register, so it can be written as a 32x32 matrix over
+ * GF(2), one column per word. Squaring the matrix gives the map for twice as many zeros, which lets crc(A) be advanced
+ * past len(B) zero bytes in O(log(len(B))) steps. crc(AB) is then that value xor crc(B).
+ */
+static uint32_t s_gf2_matrix_times(const uint32_t *mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+static void s_gf2_matrix_square(uint32_t *square, const uint32_t *mat) {
+    for (size_t n = 0; n < 32; ++n) {
+        square[n] = s_gf2_matrix_times(mat, mat[n]);
+    }
+}
+
+static uint32_t s_crc_combine(uint32_t polynomial, uint32_t crc_a, uint32_t crc_b, uint64_t len_b) {
+    if (len_b == 0) {
+        return crc_a;
+    }
+
+    uint32_t even[32]; /* even powers of two zeros operator */
+    uint32_t odd[32];  /* odd powers of two zeros operator */
+
+    /* operator for one zero bit */
+    odd[0] = polynomial;
+    uint32_t row = 1;
+    for (size_t n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    /* operators for two and then four zero bits */
+    s_gf2_matrix_square(even, odd);
+    s_gf2_matrix_square(odd, even);
+
+    /* the first square below gives the operator for one zero byte, apply one per set bit of len_b */
+    do {
+        s_gf2_matrix_square(even, odd);
+        if (len_b & 1) {
+            crc_a = s_gf2_matrix_times(even, crc_a);
+        }
+        len_b >>= 1;
+        if (len_b == 0) {
+            break;
+        }
+
+        s_gf2_matrix_square(odd, even);
+        if (len_b & 1) {
+            crc_a = s_gf2_matrix_times(odd, crc_a);
+        }
+        len_b >>= 1;
+    } while (len_b != 0);
+
+    return crc_a ^ crc_b;
+}
+
+static napi_value s_crc_combine_common(napi_env env, napi_callback_info info, uint32_t polynomial, const char *name) {
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s needs exactly 3 arguments", name);
+        napi_throw_error(env, NULL, message);
+        return NULL;
+    }
+
+    uint32_t crc_a = 0;
+    if (napi_get_value_uint32(env, node_args[0], &crc_a)) {
+        napi_throw_type_error(env, NULL, "crc_a argument must be a positive number");
+        return NULL;
+    }
+
+    uint32_t crc_b = 0;
+    if (napi_get_value_uint32(env, node_args[1], &crc_b)) {
+        napi_throw_type_error(env, NULL, "crc_b argument must be a positive number");
+        return NULL;
+    }
+
+    int64_t len_b = 0;
+    if (napi_get_value_int64(env, node_args[2], &len_b)) {
+        napi_throw_type_error(env, NULL, "len_b argument must be a number");
+        return NULL;
+    }
+    if (len_b < 0) {
+        napi_throw_range_error(env, NULL, "len_b argument must not be negative");
+        return NULL;
+    }
+
+    napi_value node_val = NULL;
+    AWS_NAPI_CALL(env, napi_create_uint32(env, s_crc_combine(polynomial, crc_a, crc_b, (uint64_t)len_b), &node_val), {
+        return NULL;
+    });
+    return node_val;
+}
+
+napi_value aws_napi_checksums_crc32_combine(napi_env env, napi_callback_info info) {
+    return s_crc_combine_common(env, info, CRC32_POLYNOMIAL, "checksums_crc32_combine");
+}
+
+napi_value aws_napi_checksums_crc32c_combine(napi_env env, napi_callback_info info) {
+    return s_crc_combine_common(env, info, CRC32C_POLYNOMIAL, "checksums_crc32c_combine");
+}
+
+/*******************************************************************************
+ * Async
+ ******************************************************************************/
+
+/* Matches libuv's default thread pool size; more parts than threads would only queue behind each other */
+#define CRC_ASYNC_MAX_PARTS 4
+/* Smaller slices aren't worth a trip through the thread pool */
+#define CRC_ASYNC_MIN_PART_SIZE (1024 * 1024)
+
+struct crc_async_job;
+
+struct crc_async_part {
+    struct crc_async_job *job;
+    napi_async_work work;
+    const uint8_t *buffer;
+    size_t length;
+    uint32_t crc;
+};
+
+/*
+ * A checksum split into contiguous parts that are computed on the libuv thread pool concurrently. Every part completes
+ * on the node thread, so the bookkeeping needs no locking; the last one to finish combines the part checksums in order
+ * and calls back. Buffers are borrowed from node and pinned by a reference until then, strings are copied.
+ */
+struct crc_async_job {
+    struct aws_allocator *allocator;
+    crc_fn *checksum_fn;
+    uint32_t polynomial;
+
+    napi_ref node_data;
+    napi_ref on_complete;
+
+    struct aws_byte_buf data;
+    uint32_t previous;
+
+    size_t num_parts;
+    size_t parts_remaining;
+    struct crc_async_part parts[CRC_ASYNC_MAX_PARTS];
+    int error_code;
+};
+
+static void s_crc_async_job_destroy(napi_env env, struct crc_async_job *job) {
+    if (job->node_data) {
+        napi_delete_reference(env, job->node_data);
+    }
+    if (job->on_complete) {
+        napi_delete_reference(env, job->on_complete);
+    }
+    for (size_t i = 0; i < job->num_parts; ++i) {
+        if (job->parts[i].work) {
+            napi_delete_async_work(env, job->parts[i].work);
+        }
+    }
+
+    /* borrowed buffers have no allocator, so this only frees copies */
+    aws_byte_buf_clean_up(&job->data);
+    aws_mem_release(job->allocator, job);
+}
+
+static void s_crc_async_execute(napi_env env, void *user_data) {
+    (void)env;
+    struct crc_async_part *part = user_data;
+
+    part->crc = s_crc_buffer(part->job->checksum_fn, part->buffer, part->length, 0);
+}
+
+static void s_crc_async_complete(napi_env env, napi_status status, void *user_data) {
+    struct crc_async_part *part = user_data;
+    struct crc_async_job *job = part->job;
+
+    if (status != napi_ok) {
+        job->error_code = AWS_ERROR_UNKNOWN;
+    }
+    if (--job->parts_remaining > 0) {
+        return;
+    }
+
+    uint32_t crc = job->previous;
+    for (size_t i = 0; i < job->num_parts; ++i) {
+        crc = s_crc_combine(job->polynomial, crc, job->parts[i].crc, job->parts[i].length);
+    }
+
+    napi_value params[2];
+    const size_t num_params = AWS_ARRAY_SIZE(params);
+    AWS_NAPI_CALL(env, napi_create_uint32(env, job->error_code, &params[0]), { goto done; });
+    if (job->error_code == AWS_ERROR_SUCCESS) {
+        AWS_NAPI_CALL(env, napi_create_uint32(env, crc, &params[1]), { goto done; });
+    } else {
+        AWS_NAPI_CALL(env, napi_get_undefined(env, &params[1]), { goto done; });
+    }
+
+    napi_value on_complete = NULL;
+    napi_value node_this = NULL;
+    AWS_NAPI_CALL(env, napi_get_reference_value(env, job->on_complete, &on_complete), { goto done; });
+    AWS_NAPI_CALL(env, napi_get_undefined(env, &node_this), { goto done; });
+    napi_call_function(env, node_this, on_complete, num_params, params, NULL);
+
+done:
+    s_crc_async_job_destroy(env, job);
+}
+
+static napi_value s_crc_async_common(
+    napi_env env,
+    napi_callback_info info,
+    crc_fn *checksum_fn,
+    uint32_t polynomial,
+    const char *name) {
+
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s needs exactly 3 arguments", name);
+        napi_throw_error(env, NULL, message);
+        return NULL;
+    }
+
+    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct crc_async_job *job = aws_mem_calloc(allocator, 1, sizeof(struct crc_async_job));
+    if (!job) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+    job->allocator = allocator;
+    job->checksum_fn = checksum_fn;
+    job->polynomial = polynomial;
+
+    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
+        if (napi_get_value_uint32(env, node_args[1], &job->previous)) {
+            napi_throw_type_error(env, NULL, "previous argument must be undefined or a positive number");
+            goto error;
+        }
+    }
+
+    napi_valuetype type = napi_undefined;
+    if (napi_typeof(env, node_args[2], &type) || type != napi_function) {
+        napi_throw_type_error(env, NULL, "on_complete argument must be a function");
+        goto error;
+    }
+    AWS_NAPI_CALL(env, napi_create_reference(env, node_args[2], 1, &job->on_complete), {
+        napi_throw_error(env, NULL, "Failed to reference on_complete");
+        goto error;
+    });
+
+    if (aws_byte_buf_init_from_napi(&job->data, env, node_args[0])) {
+        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
+        goto error;
+    }
+
+    /* a buffer without an allocator is node's memory, keep it alive until every part is done with it */
+    if (job->data.allocator == NULL) {
+        AWS_NAPI_CALL(env, napi_create_reference(env, node_args[0], 1, &job->node_data), {
+            napi_throw_error(env, NULL, "Failed to reference to_hash");
+            goto error;
+        });
+    }
+
+    /* at least one part, even for empty input, so that there is always a completion to call back from */
+    size_t num_parts = job->data.len / CRC_ASYNC_MIN_PART_SIZE;
+    num_parts = aws_max_size(1, aws_min_size(num_parts, CRC_ASYNC_MAX_PARTS));
+    const size_t part_size = job->data.len / num_parts;
+
+    napi_value resource_name = NULL;
+    AWS_NAPI_CALL(env, napi_create_string_utf8(env, "aws_crc_async", NAPI_AUTO_LENGTH, &resource_name), {
+        napi_throw_error(env, NULL, "Failed to create async work resource name");
+        goto error;
+    });
+
+    for (size_t i = 0; i < num_parts; ++i) {
+        struct crc_async_part *part = &job->parts[i];
+        part->job = job;
+        part->buffer = job->data.buffer + i * part_size;
+        part->length = (i + 1 == num_parts) ? job->data.len - i * part_size : part_size;
+
+        ++job->num_parts;
+        AWS_NAPI_CALL(
+            env,
+            napi_create_async_work(
+                env, NULL, resource_name, s_crc_async_execute, s_crc_async_complete, part, &part->work),
+            {
+                napi_throw_error(env, NULL, "Failed to create async checksum work");
+                goto error;
+            });
+    }
+
+    job->parts_remaining = num_parts;
+    for (size_t i = 0; i < num_parts; ++i) {
+        if (napi_queue_async_work(env, job->parts[i].work) == napi_ok) {
+            continue;
+        }
+
+        if (i == 0) {
+            napi_throw_error(env, NULL, "Failed to queue async checksum work");
+            goto error;
+        }
+
+        /* parts already queued will complete, so let them report the failure */
+        job->error_code = AWS_ERROR_UNKNOWN;
+        job->parts_remaining = i;
+        break;
+    }
+
+    return NULL;
+
+error:
+    s_crc_async_job_destroy(env, job);
+    return NULL;
+}
+
+napi_value aws_napi_checksums_crc32_async(napi_env env, napi_callback_info info) {
+    return s_crc_async_common(env, info, aws_checksums_crc32, CRC32_POLYNOMIAL, "checksums_crc32_async");
+}
+
+napi_value aws_napi_checksums_crc32c_async(napi_env env, napi_callback_info info) {
+    return s_crc_async_common(env, info, aws_checksums_crc32c, CRC32C_POLYNOMIAL, "checksums_crc32c_async");
+}
+
+/*******************************************************************************
+ * Parts
+ ******************************************************************************/
+
+/*
+ * Checksums each element of an array on its own, as the parts of a multipart upload are, and combines them into the
+ * checksum of their concatenation. Returns { parts: number[], checksum: number }.
+ */
+static napi_value s_crc_parts_common(
+    napi_env env,
+    napi_callback_info info,
+    crc_fn *checksum_fn,
+    uint32_t polynomial,
+    const char *name) {
+
+    napi_value node_args[1];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s needs exactly 1 argument", name);
+        napi_throw_error(env, NULL, message);
+        return NULL;
+    }
+
+    bool is_array = false;
+    if (napi_is_array(env, node_args[0], &is_array) || !is_array) {
+        napi_throw_type_error(env, NULL, "parts argument must be an array");
+        return NULL;
+    }
+
+    uint32_t count = 0;
+    AWS_NAPI_CALL(env, napi_get_array_length(env, node_args[0], &count), {
+        napi_throw_error(env, NULL, "Failed to get length of parts");
+        return NULL;
+    });
+
+    napi_value node_parts = NULL;
+    AWS_NAPI_CALL(env, napi_create_array_with_length(env, count, &node_parts), {
+        napi_throw_error(env, NULL, "Failed to create parts array");
+        return NULL;
+    });
+
+    uint32_t checksum = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value node_element = NULL;
+        AWS_NAPI_CALL(env, napi_get_element(env, node_args[0], i, &node_element), {
+            napi_throw_error(env, NULL, "Failed to get element of parts");
+            return NULL;
+        });
+
+        uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
+        struct aws_byte_buf to_hash;
+        if (aws_byte_buf_init_from_napi_with_storage(
+                &to_hash, env, node_element, to_hash_storage, sizeof(to_hash_storage))) {
+            napi_throw_type_error(env, NULL, "parts elements must be strings or arrays");
+            return NULL;
+        }
+
+        uint32_t part_crc = s_crc_buffer(checksum_fn, to_hash.buffer, to_hash.len, 0);
+        checksum = s_crc_combine(polynomial, checksum, part_crc, to_hash.len);
+        aws_byte_buf_clean_up(&to_hash);
+
+        napi_value node_part_crc = NULL;
+        AWS_NAPI_CALL(env, napi_create_uint32(env, part_crc, &node_part_crc), { return NULL; });
+        AWS_NAPI_CALL(env, napi_set_element(env, node_parts, i, node_part_crc), {
+            napi_throw_error(env, NULL, "Failed to set element of parts");
+            return NULL;
+        });
+    }
+
+    napi_value node_checksum = NULL;
+    AWS_NAPI_CALL(env, napi_create_uint32(env, checksum, &node_checksum), { return NULL; });
+
+    napi_value result = NULL;
+    AWS_NAPI_CALL(env, napi_create_object(env, &result), {
+        napi_throw_error(env, NULL, "Failed to create result object");
+        return NULL;
+    });
+    AWS_NAPI_CALL(env, napi_set_named_property(env, result, "parts", node_parts), {
+        napi_throw_error(env, NULL, "Failed to set parts");
+        return NULL;
+    });
+    AWS_NAPI_CALL(env, napi_set_named_property(env, result, "checksum", node_checksum), {
+        napi_throw_error(env, NULL, "Failed to set checksum");
+        return NULL;
+    });
+
+    return result;
+}
+
+napi_value aws_napi_checksums_crc32c_parts(napi_env env, napi_callback_info info) {
+    return s_crc_parts_common(env, info, aws_checksums_crc32c, CRC32C_POLYNOMIAL, "checksums_crc32c_parts");
+}
@@ -10,4 +10,14 @@
 napi_value aws_napi_checksums_crc32(napi_env env, napi_callback_info info);
 napi_value aws_napi_checksums_crc32c(napi_env env, napi_callback_info info);
 
+/* Checksum of the concatenation AB from (crc(A), crc(B), len(B)) */
+napi_value aws_napi_checksums_crc32_combine(napi_env env, napi_callback_info info);
+napi_value aws_napi_checksums_crc32c_combine(napi_env env, napi_callback_info info);
+
+/* Splits the input across the libuv thread pool and combines the results */
+napi_value aws_napi_checksums_crc32_async(napi_env env, napi_callback_info info);
+napi_value aws_napi_checksums_crc32c_async(napi_env env, napi_callback_info info);
+
+napi_value aws_napi_checksums_crc32c_parts(napi_env env, napi_callback_info info);
+
 #endif /* AWS_CRT_NODEJS_CHECKSUMS_H */
@@ -68,7 +68,15 @@ static napi_status s_argument_parse(
         }
 
         case napi_string: {
-            AWS_NAPI_CALL(env, aws_byte_buf_init_from_napi(&out_value->native.string, env, value), { return status; });
+            AWS_NAPI_CALL(
+                env,
+                aws_byte_buf_init_from_napi_with_storage(
+                    &out_value->native.string,
+                    env,
+                    value,
+                    out_value->string_storage,
+                    sizeof(out_value->string_storage)),
+                { return status; });
 
             break;
         }
@@ -145,6 +153,8 @@ static napi_value s_constructor(napi_env env, napi_callback_info info) {
         num_args = AWS_NAPI_METHOD_MAX_ARGS;
     }
 
+    aws_napi_ensure_library_initialized(class_info->ctor_method->libraries);
+
     napi_value result = NULL;
 
     /* Check if we're wrapping an existing object or creating a new one */
@@ -306,6 +316,8 @@ static napi_value s_method_call(napi_env env, napi_callback_info info) {
     }
 
     struct aws_napi_method_info *method = data;
+    aws_napi_ensure_library_initialized(method->libraries);
+
     if (num_args < method->num_arguments) {
         napi_throw_error(env, NULL, "Bound class's method requires more arguments");
         return NULL;
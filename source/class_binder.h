@@ -29,6 +29,8 @@ struct aws_napi_argument {
         struct aws_byte_buf string;
         void *external;
     } native;
+    /* short string arguments are copied here instead of to the heap */
+    uint8_t string_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
 };
 
 /**
@@ -72,6 +74,9 @@ struct aws_napi_method_info {
     napi_valuetype arg_types[AWS_NAPI_METHOD_MAX_ARGS];
 
     napi_property_attributes attributes;
+
+    /* Mask of enum aws_napi_library, initialized before the method (or constructor) runs */
+    uint32_t libraries;
 };
 
 /***********************************************************************************************************************
@@ -6,6 +6,178 @@
 
 #include <aws/cal/hash.h>
 #include <aws/cal/hmac.h>
+#include <aws/common/encoding.h>
+
+#include <stdio.h>
+
+/*******************************************************************************
+ * Digest output
+ ******************************************************************************/
+
+enum digest_output_type {
+    DIGEST_OUTPUT_DATAVIEW,
+    DIGEST_OUTPUT_BUFFER,
+    DIGEST_OUTPUT_HEX,
+    DIGEST_OUTPUT_BASE64,
+};
+
+/*
+ * Where a digest goes: a new DataView (the default), a caller supplied buffer at an offset, or straight into a hex or
+ * base64 string. Only the DataView needs anything allocated by node; the others write into memory that already exists.
+ */
+struct digest_output {
+    enum digest_output_type type;
+    size_t digest_size;
+    uint8_t *target;
+    napi_value node_arraybuffer;
+    uint8_t storage[AWS_SHA256_LEN];
+};
+
+/*
+ * Parses the truncate_to, output and offset arguments shared by every digest function. output may be undefined,
+ * "hex", "base64", or an ArrayBuffer/ArrayBufferView to write into starting at offset. On failure, an exception has
+ * been thrown.
+ */
+static int s_digest_output_init(
+    napi_env env,
+    struct digest_output *output,
+    size_t digest_size,
+    napi_value node_truncate_to,
+    napi_value node_output,
+    napi_value node_offset) {
+
+    AWS_ZERO_STRUCT(*output);
+    AWS_FATAL_ASSERT(digest_size <= sizeof(output->storage));
+
+    if (!aws_napi_is_null_or_undefined(env, node_truncate_to)) {
+        uint32_t truncate_to = 0;
+        if (napi_get_value_uint32(env, node_truncate_to, &truncate_to)) {
+            napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
+            return AWS_OP_ERR;
+        }
+
+        if (truncate_to && digest_size > truncate_to) {
+            digest_size = truncate_to;
+        }
+    }
+    output->digest_size = digest_size;
+
+    if (aws_napi_is_null_or_undefined(env, node_output)) {
+        output->type = DIGEST_OUTPUT_DATAVIEW;
+        if (napi_create_arraybuffer(env, digest_size, (void **)&output->target, &output->node_arraybuffer)) {
+            napi_throw_error(env, NULL, "Failed to create output arraybuffer");
+            return AWS_OP_ERR;
+        }
+        return AWS_OP_SUCCESS;
+    }
+
+    napi_valuetype type = napi_undefined;
+    AWS_NAPI_CALL(env, napi_typeof(env, node_output, &type), {
+        napi_throw_error(env, NULL, "Failed to determine type of output argument");
+        return AWS_OP_ERR;
+    });
+
+    if (type == napi_string) {
+        char encoding[8];
+        size_t encoding_len = 0;
+        AWS_NAPI_CALL(env, napi_get_value_string_utf8(env, node_output, encoding, sizeof(encoding), &encoding_len), {
+            napi_throw_error(env, NULL, "Failed to read output encoding");
+            return AWS_OP_ERR;
+        });
+
+        struct aws_byte_cursor encoding_cur = aws_byte_cursor_from_array(encoding, encoding_len);
+        if (aws_byte_cursor_eq_c_str(&encoding_cur, "hex")) {
+            output->type = DIGEST_OUTPUT_HEX;
+        } else if (aws_byte_cursor_eq_c_str(&encoding_cur, "base64")) {
+            output->type = DIGEST_OUTPUT_BASE64;
+        } else {
+            napi_throw_type_error(env, NULL, "output encoding must be 'hex' or 'base64'");
+            return AWS_OP_ERR;
+        }
+        output->target = output->storage;
+        return AWS_OP_SUCCESS;
+    }
+
+    /* init leaves the buffer untouched for values that aren't strings or buffers, so it must start out empty */
+    struct aws_byte_buf out_buf;
+    AWS_ZERO_STRUCT(out_buf);
+    if (aws_byte_buf_init_from_napi(&out_buf, env, node_output) || out_buf.allocator != NULL) {
+        aws_byte_buf_clean_up(&out_buf);
+        napi_throw_type_error(env, NULL, "output argument must be undefined, an encoding, or a buffer");
+        return AWS_OP_ERR;
+    }
+
+    uint32_t offset = 0;
+    if (!aws_napi_is_null_or_undefined(env, node_offset)) {
+        if (napi_get_value_uint32(env, node_offset, &offset)) {
+            napi_throw_type_error(env, NULL, "offset argument must be undefined or a non-negative integer");
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (offset > out_buf.len || out_buf.len - offset < digest_size) {
+        napi_throw_range_error(env, NULL, "output buffer is too small to hold the digest at offset");
+        return AWS_OP_ERR;
+    }
+
+    output->type = DIGEST_OUTPUT_BUFFER;
+    output->target = out_buf.buffer + offset;
+    return AWS_OP_SUCCESS;
+}
+
+/* Buffer for the hash to finalize into */
+static struct aws_byte_buf s_digest_output_buf(struct digest_output *output) {
+    return aws_byte_buf_from_empty_array(output->target, output->digest_size);
+}
+
+/*
+ * Produces the return value once the digest has been written: a DataView, the number of bytes written into the
+ * caller's buffer, or the encoded string
+ */
+static napi_value s_digest_output_finish(napi_env env, struct digest_output *output) {
+    napi_value result = NULL;
+    struct aws_byte_cursor digest = aws_byte_cursor_from_array(output->target, output->digest_size);
+
+    /* big enough for either encoding of the largest digest, plus a terminator */
+    char encoded_storage[2 * AWS_SHA256_LEN + 2];
+    AWS_ZERO_ARRAY(encoded_storage);
+    struct aws_byte_buf encoded = aws_byte_buf_from_empty_array(encoded_storage, sizeof(encoded_storage) - 1);
+
+    switch (output->type) {
+        case DIGEST_OUTPUT_DATAVIEW:
+            if (napi_create_dataview(env, output->digest_size, output->node_arraybuffer, 0, &result)) {
+                napi_throw_error(env, NULL, "Failed to create output dataview");
+                return NULL;
+            }
+            break;
+
+        case DIGEST_OUTPUT_BUFFER:
+            if (napi_create_uint32(env, (uint32_t)output->digest_size, &result)) {
+                napi_throw_error(env, NULL, "Failed to create output length");
+                return NULL;
+            }
+            break;
+
+        case DIGEST_OUTPUT_HEX:
+        case DIGEST_OUTPUT_BASE64: {
+            int encode_result = (output->type == DIGEST_OUTPUT_HEX) ? aws_hex_encode(&digest, &encoded)
+                                                                    : aws_base64_encode(&digest, &encoded);
+            if (encode_result) {
+                aws_napi_throw_last_error(env);
+                return NULL;
+            }
+
+            /* depending on the version, the encoders may or may not count a terminator, so rely on it instead */
+            if (napi_create_string_latin1(env, encoded_storage, NAPI_AUTO_LENGTH, &result)) {
+                napi_throw_error(env, NULL, "Failed to create output string");
+                return NULL;
+            }
+            break;
+        }
+    }
+
+    return result;
+}
 
 /*******************************************************************************
  * Hash
@@ -93,8 +265,10 @@ napi_value aws_napi_hash_update(napi_env env, napi_callback_info info) {
         return NULL;
     }
 
+    uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
     struct aws_byte_buf to_hash;
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[1])) {
+    if (aws_byte_buf_init_from_napi_with_storage(
+            &to_hash, env, node_args[1], to_hash_storage, sizeof(to_hash_storage))) {
         napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
         return NULL;
     }
@@ -111,14 +285,15 @@ napi_value aws_napi_hash_update(napi_env env, napi_callback_info info) {
 
 napi_value aws_napi_hash_digest(napi_env env, napi_callback_info info) {
 
-    napi_value node_args[2];
+    napi_value node_args[4];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retreive callback information");
         return NULL;
     }
-    if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "hash_digest needs exactly 2 arguments");
+    /* output and offset are optional, napi fills in undefined for them */
+    if (num_args < 2) {
+        napi_throw_error(env, NULL, "hash_digest needs at least 2 arguments");
         return NULL;
     }
 
@@ -128,211 +303,83 @@ napi_value aws_napi_hash_digest(napi_env env, napi_callback_info info) {
         return NULL;
     }
 
-    size_t digest_size = hash->digest_size;
-    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
-
-        uint32_t truncate_to = 0;
-        if (napi_get_value_uint32(env, node_args[1], &truncate_to)) {
-            napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
-            return NULL;
-        }
-
-        if (digest_size > truncate_to) {
-            digest_size = truncate_to;
-        }
-    }
-
-    napi_value arraybuffer;
-    void *data = NULL;
-    if (napi_create_arraybuffer(env, digest_size, &data, &arraybuffer)) {
-        napi_throw_error(env, NULL, "Failed to create output arraybuffer");
+    struct digest_output output;
+    if (s_digest_output_init(env, &output, hash->digest_size, node_args[1], node_args[2], node_args[3])) {
         return NULL;
     }
 
-    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(data, digest_size);
-    if (aws_hash_finalize(hash, &out_buf, digest_size)) {
+    struct aws_byte_buf out_buf = s_digest_output_buf(&output);
+    if (aws_hash_finalize(hash, &out_buf, output.digest_size)) {
         aws_napi_throw_last_error(env);
         return NULL;
     }
 
-    napi_value dataview;
-    if (napi_create_dataview(env, digest_size, arraybuffer, 0, &dataview)) {
-        napi_throw_error(env, NULL, "Failed to create output dataview");
-        return NULL;
-    }
-
-    return dataview;
+    return s_digest_output_finish(env, &output);
 }
 
-napi_value aws_napi_hash_md5_compute(napi_env env, napi_callback_info info) {
+typedef int(hash_compute_fn)(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *input,
+    struct aws_byte_buf *output,
+    size_t truncate_to);
 
-    napi_value node_args[2];
+static napi_value s_hash_compute(
+    napi_env env,
+    napi_callback_info info,
+    hash_compute_fn *compute_fn,
+    size_t digest_size,
+    const char *name) {
+
+    napi_value node_args[4];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retreive callback information");
         return NULL;
     }
-    if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "hash_md5_compute needs exactly 2 arguments");
+    /* output and offset are optional, napi fills in undefined for them */
+    if (num_args < 2) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s needs at least 2 arguments", name);
+        napi_throw_error(env, NULL, message);
         return NULL;
     }
 
-    struct aws_byte_buf to_hash;
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[0])) {
-        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
+    struct digest_output output;
+    if (s_digest_output_init(env, &output, digest_size, node_args[1], node_args[2], node_args[3])) {
         return NULL;
     }
 
-    size_t digest_size = AWS_MD5_LEN;
-    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
-
-        uint32_t truncate_to = 0;
-        if (napi_get_value_uint32(env, node_args[1], &truncate_to)) {
-            napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
-            return NULL;
-        }
-
-        if (digest_size > truncate_to) {
-            digest_size = truncate_to;
-        }
-    }
-
-    napi_value arraybuffer;
-    void *data = NULL;
-    if (napi_create_arraybuffer(env, digest_size, &data, &arraybuffer)) {
-        napi_throw_error(env, NULL, "Failed to create output arraybuffer");
+    uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
+    struct aws_byte_buf to_hash;
+    if (aws_byte_buf_init_from_napi_with_storage(
+            &to_hash, env, node_args[0], to_hash_storage, sizeof(to_hash_storage))) {
+        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
         return NULL;
     }
 
     struct aws_byte_cursor to_hash_cur = aws_byte_cursor_from_buf(&to_hash);
-    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(data, digest_size);
-    if (aws_md5_compute(aws_napi_get_allocator(), &to_hash_cur, &out_buf, digest_size)) {
-        aws_napi_throw_last_error(env);
-    }
+    struct aws_byte_buf out_buf = s_digest_output_buf(&output);
+    int compute_result = compute_fn(aws_napi_get_allocator(), &to_hash_cur, &out_buf, output.digest_size);
+    aws_byte_buf_clean_up(&to_hash);
 
-    napi_value dataview;
-    if (napi_create_dataview(env, digest_size, arraybuffer, 0, &dataview)) {
-        napi_throw_error(env, NULL, "Failed to create output dataview");
+    if (compute_result) {
+        aws_napi_throw_last_error(env);
         return NULL;
     }
 
-    aws_byte_buf_clean_up(&to_hash);
+    return s_digest_output_finish(env, &output);
+}
 
-    return dataview;
+napi_value aws_napi_hash_md5_compute(napi_env env, napi_callback_info info) {
+    return s_hash_compute(env, info, aws_md5_compute, AWS_MD5_LEN, "hash_md5_compute");
 }
 
 napi_value aws_napi_hash_sha256_compute(napi_env env, napi_callback_info info) {
-
-    napi_value node_args[2];
-    size_t num_args = AWS_ARRAY_SIZE(node_args);
-    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
-        napi_throw_error(env, NULL, "Failed to retreive callback information");
-        return NULL;
-    }
-    if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "hash_sha256_compute needs exactly 2 arguments");
-        return NULL;
-    }
-
-    struct aws_byte_buf to_hash;
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[0])) {
-        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
-        return NULL;
-    }
-
-    size_t digest_size = AWS_MD5_LEN;
-    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
-
-        uint32_t truncate_to = 0;
-        if (napi_get_value_uint32(env, node_args[1], &truncate_to)) {
-            napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
-            return NULL;
-        }
-
-        if (digest_size > truncate_to) {
-            digest_size = truncate_to;
-        }
-    }
-
-    napi_value arraybuffer;
-    void *data = NULL;
-    if (napi_create_arraybuffer(env, digest_size, &data, &arraybuffer)) {
-        napi_throw_error(env, NULL, "Failed to create output arraybuffer");
-        return NULL;
-    }
-
-    struct aws_byte_cursor to_hash_cur = aws_byte_cursor_from_buf(&to_hash);
-    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(data, digest_size);
-    if (aws_sha256_compute(aws_napi_get_allocator(), &to_hash_cur, &out_buf, digest_size)) {
-        aws_napi_throw_last_error(env);
-    }
-
-    napi_value dataview;
-    if (napi_create_dataview(env, digest_size, arraybuffer, 0, &dataview)) {
-        napi_throw_error(env, NULL, "Failed to create output dataview");
-        return NULL;
-    }
-
-    aws_byte_buf_clean_up(&to_hash);
-
-    return dataview;
+    return s_hash_compute(env, info, aws_sha256_compute, AWS_SHA256_LEN, "hash_sha256_compute");
 }
 
 napi_value aws_napi_hash_sha1_compute(napi_env env, napi_callback_info info) {
-
-    napi_value node_args[2];
-    size_t num_args = AWS_ARRAY_SIZE(node_args);
-    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
-        napi_throw_error(env, NULL, "Failed to retreive callback information");
-        return NULL;
-    }
-    if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "hash_sha1_compute needs exactly 2 arguments");
-        return NULL;
-    }
-
-    struct aws_byte_buf to_hash;
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[0])) {
-        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
-        return NULL;
-    }
-
-    size_t digest_size = AWS_MD5_LEN;
-    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
-
-        uint32_t truncate_to = 0;
-        if (napi_get_value_uint32(env, node_args[1], &truncate_to)) {
-            napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
-            return NULL;
-        }
-
-        if (digest_size > truncate_to) {
-            digest_size = truncate_to;
-        }
-    }
-
-    napi_value arraybuffer;
-    void *data = NULL;
-    if (napi_create_arraybuffer(env, digest_size, &data, &arraybuffer)) {
-        napi_throw_error(env, NULL, "Failed to create output arraybuffer");
-        return NULL;
-    }
-
-    struct aws_byte_cursor to_hash_cur = aws_byte_cursor_from_buf(&to_hash);
-    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(data, digest_size);
-    if (aws_sha1_compute(aws_napi_get_allocator(), &to_hash_cur, &out_buf, digest_size)) {
-        aws_napi_throw_last_error(env);
-    }
-
-    napi_value dataview;
-    if (napi_create_dataview(env, digest_size, arraybuffer, 0, &dataview)) {
-        napi_throw_error(env, NULL, "Failed to create output dataview");
-        return NULL;
-    }
-
-    aws_byte_buf_clean_up(&to_hash);
-
-    return dataview;
+    return s_hash_compute(env, info, aws_sha1_compute, AWS_SHA1_LEN, "hash_sha1_compute");
 }
 
 /*******************************************************************************
@@ -408,8 +455,10 @@ napi_value aws_napi_hmac_update(napi_env env, napi_callback_info info) {
         return NULL;
     }
 
+    uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
     struct aws_byte_buf to_hash;
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[1])) {
+    if (aws_byte_buf_init_from_napi_with_storage(
+            &to_hash, env, node_args[1], to_hash_storage, sizeof(to_hash_storage))) {
         napi_throw_type_error(env, NULL, "to_hmac argument must be a string or array");
         return NULL;
     }
@@ -426,14 +475,15 @@ napi_value aws_napi_hmac_update(napi_env env, napi_callback_info info) {
 
 napi_value aws_napi_hmac_digest(napi_env env, napi_callback_info info) {
 
-    napi_value node_args[2];
+    napi_value node_args[4];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retreive callback information");
         return NULL;
     }
-    if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "hmac_digest needs exactly 2 arguments");
+    /* output and offset are optional, napi fills in undefined for them */
+    if (num_args < 2) {
+        napi_throw_error(env, NULL, "hmac_digest needs at least 2 arguments");
         return NULL;
     }
 
@@ -443,102 +493,514 @@ napi_value aws_napi_hmac_digest(napi_env env, napi_callback_info info) {
         return NULL;
     }
 
-    size_t digest_size = hmac->digest_size;
-    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
+    struct digest_output output;
+    if (s_digest_output_init(env, &output, hmac->digest_size, node_args[1], node_args[2], node_args[3])) {
+        return NULL;
+    }
+
+    struct aws_byte_buf out_buf = s_digest_output_buf(&output);
+    if (aws_hmac_finalize(hmac, &out_buf, output.digest_size)) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
 
+    return s_digest_output_finish(env, &output);
+}
+
+napi_value aws_napi_hmac_sha256_compute(napi_env env, napi_callback_info info) {
+
+    napi_value node_args[5];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    /* output and offset are optional, napi fills in undefined for them */
+    if (num_args < 3) {
+        napi_throw_error(env, NULL, "hmac_sha256_compute needs at least 3 arguments");
+        return NULL;
+    }
+
+    struct digest_output output;
+    if (s_digest_output_init(env, &output, AWS_SHA256_HMAC_LEN, node_args[2], node_args[3], node_args[4])) {
+        return NULL;
+    }
+
+    struct aws_byte_buf secret;
+    if (aws_byte_buf_init_from_napi(&secret, env, node_args[0])) {
+        napi_throw_type_error(env, NULL, "secret argument must be a string or array");
+        return NULL;
+    }
+    struct aws_byte_cursor secret_cur = aws_byte_cursor_from_buf(&secret);
+
+    uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
+    struct aws_byte_buf to_hash;
+    if (aws_byte_buf_init_from_napi_with_storage(
+            &to_hash, env, node_args[1], to_hash_storage, sizeof(to_hash_storage))) {
+        aws_byte_buf_clean_up_secure(&secret);
+        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
+        return NULL;
+    }
+
+    struct aws_byte_cursor to_hash_cur = aws_byte_cursor_from_buf(&to_hash);
+    struct aws_byte_buf out_buf = s_digest_output_buf(&output);
+    int compute_result =
+        aws_sha256_hmac_compute(aws_napi_get_allocator(), &secret_cur, &to_hash_cur, &out_buf, output.digest_size);
+    aws_byte_buf_clean_up(&to_hash);
+    aws_byte_buf_clean_up_secure(&secret);
+
+    if (compute_result) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+
+    return s_digest_output_finish(env, &output);
+}
+
+/*******************************************************************************
+ * Async
+ ******************************************************************************/
+
+enum hash_async_op {
+    HASH_ASYNC_MD5_COMPUTE,
+    HASH_ASYNC_SHA1_COMPUTE,
+    HASH_ASYNC_SHA256_COMPUTE,
+    HASH_ASYNC_HMAC_SHA256_COMPUTE,
+    HASH_ASYNC_HASH_UPDATE,
+    HASH_ASYNC_HMAC_UPDATE,
+};
+
+/*
+ * A hash computed on the libuv thread pool. Buffers are borrowed from node and pinned by a reference until the work
+ * completes; strings have to be converted, so those are copied. Nothing here may touch the env from execute().
+ */
+struct hash_async_job {
+    struct aws_allocator *allocator;
+    enum hash_async_op op;
+    napi_async_work work;
+
+    napi_ref node_data;
+    napi_ref node_handle;
+    napi_ref on_complete;
+
+    struct aws_byte_buf data;
+    struct aws_byte_buf secret;
+    struct aws_hash *hash;
+    struct aws_hmac *hmac;
+
+    uint8_t digest_storage[AWS_SHA256_LEN];
+    size_t digest_size;
+    int error_code;
+};
+
+static void s_hash_async_job_destroy(napi_env env, struct hash_async_job *job) {
+    if (job->node_data) {
+        napi_delete_reference(env, job->node_data);
+    }
+    if (job->node_handle) {
+        napi_delete_reference(env, job->node_handle);
+    }
+    if (job->on_complete) {
+        napi_delete_reference(env, job->on_complete);
+    }
+    if (job->work) {
+        napi_delete_async_work(env, job->work);
+    }
+
+    /* borrowed buffers have no allocator, so this only frees copies */
+    aws_byte_buf_clean_up(&job->data);
+    aws_byte_buf_clean_up_secure(&job->secret);
+    aws_mem_release(job->allocator, job);
+}
+
+static void s_hash_async_execute(napi_env env, void *user_data) {
+    (void)env;
+    struct hash_async_job *job = user_data;
+
+    struct aws_byte_cursor data_cur = aws_byte_cursor_from_buf(&job->data);
+    struct aws_byte_cursor secret_cur = aws_byte_cursor_from_buf(&job->secret);
+    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(job->digest_storage, job->digest_size);
+
+    int result = AWS_OP_SUCCESS;
+    switch (job->op) {
+        case HASH_ASYNC_MD5_COMPUTE:
+            result = aws_md5_compute(job->allocator, &data_cur, &out_buf, job->digest_size);
+            break;
+        case HASH_ASYNC_SHA1_COMPUTE:
+            result = aws_sha1_compute(job->allocator, &data_cur, &out_buf, job->digest_size);
+            break;
+        case HASH_ASYNC_SHA256_COMPUTE:
+            result = aws_sha256_compute(job->allocator, &data_cur, &out_buf, job->digest_size);
+            break;
+        case HASH_ASYNC_HMAC_SHA256_COMPUTE:
+            result = aws_sha256_hmac_compute(job->allocator, &secret_cur, &data_cur, &out_buf, job->digest_size);
+            break;
+        case HASH_ASYNC_HASH_UPDATE:
+            result = aws_hash_update(job->hash, &data_cur);
+            break;
+        case HASH_ASYNC_HMAC_UPDATE:
+            result = aws_hmac_update(job->hmac, &data_cur);
+            break;
+    }
+
+    job->error_code = (result == AWS_OP_SUCCESS) ? AWS_ERROR_SUCCESS : aws_last_error();
+}
+
+static void s_hash_async_complete(napi_env env, napi_status status, void *user_data) {
+    struct hash_async_job *job = user_data;
+
+    if (status != napi_ok && job->error_code == AWS_ERROR_SUCCESS) {
+        job->error_code = AWS_ERROR_UNKNOWN;
+    }
+
+    napi_value params[2];
+    const size_t num_params = AWS_ARRAY_SIZE(params);
+    AWS_NAPI_ENSURE(env, napi_create_uint32(env, job->error_code, &params[0]));
+    AWS_NAPI_ENSURE(env, napi_get_undefined(env, &params[1]));
+
+    bool is_compute = job->op != HASH_ASYNC_HASH_UPDATE && job->op != HASH_ASYNC_HMAC_UPDATE;
+    if (is_compute && job->error_code == AWS_ERROR_SUCCESS) {
+        napi_value arraybuffer = NULL;
+        void *data = NULL;
+        AWS_NAPI_CALL(env, napi_create_arraybuffer(env, job->digest_size, &data, &arraybuffer), { goto done; });
+        memcpy(data, job->digest_storage, job->digest_size);
+        AWS_NAPI_CALL(env, napi_create_dataview(env, job->digest_size, arraybuffer, 0, &params[1]), { goto done; });
+    }
+
+    napi_value on_complete = NULL;
+    napi_value node_this = NULL;
+    AWS_NAPI_CALL(env, napi_get_reference_value(env, job->on_complete, &on_complete), { goto done; });
+    AWS_NAPI_CALL(env, napi_get_undefined(env, &node_this), { goto done; });
+    napi_call_function(env, node_this, on_complete, num_params, params, NULL);
+
+done:
+    s_hash_async_job_destroy(env, job);
+}
+
+/*
+ * Sets up a job from its data and completion callback arguments. If this fails, an exception has been thrown and NULL
+ * is returned.
+ */
+static struct hash_async_job *s_hash_async_job_new(
+    napi_env env,
+    enum hash_async_op op,
+    napi_value node_data,
+    napi_value node_on_complete) {
+
+    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct hash_async_job *job = aws_mem_calloc(allocator, 1, sizeof(struct hash_async_job));
+    if (!job) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+    job->allocator = allocator;
+    job->op = op;
+
+    napi_valuetype type = napi_undefined;
+    if (napi_typeof(env, node_on_complete, &type) || type != napi_function) {
+        napi_throw_type_error(env, NULL, "on_complete argument must be a function");
+        goto error;
+    }
+    AWS_NAPI_CALL(env, napi_create_reference(env, node_on_complete, 1, &job->on_complete), {
+        napi_throw_error(env, NULL, "Failed to reference on_complete");
+        goto error;
+    });
+
+    if (aws_byte_buf_init_from_napi(&job->data, env, node_data)) {
+        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
+        goto error;
+    }
+
+    /* a buffer without an allocator is node's memory, keep it alive until the hash is done with it */
+    if (job->data.allocator == NULL) {
+        AWS_NAPI_CALL(env, napi_create_reference(env, node_data, 1, &job->node_data), {
+            napi_throw_error(env, NULL, "Failed to reference to_hash");
+            goto error;
+        });
+    }
+
+    return job;
+
+error:
+    s_hash_async_job_destroy(env, job);
+    return NULL;
+}
+
+/* Applies truncate_to to the digest size of the job's algorithm, throwing and returning AWS_OP_ERR if it's invalid */
+static int s_hash_async_job_set_digest_size(
+    napi_env env,
+    struct hash_async_job *job,
+    size_t digest_size,
+    napi_value node_truncate_to) {
+
+    if (!aws_napi_is_null_or_undefined(env, node_truncate_to)) {
         uint32_t truncate_to = 0;
-        if (napi_get_value_uint32(env, node_args[1], &truncate_to)) {
+        if (napi_get_value_uint32(env, node_truncate_to, &truncate_to)) {
             napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
-            return NULL;
+            return AWS_OP_ERR;
         }
 
-        if (digest_size > truncate_to) {
+        if (truncate_to && digest_size > truncate_to) {
             digest_size = truncate_to;
         }
     }
 
-    napi_value arraybuffer;
-    void *data = NULL;
-    if (napi_create_arraybuffer(env, digest_size, &data, &arraybuffer)) {
-        napi_throw_error(env, NULL, "Failed to create output arraybuffer");
+    job->digest_size = digest_size;
+    return AWS_OP_SUCCESS;
+}
+
+static napi_value s_hash_async_job_queue(napi_env env, struct hash_async_job *job) {
+    napi_value resource_name = NULL;
+    AWS_NAPI_CALL(env, napi_create_string_utf8(env, "aws_hash_async", NAPI_AUTO_LENGTH, &resource_name), {
+        napi_throw_error(env, NULL, "Failed to create async work resource name");
+        goto error;
+    });
+
+    AWS_NAPI_CALL(
+        env,
+        napi_create_async_work(
+            env, NULL, resource_name, s_hash_async_execute, s_hash_async_complete, job, &job->work),
+        {
+            napi_throw_error(env, NULL, "Failed to create async hash work");
+            goto error;
+        });
+
+    AWS_NAPI_CALL(env, napi_queue_async_work(env, job->work), {
+        napi_throw_error(env, NULL, "Failed to queue async hash work");
+        goto error;
+    });
+
+    return NULL;
+
+error:
+    s_hash_async_job_destroy(env, job);
+    return NULL;
+}
+
+static napi_value s_hash_compute_async(
+    napi_env env,
+    napi_callback_info info,
+    enum hash_async_op op,
+    size_t digest_size,
+    const char *name) {
+
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s needs exactly 3 arguments", name);
+        napi_throw_error(env, NULL, message);
         return NULL;
     }
 
-    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(data, digest_size);
-    if (aws_hmac_finalize(hmac, &out_buf, digest_size)) {
-        aws_napi_throw_last_error(env);
+    struct hash_async_job *job = s_hash_async_job_new(env, op, node_args[0], node_args[2]);
+    if (!job) {
         return NULL;
     }
 
-    napi_value dataview;
-    if (napi_create_dataview(env, digest_size, arraybuffer, 0, &dataview)) {
-        napi_throw_error(env, NULL, "Failed to create output dataview");
+    if (s_hash_async_job_set_digest_size(env, job, digest_size, node_args[1])) {
+        s_hash_async_job_destroy(env, job);
         return NULL;
     }
 
-    return dataview;
+    return s_hash_async_job_queue(env, job);
 }
 
-napi_value aws_napi_hmac_sha256_compute(napi_env env, napi_callback_info info) {
+napi_value aws_napi_hash_md5_compute_async(napi_env env, napi_callback_info info) {
+    return s_hash_compute_async(env, info, HASH_ASYNC_MD5_COMPUTE, AWS_MD5_LEN, "hash_md5_compute_async");
+}
 
-    napi_value node_args[3];
+napi_value aws_napi_hash_sha1_compute_async(napi_env env, napi_callback_info info) {
+    return s_hash_compute_async(env, info, HASH_ASYNC_SHA1_COMPUTE, AWS_SHA1_LEN, "hash_sha1_compute_async");
+}
+
+napi_value aws_napi_hash_sha256_compute_async(napi_env env, napi_callback_info info) {
+    return s_hash_compute_async(env, info, HASH_ASYNC_SHA256_COMPUTE, AWS_SHA256_LEN, "hash_sha256_compute_async");
+}
+
+napi_value aws_napi_hmac_sha256_compute_async(napi_env env, napi_callback_info info) {
+
+    napi_value node_args[4];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retreive callback information");
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "hmac_sha256_compute needs exactly 3 arguments");
+        napi_throw_error(env, NULL, "hmac_sha256_compute_async needs exactly 4 arguments");
         return NULL;
     }
 
+    struct hash_async_job *job = s_hash_async_job_new(env, HASH_ASYNC_HMAC_SHA256_COMPUTE, node_args[1], node_args[3]);
+    if (!job) {
+        return NULL;
+    }
+
+    /* the secret is always copied, so that it can be scrubbed once the job is done */
     struct aws_byte_buf secret;
     if (aws_byte_buf_init_from_napi(&secret, env, node_args[0])) {
         napi_throw_type_error(env, NULL, "secret argument must be a string or array");
-        return NULL;
+        goto error;
     }
     struct aws_byte_cursor secret_cur = aws_byte_cursor_from_buf(&secret);
+    int copy_result = aws_byte_buf_init_copy_from_cursor(&job->secret, job->allocator, secret_cur);
+    aws_byte_buf_clean_up(&secret);
+    if (copy_result) {
+        aws_napi_throw_last_error(env);
+        goto error;
+    }
 
-    struct aws_byte_buf to_hash;
-    if (aws_byte_buf_init_from_napi(&to_hash, env, node_args[1])) {
-        napi_throw_type_error(env, NULL, "to_hash argument must be a string or array");
+    if (s_hash_async_job_set_digest_size(env, job, AWS_SHA256_HMAC_LEN, node_args[2])) {
+        goto error;
+    }
+
+    return s_hash_async_job_queue(env, job);
+
+error:
+    s_hash_async_job_destroy(env, job);
+    return NULL;
+}
+
+static napi_value s_hash_update_async(napi_env env, napi_callback_info info, enum hash_async_op op, const char *name) {
+
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s needs exactly 3 arguments", name);
+        napi_throw_error(env, NULL, message);
         return NULL;
     }
 
-    size_t digest_size = AWS_MD5_LEN;
-    if (!aws_napi_is_null_or_undefined(env, node_args[2])) {
+    void *handle = NULL;
+    if (napi_get_value_external(env, node_args[0], &handle)) {
+        napi_throw_error(env, NULL, "Failed to extract hash from first argument");
+        return NULL;
+    }
 
-        uint32_t truncate_to = 0;
-        if (napi_get_value_uint32(env, node_args[2], &truncate_to)) {
-            napi_throw_type_error(env, NULL, "truncate_to argument must be undefined or a positive number");
-            return NULL;
-        }
+    struct hash_async_job *job = s_hash_async_job_new(env, op, node_args[1], node_args[2]);
+    if (!job) {
+        return NULL;
+    }
 
-        if (digest_size > truncate_to) {
-            digest_size = truncate_to;
-        }
+    if (op == HASH_ASYNC_HASH_UPDATE) {
+        job->hash = handle;
+    } else {
+        job->hmac = handle;
     }
 
-    napi_value arraybuffer;
-    void *data = NULL;
-    if (napi_create_arraybuffer(env, digest_size, &data, &arraybuffer)) {
-        napi_throw_error(env, NULL, "Failed to create output arraybuffer");
+    /* the hash must not be finalized out from under the work */
+    AWS_NAPI_CALL(env, napi_create_reference(env, node_args[0], 1, &job->node_handle), {
+        napi_throw_error(env, NULL, "Failed to reference hash");
+        s_hash_async_job_destroy(env, job);
+        return NULL;
+    });
+
+    return s_hash_async_job_queue(env, job);
+}
+
+napi_value aws_napi_hash_update_async(napi_env env, napi_callback_info info) {
+    return s_hash_update_async(env, info, HASH_ASYNC_HASH_UPDATE, "hash_update_async");
+}
+
+napi_value aws_napi_hmac_update_async(napi_env env, napi_callback_info info) {
+    return s_hash_update_async(env, info, HASH_ASYNC_HMAC_UPDATE, "hmac_update_async");
+}
+
+/*******************************************************************************
+ * Batch
+ ******************************************************************************/
+
+napi_value aws_napi_hash_sha256_many(napi_env env, napi_callback_info info) {
+
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "hash_sha256_many needs exactly 2 arguments");
         return NULL;
     }
 
-    struct aws_byte_cursor to_hash_cur = aws_byte_cursor_from_buf(&to_hash);
-    struct aws_byte_buf out_buf = aws_byte_buf_from_empty_array(data, digest_size);
-    if (aws_sha256_hmac_compute(aws_napi_get_allocator(), &secret_cur, &to_hash_cur, &out_buf, digest_size)) {
-        aws_napi_throw_last_error(env);
+    bool is_array = false;
+    if (napi_is_array(env, node_args[0], &is_array) || !is_array) {
+        napi_throw_type_error(env, NULL, "to_hash argument must be an array");
+        return NULL;
     }
 
-    napi_value dataview;
-    if (napi_create_dataview(env, digest_size, arraybuffer, 0, &dataview)) {
-        napi_throw_error(env, NULL, "Failed to create output dataview");
+    uint32_t count = 0;
+    AWS_NAPI_CALL(env, napi_get_array_length(env, node_args[0], &count), {
+        napi_throw_error(env, NULL, "Failed to get length of to_hash");
         return NULL;
+    });
+    const size_t output_size = (size_t)count * AWS_SHA256_LEN;
+
+    /* digests go into the caller's buffer if there is one, otherwise into a single new one */
+    napi_value result = NULL;
+    uint8_t *output = NULL;
+    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
+        /* init leaves the buffer untouched for values that aren't strings or buffers, so it must start out empty */
+        struct aws_byte_buf out_buf;
+        AWS_ZERO_STRUCT(out_buf);
+        if (aws_byte_buf_init_from_napi(&out_buf, env, node_args[1]) || out_buf.allocator != NULL) {
+            aws_byte_buf_clean_up(&out_buf);
+            napi_throw_type_error(env, NULL, "out argument must be undefined, an ArrayBuffer or an ArrayBufferView");
+            return NULL;
+        }
+        if (out_buf.len < output_size) {
+            napi_throw_range_error(env, NULL, "out argument is too small to hold every digest");
+            return NULL;
+        }
+        output = out_buf.buffer;
+        result = node_args[1];
+    } else {
+        napi_value arraybuffer = NULL;
+        if (napi_create_arraybuffer(env, output_size, (void **)&output, &arraybuffer)) {
+            napi_throw_error(env, NULL, "Failed to create output arraybuffer");
+            return NULL;
+        }
+        if (napi_create_dataview(env, output_size, arraybuffer, 0, &result)) {
+            napi_throw_error(env, NULL, "Failed to create output dataview");
+            return NULL;
+        }
     }
 
-    aws_byte_buf_clean_up(&to_hash);
+    struct aws_allocator *allocator = aws_napi_get_allocator();
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value node_element = NULL;
+        AWS_NAPI_CALL(env, napi_get_element(env, node_args[0], i, &node_element), {
+            napi_throw_error(env, NULL, "Failed to get element of to_hash");
+            return NULL;
+        });
+
+        uint8_t to_hash_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
+        struct aws_byte_buf to_hash;
+        if (aws_byte_buf_init_from_napi_with_storage(
+                &to_hash, env, node_element, to_hash_storage, sizeof(to_hash_storage))) {
+            napi_throw_type_error(env, NULL, "to_hash elements must be strings or arrays");
+            return NULL;
+        }
+
+        struct aws_byte_cursor to_hash_cur = aws_byte_cursor_from_buf(&to_hash);
+        struct aws_byte_buf digest = aws_byte_buf_from_empty_array(output + (size_t)i * AWS_SHA256_LEN, AWS_SHA256_LEN);
+        int hash_result = aws_sha256_compute(allocator, &to_hash_cur, &digest, 0);
+        aws_byte_buf_clean_up(&to_hash);
+
+        if (hash_result) {
+            aws_napi_throw_last_error(env);
+            return NULL;
+        }
+    }
 
-    return dataview;
+    return result;
 }
@@ -25,6 +25,23 @@ napi_value aws_napi_hmac_digest(napi_env env, napi_callback_info info);
 
 napi_value aws_napi_hmac_sha256_compute(napi_env env, napi_callback_info info);
 
+/*
+ * Same as the functions above, but hash on the libuv thread pool and report the result through a completion callback.
+ * Buffer inputs are not copied, so they must not be modified until the callback is invoked.
+ */
+napi_value aws_napi_hash_md5_compute_async(napi_env env, napi_callback_info info);
+napi_value aws_napi_hash_sha1_compute_async(napi_env env, napi_callback_info info);
+napi_value aws_napi_hash_sha256_compute_async(napi_env env, napi_callback_info info);
+napi_value aws_napi_hmac_sha256_compute_async(napi_env env, napi_callback_info info);
+napi_value aws_napi_hash_update_async(napi_env env, napi_callback_info info);
+napi_value aws_napi_hmac_update_async(napi_env env, napi_callback_info info);
+
+/*
+ * Computes the SHA256 digest of every element of an array in one call, writing them back to back into a single output
+ * buffer
+ */
+napi_value aws_napi_hash_sha256_many(napi_env env, napi_callback_info info);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_CRT_NODEJS_CRYTPO_H */
@@ -605,7 +605,7 @@ static int s_aws_create_napi_header_value(
     napi_value *napi_header_out) {
 
     napi_value napi_header = NULL;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
 
     AWS_NAPI_CALL(
         env, napi_create_object(env, &napi_header), { return aws_raise_error(AWS_CRT_NODEJS_ERROR_NAPI_FAILURE); });
@@ -789,6 +789,7 @@ static int s_aws_create_napi_value_from_event_stream_message_storage(
 }
 
 struct aws_event_stream_protocol_message_event {
+    /* allocator for the message storage, the struct itself comes from the small object allocator */
     struct aws_allocator *allocator;
     struct aws_event_stream_message_storage storage;
     struct aws_event_stream_client_connection_binding *binding;
@@ -802,7 +803,7 @@ static void s_aws_event_stream_protocol_message_event_destroy(struct aws_event_s
     s_aws_event_stream_message_storage_clean_up(&event->storage);
     s_aws_event_stream_client_connection_binding_release(event->binding);
 
-    aws_mem_release(event->allocator, event);
+    aws_mem_release(aws_napi_get_small_object_allocator(), event);
 }
 
 static void s_napi_event_stream_connection_on_protocol_message(
@@ -859,9 +860,9 @@ static void s_aws_event_stream_rpc_client_connection_protocol_message_fn(
     void *user_data) {
     (void)connection;
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
-    struct aws_event_stream_protocol_message_event *event =
-        aws_mem_calloc(allocator, 1, sizeof(struct aws_event_stream_protocol_message_event));
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
+    struct aws_event_stream_protocol_message_event *event = aws_mem_calloc(
+        aws_napi_get_small_object_allocator(), 1, sizeof(struct aws_event_stream_protocol_message_event));
 
     event->allocator = allocator;
     event->binding = s_aws_event_stream_client_connection_binding_acquire(
@@ -922,7 +923,7 @@ napi_value aws_napi_event_stream_client_connection_new(napi_env env, napi_callba
 
     napi_value node_connection_ref = NULL;
     napi_value node_external = NULL;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
 
     struct aws_event_stream_client_connection_binding *binding =
         aws_mem_calloc(allocator, 1, sizeof(struct aws_event_stream_client_connection_binding));
@@ -1167,7 +1168,7 @@ static void s_aws_event_stream_rpc_client_on_connection_shutdown_fn(
     int error_code,
     void *user_data) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
     struct aws_event_stream_client_connection_binding *binding = user_data;
 
     struct aws_event_stream_connection_event_data *shutdown_data =
@@ -1280,7 +1281,7 @@ static void s_aws_event_stream_rpc_client_on_connection_setup_fn(
     int error_code,
     void *user_data) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
     struct aws_event_stream_client_connection_binding *binding = user_data;
 
     struct aws_event_stream_connection_event_data *setup_data =
@@ -1303,7 +1304,7 @@ static void s_aws_event_stream_rpc_client_on_connection_setup_fn(
 }
 
 napi_value aws_napi_event_stream_client_connection_connect(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
 
     napi_value node_args[2];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
@@ -1449,7 +1450,7 @@ static void s_aws_event_stream_on_protocol_message_flushed(int error_code, void
 }
 
 napi_value aws_napi_event_stream_client_connection_send_protocol_message(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
 
     struct aws_event_stream_message_storage message_storage;
     AWS_ZERO_STRUCT(message_storage);
@@ -1734,6 +1735,7 @@ static void s_event_stream_on_stream_ended(
 }
 
 struct aws_event_stream_stream_message_event {
+    /* allocator for the message storage, the struct itself comes from the small object allocator */
     struct aws_allocator *allocator;
     struct aws_event_stream_message_storage storage;
     struct aws_event_stream_client_stream_binding *binding;
@@ -1747,7 +1749,7 @@ static void s_aws_event_stream_stream_message_event_destroy(struct aws_event_str
     s_aws_event_stream_message_storage_clean_up(&event->storage);
     s_aws_event_stream_client_stream_binding_release(event->binding);
 
-    aws_mem_release(event->allocator, event);
+    aws_mem_release(aws_napi_get_small_object_allocator(), event);
 }
 
 static void s_napi_event_stream_on_stream_message(napi_env env, napi_value function, void *context, void *user_data) {
@@ -1800,9 +1802,9 @@ static void s_event_stream_on_stream_message(
 
     (void)stream;
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
     struct aws_event_stream_stream_message_event *event =
-        aws_mem_calloc(allocator, 1, sizeof(struct aws_event_stream_stream_message_event));
+        aws_mem_calloc(aws_napi_get_small_object_allocator(), 1, sizeof(struct aws_event_stream_stream_message_event));
 
     event->allocator = allocator;
     event->binding =
@@ -1837,7 +1839,7 @@ napi_value aws_napi_event_stream_client_stream_new(napi_env env, napi_callback_i
 
     napi_value node_stream_ref = NULL;
     napi_value node_external = NULL;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
 
     struct aws_event_stream_client_stream_binding *binding =
         aws_mem_calloc(allocator, 1, sizeof(struct aws_event_stream_client_stream_binding));
@@ -2086,7 +2088,7 @@ done:
 }
 
 static void s_aws_event_stream_on_stream_activation_flush(int error_code, void *user_data) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
     struct aws_event_stream_client_stream_binding *binding = user_data;
 
     struct aws_event_stream_activation_event_data *activation_data =
@@ -2135,7 +2137,7 @@ static int s_aws_extract_activation_options_from_js(
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
     if (s_aws_event_stream_message_storage_init_from_js(
             activation_message, allocator, env, napi_activation_message, binding)) {
         AWS_LOGF_ERROR(
@@ -2307,7 +2309,7 @@ static void s_aws_event_stream_on_stream_message_flushed(int error_code, void *u
 }
 
 napi_value aws_napi_event_stream_client_stream_send_message(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_EVENT_STREAM);
 
     struct aws_event_stream_message_storage message_storage;
     AWS_ZERO_STRUCT(message_storage);
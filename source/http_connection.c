@@ -49,7 +49,7 @@ napi_value aws_napi_http_proxy_options_new(napi_env env, napi_callback_info info
 
     napi_value node_external = NULL; /* return value, external that wraps the aws_tls_connection_options */
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
     struct http_proxy_options_binding *binding =
         aws_mem_calloc(allocator, 1, sizeof(struct http_proxy_options_binding));
     AWS_FATAL_ASSERT(binding && "Failed to allocate new http_proxy_options_binding");
@@ -161,15 +161,15 @@ struct aws_http_connection *aws_napi_get_http_connection(struct http_connection_
 }
 
 napi_value aws_napi_http_connection_from_manager(napi_env env, struct aws_http_connection *connection) {
-    struct http_connection_binding *binding =
-        aws_mem_calloc(aws_napi_get_allocator(), 1, sizeof(struct http_connection_binding));
+    struct http_connection_binding *binding = aws_mem_calloc(
+        aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP), 1, sizeof(struct http_connection_binding));
     if (!binding) {
         aws_napi_throw_last_error(env);
         return NULL;
     }
     binding->env = env;
     binding->connection = connection;
-    binding->allocator = aws_napi_get_allocator();
+    binding->allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
 
     napi_value node_external = NULL;
     AWS_NAPI_CALL(
@@ -177,7 +177,7 @@ napi_value aws_napi_http_connection_from_manager(napi_env env, struct aws_http_c
         napi_create_external(env, binding, s_http_connection_from_manager_binding_finalize, NULL, &node_external),
         {
             napi_throw_error(env, NULL, "Unable to create external for managed connection");
-            aws_mem_release(aws_napi_get_allocator(), binding);
+            aws_mem_release(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP), binding);
             return NULL;
         });
     return node_external;
@@ -265,7 +265,7 @@ static void s_http_connection_binding_finalize(napi_env env, void *finalize_data
 }
 
 napi_value aws_napi_http_connection_new(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
 
     napi_value result = NULL;
     struct aws_tls_connection_options *tls_opts = NULL;
@@ -36,6 +36,7 @@ napi_status aws_napi_http_headers_bind(napi_env env, napi_value exports) {
 
         .num_arguments = 0,
         .arg_types = {napi_object},
+        .libraries = AWS_NAPI_LIBRARY_HTTP,
     };
 
     static const struct aws_napi_property_info s_headers_properties[] = {
@@ -54,56 +55,66 @@ napi_status aws_napi_http_headers_bind(napi_env env, napi_value exports) {
             .method = s_headers_get,
             .num_arguments = 1,
             .arg_types = {napi_string},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "get_values",
             .method = s_headers_get_values,
             .num_arguments = 1,
             .arg_types = {napi_string},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "get_index",
             .method = s_headers_get_index,
             .num_arguments = 1,
             .arg_types = {napi_number},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .symbol = "iterator",
             .method = s_headers__iterator,
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "add",
             .method = s_headers_add_header,
             .num_arguments = 2,
             .arg_types = {napi_string, napi_string},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "set",
             .method = s_headers_set_header,
             .num_arguments = 2,
             .arg_types = {napi_string, napi_string},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "remove",
             .method = s_headers_remove,
             .num_arguments = 1,
             .arg_types = {napi_string},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "remove_value",
             .method = s_headers_remove_value,
             .num_arguments = 2,
             .arg_types = {napi_string, napi_string},
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "clear",
             .method = s_headers_clear,
             .num_arguments = 0,
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
         {
             .name = "_flatten",
             .method = s_headers__flatten,
             .num_arguments = 0,
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
     };
 
@@ -125,6 +136,7 @@ napi_status aws_napi_http_headers_bind(napi_env env, napi_value exports) {
             .utf8name = "next",
             .method = s_iterator_next,
             .attributes = napi_enumerable,
+            .libraries = AWS_NAPI_LIBRARY_HTTP,
         },
     };
 
@@ -172,7 +184,7 @@ struct aws_http_headers *aws_napi_http_headers_unwrap(napi_env env, napi_value j
 
 static napi_value s_headers_constructor(napi_env env, const struct aws_napi_callback_info *cb_info) {
 
-    struct aws_allocator *alloc = aws_napi_get_allocator();
+    struct aws_allocator *alloc = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
     struct aws_http_headers *headers = aws_http_headers_new(alloc);
     const struct aws_napi_argument *arg = NULL;
 
@@ -510,7 +522,7 @@ static napi_value s_iterator_ctor(napi_env env, napi_callback_info info) {
     napi_value node_this = NULL;
     napi_get_cb_info(env, info, &num_args, &native_headers, &node_this, NULL);
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
 
     /* Make and wrap an iterator object */
     struct headers_iterator *iterator = aws_mem_calloc(allocator, 1, sizeof(struct headers_iterator));
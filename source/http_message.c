@@ -27,6 +27,7 @@ napi_status aws_napi_http_message_bind(napi_env env, napi_value exports) {
         .method = s_request_constructor,
         .num_arguments = 2,
         .arg_types = {napi_string, napi_string, napi_object, napi_external},
+        .libraries = AWS_NAPI_LIBRARY_HTTP,
     };
 
     static const struct aws_napi_property_info s_request_properties[] = {
@@ -98,9 +99,9 @@ static void s_napi_wrapped_http_request_finalize(napi_env env, void *finalize_da
 napi_status aws_napi_http_message_wrap(napi_env env, struct aws_http_message *message, napi_value *result) {
 
     struct http_request_binding *binding =
-        aws_mem_calloc(aws_napi_get_allocator(), 1, sizeof(struct http_request_binding));
+        aws_mem_calloc(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP), 1, sizeof(struct http_request_binding));
     binding->native = message;
-    binding->allocator = aws_napi_get_allocator();
+    binding->allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
     return aws_napi_wrap(env, &s_request_class_info, binding, s_napi_wrapped_http_request_finalize, result);
 }
 
@@ -131,7 +132,7 @@ static void s_napi_http_request_finalize(napi_env env, void *finalize_data, void
 
 static napi_value s_request_constructor(napi_env env, const struct aws_napi_callback_info *cb_info) {
 
-    struct aws_allocator *alloc = aws_napi_get_allocator();
+    struct aws_allocator *alloc = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
     struct http_request_binding *binding = aws_mem_calloc(alloc, 1, sizeof(struct http_request_binding));
     if (!binding) {
         aws_napi_throw_last_error(env);
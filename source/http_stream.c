@@ -8,6 +8,7 @@
 #include "http_message.h"
 
 #include <aws/common/atomics.h>
+#include <aws/common/linked_list.h>
 #include <aws/http/request_response.h>
 #include <aws/io/stream.h>
 
@@ -21,7 +22,7 @@ struct http_stream_binding {
     napi_ref node_external;
     napi_threadsafe_function on_complete;
     napi_threadsafe_function on_response;
-    napi_threadsafe_function on_body;
+    struct aws_napi_threadsafe_batch *on_body;
     struct aws_http_message *response; /* used to buffer response headers/status code */
     struct aws_http_message *request;
 
@@ -92,7 +93,7 @@ static int s_on_response_headers(
     }
 
     if (!binding->response) {
-        binding->response = aws_http_message_new_response(aws_napi_get_allocator());
+        binding->response = aws_http_message_new_response(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP));
     }
     return aws_http_message_add_header_array(binding->response, header_array, num_headers);
 }
@@ -114,8 +115,10 @@ static int s_on_response_header_block_done(
 }
 
 struct on_body_args {
+    struct aws_linked_list_node node;
     struct http_stream_binding *binding;
     struct aws_byte_buf chunk;
+    /* allocator for this struct, the chunk tracks its own */
     struct aws_allocator *allocator;
 };
 
@@ -127,25 +130,33 @@ static void s_external_arraybuffer_finalizer(napi_env env, void *finalize_data,
     aws_mem_release(args->allocator, args);
 }
 
-static void s_on_body_call(napi_env env, napi_value on_body, void *context, void *user_data) {
-    struct http_stream_binding *binding = context;
-    struct on_body_args *args = user_data;
+/* Only used when the stream is being torn down, so the binding may already be gone */
+static void s_on_body_args_destroy(struct aws_linked_list_node *item, void *user_data) {
+    (void)user_data;
+    struct on_body_args *args = AWS_CONTAINER_OF(item, struct on_body_args, node);
 
-    /* Callback is invoked for nodejs, update pending length */
-    aws_atomic_fetch_sub(&binding->pending_length, args->chunk.len);
+    aws_byte_buf_clean_up(&args->chunk);
+    aws_mem_release(args->allocator, args);
+}
 
-    if (env) {
-        napi_value params[1];
-        const size_t num_params = AWS_ARRAY_SIZE(params);
+static int s_on_body_args_to_js(
+    napi_env env,
+    struct aws_linked_list_node *item,
+    void *user_data,
+    napi_value *result) {
+    struct http_stream_binding *binding = user_data;
+    struct on_body_args *args = AWS_CONTAINER_OF(item, struct on_body_args, node);
 
-        AWS_NAPI_ENSURE(
-            env,
-            aws_napi_create_external_arraybuffer(
-                env, args->chunk.buffer, args->chunk.len, s_external_arraybuffer_finalizer, args, &params[0]));
+    /* Chunk is being handed to nodejs, update pending length */
+    aws_atomic_fetch_sub(&binding->pending_length, args->chunk.len);
 
-        AWS_NAPI_ENSURE(
-            env, aws_napi_dispatch_threadsafe_function(env, binding->on_body, NULL, on_body, num_params, params));
-    }
+    /* the arraybuffer takes ownership of args, and frees them when it is collected */
+    AWS_NAPI_ENSURE(
+        env,
+        aws_napi_create_external_arraybuffer(
+            env, args->chunk.buffer, args->chunk.len, s_external_arraybuffer_finalizer, args, result));
+
+    return AWS_OP_SUCCESS;
 }
 
 static int s_on_response_body(struct aws_http_stream *stream, const struct aws_byte_cursor *data, void *user_data) {
@@ -155,9 +166,10 @@ static int s_on_response_body(struct aws_http_stream *stream, const struct aws_b
         return AWS_OP_SUCCESS;
     }
 
-    struct on_body_args *args = aws_mem_calloc(binding->allocator, 1, sizeof(struct on_body_args));
+    struct aws_allocator *args_allocator = aws_napi_get_small_object_allocator();
+    struct on_body_args *args = aws_mem_calloc(args_allocator, 1, sizeof(struct on_body_args));
     AWS_FATAL_ASSERT(args);
-    args->allocator = binding->allocator;
+    args->allocator = args_allocator;
 
     /* recording the length of data that has been pending to be invoked for nodejs */
     aws_atomic_fetch_add(&binding->pending_length, data->len);
@@ -166,7 +178,12 @@ static int s_on_response_body(struct aws_http_stream *stream, const struct aws_b
         AWS_FATAL_ASSERT(args->chunk.buffer);
     }
 
-    AWS_NAPI_CALL(NULL, aws_napi_queue_threadsafe_function(binding->on_body, args), { return AWS_OP_ERR; });
+    /* chunks received while node is busy are delivered together, in one call */
+    if (aws_napi_threadsafe_batch_push(binding->on_body, &args->node)) {
+        aws_atomic_fetch_sub(&binding->pending_length, args->chunk.len);
+        s_on_body_args_destroy(&args->node, binding);
+        return AWS_OP_ERR;
+    }
 
     return AWS_OP_SUCCESS;
 }
@@ -197,7 +214,8 @@ static void s_on_complete_call(napi_env env, napi_value on_complete, void *conte
 
     /* No callbacks should happen now, cleanup all the threadsafe functions */
     AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(binding->on_response, napi_tsfn_abort));
-    AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(binding->on_body, napi_tsfn_abort));
+    aws_napi_threadsafe_batch_release(binding->on_body);
+    binding->on_body = NULL;
     AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(binding->on_complete, napi_tsfn_abort));
     AWS_NAPI_ENSURE(env, napi_delete_reference(env, binding->node_external));
 
@@ -225,7 +243,7 @@ static void s_http_stream_binding_finalize(napi_env env, void *finalize_data, vo
 }
 
 napi_value aws_napi_http_stream_new(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_HTTP);
     napi_value result = NULL;
 
     napi_value node_args[5];
@@ -292,14 +310,18 @@ napi_value aws_napi_http_stream_new(napi_env env, napi_callback_info info) {
     }
 
     if (!aws_napi_is_null_or_undefined(env, node_on_body)) {
-        AWS_NAPI_CALL(
-            env,
-            aws_napi_create_threadsafe_function(
-                env, node_on_body, "aws_http_stream_on_body", s_on_body_call, binding, &binding->on_body),
-            {
-                napi_throw_error(env, NULL, "Unable to bind on_body callback");
-                goto failed_callbacks;
-            });
+        struct aws_napi_threadsafe_batch_options on_body_options = {
+            .item_to_js = s_on_body_args_to_js,
+            .item_destroy = s_on_body_args_destroy,
+            .user_data = binding,
+            .deliver_as_array = true,
+        };
+        binding->on_body =
+            aws_napi_threadsafe_batch_new(allocator, env, node_on_body, "aws_http_stream_on_body", &on_body_options);
+        if (!binding->on_body) {
+            napi_throw_error(env, NULL, "Unable to bind on_body callback");
+            goto failed_callbacks;
+        }
     }
 
     struct aws_http_make_request_options request_options = {
@@ -335,7 +357,7 @@ failed_callbacks:
     if (binding) {
         AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(binding->on_complete, napi_tsfn_abort));
         AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(binding->on_response, napi_tsfn_abort));
-        AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(binding->on_body, napi_tsfn_abort));
+        aws_napi_threadsafe_batch_release(binding->on_body);
     }
     aws_mem_release(allocator, binding);
 failed_binding_alloc:
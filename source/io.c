@@ -5,15 +5,27 @@
 #include "io.h"
 #include "logger.h"
 
+#include <aws/cal/hash.h>
+#include <aws/common/file.h>
+#include <aws/common/linked_list.h>
 #include <aws/common/logging.h>
 #include <aws/common/mutex.h>
 #include <aws/io/channel_bootstrap.h>
 #include <aws/io/event_loop.h>
+#include <aws/io/host_resolver.h>
 #include <aws/io/pkcs11.h>
 #include <aws/io/socket.h>
 #include <aws/io/stream.h>
 #include <aws/io/tls_channel_handler.h>
 
+#if !defined(_WIN32)
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 #ifdef _MSC_VER
 #    pragma warning(disable : 4456) /* When nesting AWS_NAPI_CALL and AWS_NAPI_ENSURE, status's shadow eachother */
 #endif
@@ -104,488 +116,1325 @@ napi_value aws_napi_io_logging_enable(napi_env env, napi_callback_info info) {
     return NULL;
 }
 
-napi_value aws_napi_is_alpn_available(napi_env env, napi_callback_info info) {
-    (void)info;
-
-    const bool is_alpn_available = aws_tls_is_alpn_available();
+napi_value aws_napi_io_logging_enable_file(napi_env env, napi_callback_info info) {
+    napi_value node_args[6];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_logging_enable_file requires exactly 6 arguments");
+        return NULL;
+    }
 
-    napi_value node_bool = NULL;
-    if (napi_ok != napi_get_boolean(env, is_alpn_available, &node_bool)) {
+    struct aws_byte_buf path;
+    AWS_ZERO_STRUCT(path);
 
-        napi_throw_error(env, NULL, "Failed to get boolean value");
+    enum aws_log_level log_level;
+    if (napi_get_value_int32(env, node_args[1], (int32_t *)&log_level)) {
+        napi_throw_type_error(env, NULL, "log_level must be an integer");
         return NULL;
     }
 
-    return node_bool;
-}
-
-struct client_bootstrap_binding {
-    struct aws_client_bootstrap *bootstrap;
-    struct aws_host_resolver *resolver;
-};
+    struct aws_napi_log_file_options options = {
+        .buffer_size = 256 * 1024,
+        .flush_interval_ms = 1000,
+        .max_files = 5,
+    };
 
-struct aws_client_bootstrap *aws_napi_get_client_bootstrap(struct client_bootstrap_binding *binding) {
-    return binding->bootstrap;
-}
+    int64_t value = 0;
+    if (!aws_napi_is_null_or_undefined(env, node_args[2])) {
+        if (napi_get_value_int64(env, node_args[2], &value) || value <= 0) {
+            napi_throw_type_error(env, NULL, "buffer_size must be a positive integer");
+            return NULL;
+        }
+        options.buffer_size = (size_t)value;
+    }
 
-/** Finalizer for an client_bootstrap external */
-static void s_client_bootstrap_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    if (!aws_napi_is_null_or_undefined(env, node_args[3])) {
+        if (napi_get_value_int64(env, node_args[3], &value) || value <= 0) {
+            napi_throw_type_error(env, NULL, "flush_interval_ms must be a positive integer");
+            return NULL;
+        }
+        options.flush_interval_ms = (uint64_t)value;
+    }
 
-    (void)env;
-    (void)finalize_hint;
+    if (!aws_napi_is_null_or_undefined(env, node_args[4])) {
+        if (napi_get_value_int64(env, node_args[4], &value) || value < 0) {
+            napi_throw_type_error(env, NULL, "max_file_size must be a non-negative integer");
+            return NULL;
+        }
+        options.max_file_size = (size_t)value;
+    }
 
-    struct client_bootstrap_binding *binding = finalize_data;
-    AWS_ASSERT(binding);
+    if (!aws_napi_is_null_or_undefined(env, node_args[5])) {
+        if (napi_get_value_int64(env, node_args[5], &value) || value < 0) {
+            napi_throw_type_error(env, NULL, "max_files must be a non-negative integer");
+            return NULL;
+        }
+        options.max_files = (size_t)value;
+    }
 
-    struct aws_allocator *allocator = binding->bootstrap->allocator;
+    if (aws_byte_buf_init_from_napi(&path, env, node_args[0])) {
+        napi_throw_type_error(env, NULL, "path must be a string");
+        return NULL;
+    }
+    options.path = aws_byte_cursor_from_buf(&path);
 
-    aws_host_resolver_release(binding->resolver);
-    aws_client_bootstrap_release(binding->bootstrap);
+    if (aws_napi_logger_enable_file(&options)) {
+        aws_napi_throw_last_error(env);
+    } else {
+        aws_napi_logger_set_level(log_level);
+    }
 
-    aws_mem_release(allocator, binding);
+    aws_byte_buf_clean_up(&path);
+    return NULL;
 }
 
-#ifdef _MSC_VER
-#    pragma warning(push)
-#    pragma warning(disable : 4204 4221) /* non-standard aggregate initializer warnings */
-#endif
-
-napi_value aws_napi_io_client_bootstrap_new(napi_env env, napi_callback_info info) {
+napi_value aws_napi_io_logging_disable_file(napi_env env, napi_callback_info info) {
+    (void)env;
     (void)info;
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
-
-    struct client_bootstrap_binding *binding = aws_mem_acquire(allocator, sizeof(struct client_bootstrap_binding));
-    AWS_ZERO_STRUCT(*binding);
-
-    struct aws_host_resolver_default_options resolver_options = {
-        .max_entries = 64,
-        .el_group = aws_napi_get_node_elg(),
-    };
-
-    binding->resolver = aws_host_resolver_new_default(allocator, &resolver_options);
-    if (binding->resolver == NULL) {
-        goto clean_up;
-    }
+    aws_napi_logger_disable_file();
+    return NULL;
+}
 
-    struct aws_client_bootstrap_options options = {
-        .event_loop_group = aws_napi_get_node_elg(),
-        .host_resolver = binding->resolver,
-    };
+/* Accepts either a subject's registered name or its numeric id */
+static int s_log_subject_from_napi(napi_env env, napi_value node_subject, aws_log_subject_t *out_subject) {
+    napi_valuetype type = napi_undefined;
+    AWS_NAPI_CALL(env, napi_typeof(env, node_subject, &type), { return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT); });
 
-    binding->bootstrap = aws_client_bootstrap_new(allocator, &options);
-    if (!binding->bootstrap) {
-        napi_throw_error(env, NULL, "Failed init client_bootstrap");
-        goto clean_up;
+    if (type == napi_number) {
+        uint32_t subject = 0;
+        AWS_NAPI_CALL(env, napi_get_value_uint32(env, node_subject, &subject), {
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        });
+        *out_subject = subject;
+        return AWS_OP_SUCCESS;
     }
 
-    napi_value node_external = NULL;
-    if (napi_ok != napi_create_external(env, binding, s_client_bootstrap_finalize, NULL, &node_external)) {
-        napi_throw_error(env, NULL, "Failed create n-api external");
-        goto clean_up;
+    struct aws_byte_buf name;
+    if (aws_byte_buf_init_from_napi(&name, env, node_subject)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
+    int result = aws_napi_logger_find_subject(aws_byte_cursor_from_buf(&name), out_subject);
+    aws_byte_buf_clean_up(&name);
+    return result;
+}
 
-    return node_external;
-
-clean_up:
-    if (binding->bootstrap) {
-        aws_client_bootstrap_release(binding->bootstrap);
-    }
-    if (binding->resolver) {
-        aws_host_resolver_release(binding->resolver);
+napi_value aws_napi_io_logging_set_subject_level(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
     }
-    if (binding) {
-        aws_mem_release(allocator, binding);
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_logging_set_subject_level requires exactly 2 arguments");
+        return NULL;
     }
 
-    return NULL;
-}
-
-#ifdef _MSC_VER
-#    pragma warning(pop)
-#endif
+    aws_log_subject_t subject = 0;
+    if (s_log_subject_from_napi(env, node_args[0], &subject)) {
+        napi_throw_type_error(env, NULL, "subject must be the name or id of a registered log subject");
+        return NULL;
+    }
 
-struct pkcs11_lib_binding {
-    struct aws_pkcs11_lib *native;
-};
+    if (aws_napi_is_null_or_undefined(env, node_args[1])) {
+        aws_napi_logger_clear_subject_level(subject);
+        return NULL;
+    }
 
-static void s_pkcs11_lib_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
-    (void)env;
-    (void)finalize_hint;
+    int32_t log_level = 0;
+    if (napi_get_value_int32(env, node_args[1], &log_level)) {
+        napi_throw_type_error(env, NULL, "log_level must be an integer");
+        return NULL;
+    }
 
-    struct pkcs11_lib_binding *binding = finalize_data;
-    if (binding->native) {
-        aws_pkcs11_lib_release(binding->native);
+    if (aws_napi_logger_set_subject_level(subject, (enum aws_log_level)log_level)) {
+        aws_napi_throw_last_error(env);
     }
-    aws_mem_release(aws_napi_get_allocator(), binding);
+    return NULL;
 }
 
-napi_value aws_napi_io_pkcs11_lib_new(napi_env env, napi_callback_info info) {
-    napi_value node_args[2];
+napi_value aws_napi_io_logging_set_subject_rate_limit(napi_env env, napi_callback_info info) {
+    napi_value node_args[3];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
-    napi_value *arg = &node_args[0];
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retrieve callback information");
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "io_pkcs11_lib_new called with wrong number of args");
+        napi_throw_error(env, NULL, "io_logging_set_subject_rate_limit requires exactly 3 arguments");
         return NULL;
     }
 
-    /* From hereon, need to clean up if errors occur */
-    struct aws_string *path = NULL;
-    napi_value node_external = NULL;
-    bool success = false;
-
-    /* parse path */
-    napi_value node_path = *arg++;
-    path = aws_string_new_from_napi(env, node_path);
-    if (path == NULL) {
-        napi_throw_type_error(env, NULL, "Cannot convert path to string");
-        goto cleanup;
+    aws_log_subject_t subject = 0;
+    if (s_log_subject_from_napi(env, node_args[0], &subject)) {
+        napi_throw_type_error(env, NULL, "subject must be the name or id of a registered log subject");
+        return NULL;
     }
 
-    struct aws_pkcs11_lib_options options = {
-        .filename = aws_byte_cursor_from_string(path),
-    };
-
-    /* parse behavior */
-    napi_value node_behavior_arg = *arg++;
-    napi_value node_behavior_val = NULL;
-    if (napi_coerce_to_number(env, node_behavior_arg, &node_behavior_val)) {
-        napi_throw_type_error(env, NULL, "Invalid behavior arg (cannot coerce to number)");
-        goto cleanup;
+    double messages_per_second = 0;
+    if (napi_get_value_double(env, node_args[1], &messages_per_second) || !(messages_per_second >= 0)) {
+        napi_throw_type_error(env, NULL, "messages_per_second must be a non-negative number");
+        return NULL;
     }
 
-    int32_t behavior_int = 0;
-    if (napi_get_value_int32(env, node_behavior_val, &behavior_int)) {
-        napi_throw_type_error(env, NULL, "Invalid behavior arg (cannot get int value)");
-        goto cleanup;
+    /* by default, allow up to one second's worth of lines at once */
+    double burst = messages_per_second;
+    if (!aws_napi_is_null_or_undefined(env, node_args[2])) {
+        if (napi_get_value_double(env, node_args[2], &burst) || !(burst >= 1)) {
+            napi_throw_type_error(env, NULL, "burst must be a number no less than 1");
+            return NULL;
+        }
     }
-    options.initialize_finalize_behavior = (enum aws_pcks11_lib_behavior)behavior_int;
 
-    /* create external */
-    struct pkcs11_lib_binding *binding = aws_mem_calloc(aws_napi_get_allocator(), 1, sizeof(struct pkcs11_lib_binding));
-    if (napi_create_external(env, binding, s_pkcs11_lib_finalize, NULL, &node_external)) {
-        napi_throw_error(env, NULL, "Failed to create n-api external");
-        goto cleanup;
+    if (aws_napi_logger_set_subject_rate_limit(subject, messages_per_second, burst)) {
+        aws_napi_throw_last_error(env);
     }
+    return NULL;
+}
 
-    /* create pkcs11_lib */
-    binding->native = aws_pkcs11_lib_new(aws_napi_get_allocator(), &options);
-    if (binding->native == NULL) {
-        aws_napi_throw_last_error(env);
-        goto cleanup;
+napi_value aws_napi_io_logging_get_subject_level(napi_env env, napi_callback_info info) {
+    napi_value node_args[1];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_logging_get_subject_level requires exactly 1 argument");
+        return NULL;
     }
 
-    success = true;
-cleanup:
-    aws_string_destroy(path);
+    aws_log_subject_t subject = 0;
+    if (s_log_subject_from_napi(env, node_args[0], &subject)) {
+        napi_throw_type_error(env, NULL, "subject must be the name or id of a registered log subject");
+        return NULL;
+    }
 
-    /* NOTE: don't need to clean up node_external, the finalizer will handle that the GC collects it */
+    /* the level the CRT sees when deciding whether to format a line, overrides included */
+    struct aws_logger *logger = aws_logger_get();
+    enum aws_log_level level = logger ? logger->vtable->get_log_level(logger, subject) : AWS_LL_NONE;
 
-    return success ? node_external : NULL;
+    napi_value node_level = NULL;
+    AWS_NAPI_CALL(env, napi_create_uint32(env, (uint32_t)level, &node_level), {
+        napi_throw_error(env, NULL, "Failed to create log level");
+        return NULL;
+    });
+    return node_level;
 }
 
-napi_value aws_napi_io_pkcs11_lib_close(napi_env env, napi_callback_info info) {
-    napi_value node_args[1];
+napi_value aws_napi_io_logging_log(napi_env env, napi_callback_info info) {
+    napi_value node_args[3];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
-    napi_value *arg = &node_args[0];
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retrieve callback information");
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "aws_napi_io_pkcs11_lib_close called with wrong number of args");
+        napi_throw_error(env, NULL, "io_logging_log requires exactly 3 arguments");
         return NULL;
     }
 
-    napi_value node_external = *arg++;
+    aws_log_subject_t subject = 0;
+    if (s_log_subject_from_napi(env, node_args[0], &subject)) {
+        napi_throw_type_error(env, NULL, "subject must be the name or id of a registered log subject");
+        return NULL;
+    }
 
-    struct pkcs11_lib_binding *binding = NULL;
-    AWS_NAPI_CALL(env, napi_get_value_external(env, node_external, (void **)&binding), {
-        AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "expected valid Pkcs11Lib.handle"));
+    int32_t log_level = 0;
+    if (napi_get_value_int32(env, node_args[1], &log_level) || log_level <= AWS_LL_NONE ||
+        log_level >= AWS_LL_COUNT) {
+        napi_throw_type_error(env, NULL, "log_level must be a level between FATAL and TRACE");
         return NULL;
-    });
+    }
 
-    if (binding->native) {
-        aws_pkcs11_lib_release(binding->native);
-        binding->native = NULL;
+    struct aws_byte_buf message;
+    if (aws_byte_buf_init_from_napi(&message, env, node_args[2])) {
+        napi_throw_type_error(env, NULL, "message must be a string");
+        return NULL;
     }
 
+    /* goes through the same level check, filters and pipeline as the CRT's own logging */
+    AWS_LOGF((enum aws_log_level)log_level, subject, PRInSTR, AWS_BYTE_BUF_PRI(message));
+
+    aws_byte_buf_clean_up(&message);
     return NULL;
 }
 
-/** Finalizer for a tls_ctx external */
-static void s_tls_ctx_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+napi_value aws_napi_is_alpn_available(napi_env env, napi_callback_info info) {
+    (void)info;
 
-    (void)env;
-    (void)finalize_hint;
+    const bool is_alpn_available = aws_tls_is_alpn_available();
 
-    struct aws_tls_ctx *tls_ctx = finalize_data;
-    AWS_ASSERT(tls_ctx);
+    napi_value node_bool = NULL;
+    if (napi_ok != napi_get_boolean(env, is_alpn_available, &node_bool)) {
 
-    aws_tls_ctx_release(tls_ctx);
+        napi_throw_error(env, NULL, "Failed to get boolean value");
+        return NULL;
+    }
+
+    return node_bool;
 }
 
-napi_value aws_napi_io_tls_ctx_new(napi_env env, napi_callback_info info) {
+struct host_resolver_binding {
+    struct aws_allocator *allocator;
+    struct aws_host_resolver *resolver;
+    /* applied to every lookup made through this resolver, including those made by bootstraps built on it */
+    struct aws_host_resolution_config config;
+};
 
-    struct aws_allocator *alloc = aws_napi_get_allocator();
-    napi_status status = napi_ok;
-    (void)status;
+/** Finalizer for a host_resolver external */
+static void s_host_resolver_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+    (void)finalize_hint;
+
+    struct host_resolver_binding *binding = finalize_data;
+    aws_host_resolver_release(binding->resolver);
+    aws_mem_release(binding->allocator, binding);
+}
 
-    napi_value node_args[14];
+napi_value aws_napi_io_host_resolver_new(napi_env env, napi_callback_info info) {
+    napi_value node_args[3];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
-    napi_value *arg = &node_args[0];
-    if (napi_ok != napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
-        napi_throw_error(env, NULL, "Failed to retreive callback information");
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "aws_nodejs_io_client_tls_ctx_new called with wrong number of arguments");
+        napi_throw_error(env, NULL, "io_host_resolver_new requires exactly 3 arguments");
         return NULL;
     }
 
-    napi_value result = NULL;
+    bool use_default = false;
+    if (napi_get_value_bool(env, node_args[0], &use_default)) {
+        napi_throw_type_error(env, NULL, "use_default must be a boolean");
+        return NULL;
+    }
 
-    struct aws_string *pkcs12_path = NULL;
-    struct aws_byte_buf pkcs12_pwd;
-    AWS_ZERO_STRUCT(pkcs12_pwd);
+    uint32_t max_entries = 64;
+    if (!aws_napi_is_null_or_undefined(env, node_args[1])) {
+        if (napi_get_value_uint32(env, node_args[1], &max_entries) || max_entries == 0) {
+            napi_throw_type_error(env, NULL, "max_entries must be a positive integer");
+            return NULL;
+        }
+    }
 
-    struct aws_tls_ctx_options ctx_options;
-    AWS_ZERO_STRUCT(ctx_options);
+    uint32_t max_ttl_secs = 0;
+    if (!aws_napi_is_null_or_undefined(env, node_args[2])) {
+        if (napi_get_value_uint32(env, node_args[2], &max_ttl_secs)) {
+            napi_throw_type_error(env, NULL, "max_ttl_secs must be a non-negative integer");
+            return NULL;
+        }
+    }
 
-    struct aws_string *ca_path = NULL;
-    struct aws_string *ca_file = NULL;
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+    struct host_resolver_binding *binding = aws_mem_calloc(allocator, 1, sizeof(struct host_resolver_binding));
+    if (!binding) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+    binding->allocator = allocator;
 
-    struct aws_byte_buf certificate;
-    AWS_ZERO_STRUCT(certificate);
-    struct aws_byte_buf private_key;
-    AWS_ZERO_STRUCT(private_key);
-    struct aws_byte_buf ca_buf;
-    AWS_ZERO_STRUCT(ca_buf);
-
-    struct aws_string *cert_path = NULL;
-    struct aws_string *pkey_path = NULL;
-    struct aws_string *alpn_list = NULL;
+    if (use_default) {
+        /* the resolver behind the default client bootstrap, so lookups here warm the cache its connections use */
+        binding->resolver = aws_host_resolver_acquire(aws_napi_get_default_host_resolver(&binding->config));
+    } else {
+        struct aws_host_resolver_default_options resolver_options = {
+            .max_entries = max_entries,
+            .el_group = aws_napi_get_node_elg(),
+        };
+        binding->resolver = aws_host_resolver_new_default(allocator, &resolver_options);
+        if (!binding->resolver) {
+            aws_napi_throw_last_error(env);
+            goto failed;
+        }
+        aws_napi_init_host_resolution_config(&binding->config, max_ttl_secs);
+    }
 
-    struct aws_tls_ctx_pkcs11_options pkcs11_options;
-    AWS_ZERO_STRUCT(pkcs11_options);
-    struct aws_byte_buf pkcs11_pin;
-    AWS_ZERO_STRUCT(pkcs11_pin);
-    uint64_t pkcs11_slot_id = 0;
-    struct aws_byte_buf pkcs11_token_label;
-    AWS_ZERO_STRUCT(pkcs11_token_label);
-    struct aws_byte_buf pkcs11_key_label;
-    AWS_ZERO_STRUCT(pkcs11_key_label);
-    struct aws_byte_buf pkcs11_cert_path;
-    AWS_ZERO_STRUCT(pkcs11_cert_path);
-    struct aws_byte_buf pkcs11_cert_contents;
-    AWS_ZERO_STRUCT(pkcs11_cert_contents);
+    napi_value node_external = NULL;
+    if (napi_create_external(env, binding, s_host_resolver_finalize, NULL, &node_external)) {
+        napi_throw_error(env, NULL, "Unable to create external for native aws_host_resolver");
+        goto failed;
+    }
 
-    struct aws_string *windows_cert_store_path = NULL;
+    return node_external;
 
-    uint32_t min_tls_version = AWS_IO_TLS_VER_SYS_DEFAULTS;
-    napi_value node_tls_version = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_tls_version)) {
-        napi_value node_number;
-        if (napi_ok != napi_coerce_to_number(env, node_tls_version, &node_number)) {
-            napi_throw_type_error(env, NULL, "min_tls_version must be an enum/Number (or convertible to a Number)");
-            return result;
-        }
-        status = napi_get_value_uint32(env, node_number, &min_tls_version);
-        AWS_FATAL_ASSERT(status == napi_ok); /* We coerced the value to a number, so this must return ok */
+failed:
+    if (binding->resolver) {
+        aws_host_resolver_release(binding->resolver);
     }
+    aws_mem_release(allocator, binding);
+    return NULL;
+}
 
-    napi_value node_ca_file = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_ca_file)) {
-        ca_file = aws_string_new_from_napi(env, node_ca_file);
-        if (!ca_file) {
-            napi_throw_type_error(env, NULL, "ca_filepath must be a String (or convertible to a String)");
-            goto cleanup;
-        }
-    }
+struct host_resolver_resolve_args {
+    struct aws_allocator *allocator;
+    napi_threadsafe_function on_resolved;
+    int error_code;
+    struct aws_array_list addresses; /* struct aws_host_address, copied from the resolver's results */
+};
 
-    napi_value node_ca_path = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_ca_path)) {
-        ca_path = aws_string_new_from_napi(env, node_ca_path);
-        if (!ca_path) {
-            napi_throw_type_error(env, NULL, "ca_dirpath must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+static void s_host_resolver_resolve_args_destroy(struct host_resolver_resolve_args *args) {
+    const size_t count = aws_array_list_length(&args->addresses);
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_host_address *address = NULL;
+        aws_array_list_get_at_ptr(&args->addresses, (void **)&address, i);
+        aws_host_address_clean_up(address);
     }
+    aws_array_list_clean_up(&args->addresses);
+    aws_mem_release(args->allocator, args);
+}
 
-    napi_value node_ca_buf = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_ca_buf)) {
-        if (aws_byte_buf_init_from_napi(&ca_buf, env, node_ca_buf)) {
-            napi_throw_type_error(env, NULL, "certificate_authority must be a String (or convertible to a String)");
-            goto cleanup;
+static void s_host_resolver_on_resolved_call(napi_env env, napi_value on_resolved, void *context, void *user_data) {
+    (void)context;
+    struct host_resolver_resolve_args *args = user_data;
+
+    if (env) {
+        napi_value params[2];
+        const size_t num_params = AWS_ARRAY_SIZE(params);
+
+        const size_t count = aws_array_list_length(&args->addresses);
+        AWS_NAPI_ENSURE(env, napi_create_int32(env, args->error_code, &params[0]));
+        AWS_NAPI_ENSURE(env, napi_create_array_with_length(env, count, &params[1]));
+
+        for (size_t i = 0; i < count; ++i) {
+            struct aws_host_address *address = NULL;
+            aws_array_list_get_at_ptr(&args->addresses, (void **)&address, i);
+
+            /* same shape as the results of dns.lookup() */
+            const uint32_t family = address->record_type == AWS_ADDRESS_RECORD_TYPE_AAAA ? 6 : 4;
+
+            napi_value node_address = NULL;
+            napi_value node_address_string = NULL;
+            napi_value node_family = NULL;
+            AWS_NAPI_ENSURE(env, napi_create_object(env, &node_address));
+            AWS_NAPI_ENSURE(
+                env,
+                napi_create_string_utf8(
+                    env, aws_string_c_str(address->address), address->address->len, &node_address_string));
+            AWS_NAPI_ENSURE(env, napi_create_uint32(env, family, &node_family));
+            AWS_NAPI_ENSURE(env, napi_set_named_property(env, node_address, "address", node_address_string));
+            AWS_NAPI_ENSURE(env, napi_set_named_property(env, node_address, "family", node_family));
+            AWS_NAPI_ENSURE(env, napi_set_element(env, params[1], (uint32_t)i, node_address));
         }
+
+        AWS_NAPI_ENSURE(
+            env,
+            aws_napi_dispatch_threadsafe_function(env, args->on_resolved, NULL, on_resolved, num_params, params));
     }
 
-    napi_value node_alpn = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_alpn)) {
-        alpn_list = aws_string_new_from_napi(env, node_alpn);
-        if (!alpn_list) {
-            napi_throw_type_error(env, NULL, "alpn_list must be a String (or convertible to a String)");
-            goto cleanup;
+    AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(args->on_resolved, napi_tsfn_abort));
+    s_host_resolver_resolve_args_destroy(args);
+}
+
+/* May be called on an event loop thread, or synchronously from aws_host_resolver_resolve_host() on a cache hit */
+static void s_host_resolver_on_resolved(
+    struct aws_host_resolver *resolver,
+    const struct aws_string *host_name,
+    int error_code,
+    const struct aws_array_list *host_addresses,
+    void *user_data) {
+
+    (void)resolver;
+    (void)host_name;
+
+    struct host_resolver_resolve_args *args = user_data;
+    args->error_code = error_code;
+
+    if (error_code == AWS_ERROR_SUCCESS && host_addresses) {
+        const size_t count = aws_array_list_length(host_addresses);
+        for (size_t i = 0; i < count; ++i) {
+            struct aws_host_address *address = NULL;
+            aws_array_list_get_at_ptr(host_addresses, (void **)&address, i);
+
+            struct aws_host_address copy;
+            if (aws_host_address_copy(address, &copy)) {
+                continue;
+            }
+            if (aws_array_list_push_back(&args->addresses, &copy)) {
+                aws_host_address_clean_up(&copy);
+            }
         }
     }
 
-    napi_value node_cert_path = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_cert_path)) {
-        cert_path = aws_string_new_from_napi(env, node_cert_path);
-        if (!cert_path) {
-            napi_throw_type_error(env, NULL, "cert_path must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+    if (aws_napi_queue_threadsafe_function(args->on_resolved, args) != napi_ok) {
+        /* node is shutting down and will never run the call that frees args */
+        s_host_resolver_resolve_args_destroy(args);
     }
+}
 
-    napi_value node_cert_buf = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_cert_buf)) {
-        if (aws_byte_buf_init_from_napi(&certificate, env, node_cert_buf)) {
-            napi_throw_type_error(env, NULL, "certificate must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+napi_value aws_napi_io_host_resolver_resolve(napi_env env, napi_callback_info info) {
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_host_resolver_resolve requires exactly 3 arguments");
+        return NULL;
     }
 
-    napi_value node_key_path = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_key_path)) {
-        pkey_path = aws_string_new_from_napi(env, node_key_path);
-        if (!pkey_path) {
-            napi_throw_type_error(env, NULL, "private_key_path must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+    struct host_resolver_binding *binding = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&binding)) {
+        napi_throw_error(env, NULL, "resolver must be a node external");
+        return NULL;
     }
 
-    napi_value node_key_buf = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_key_buf)) {
-        if (aws_byte_buf_init_from_napi(&private_key, env, node_key_buf)) {
-            napi_throw_type_error(env, NULL, "private_key must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+    struct aws_string *host_name = aws_string_new_from_napi(env, node_args[1]);
+    if (!host_name) {
+        napi_throw_type_error(env, NULL, "host must be a String");
+        return NULL;
     }
 
-    napi_value node_pkcs12_path = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_pkcs12_path)) {
-        pkcs12_path = aws_string_new_from_napi(env, node_pkcs12_path);
-        if (!pkcs12_path) {
-            napi_throw_type_error(env, NULL, "pkcs12_path must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+    struct host_resolver_resolve_args *args =
+        aws_mem_calloc(binding->allocator, 1, sizeof(struct host_resolver_resolve_args));
+    if (!args) {
+        aws_napi_throw_last_error(env);
+        goto done;
     }
+    args->allocator = binding->allocator;
+    if (aws_array_list_init_dynamic(&args->addresses, args->allocator, 4, sizeof(struct aws_host_address))) {
+        aws_mem_release(args->allocator, args);
+        aws_napi_throw_last_error(env);
+        goto done;
+    }
+
+    AWS_NAPI_CALL(
+        env,
+        aws_napi_create_threadsafe_function(
+            env,
+            node_args[2],
+            "aws_host_resolver_on_resolved",
+            s_host_resolver_on_resolved_call,
+            NULL,
+            &args->on_resolved),
+        {
+            s_host_resolver_resolve_args_destroy(args);
+            napi_throw_type_error(env, NULL, "on_resolved must be a valid callback");
+            goto done;
+        });
 
-    napi_value node_pkcs12_password = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_pkcs12_password)) {
-        if (napi_ok != aws_byte_buf_init_from_napi(&pkcs12_pwd, env, node_pkcs12_password)) {
-            napi_throw_type_error(env, NULL, "pkcs12_password must be a String (or convertible to a String)");
-            goto cleanup;
-        }
+    if (aws_host_resolver_resolve_host(
+            binding->resolver, host_name, s_host_resolver_on_resolved, &binding->config, args)) {
+        AWS_NAPI_ENSURE(env, aws_napi_release_threadsafe_function(args->on_resolved, napi_tsfn_abort));
+        s_host_resolver_resolve_args_destroy(args);
+        aws_napi_throw_last_error(env);
     }
 
-    napi_value node_pkcs11_options = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_pkcs11_options)) {
+done:
+    aws_string_destroy(host_name);
+    return NULL;
+}
 
-        napi_value node_pkcs11_lib = NULL;
-        AWS_NAPI_CALL(env, napi_get_named_property(env, node_pkcs11_options, "pkcs11_lib", &node_pkcs11_lib), {
-            napi_throw_type_error(env, NULL, "'pkcs11_lib' is required for PKCS#11");
-            goto cleanup;
-        });
+static void s_host_resolver_on_prefetched(
+    struct aws_host_resolver *resolver,
+    const struct aws_string *host_name,
+    int error_code,
+    const struct aws_array_list *host_addresses,
+    void *user_data) {
+
+    /* the point of a prefetch is the cache entry the lookup leaves behind */
+    (void)resolver;
+    (void)host_name;
+    (void)error_code;
+    (void)host_addresses;
+    (void)user_data;
+}
 
-        napi_value node_pkcs11_lib_handle = NULL;
-        AWS_NAPI_CALL(env, napi_get_named_property(env, node_pkcs11_lib, "handle", &node_pkcs11_lib_handle), {
-            napi_throw_type_error(env, NULL, "'pkcs11_lib' must be a Pkcs11Lib");
-            goto cleanup;
-        });
+napi_value aws_napi_io_host_resolver_prefetch(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_host_resolver_prefetch requires exactly 2 arguments");
+        return NULL;
+    }
 
-        struct pkcs11_lib_binding *pkcs11_lib_binding = NULL;
-        AWS_NAPI_CALL(env, napi_get_value_external(env, node_pkcs11_lib_handle, (void **)&pkcs11_lib_binding), {
-            napi_throw_type_error(env, NULL, "'pkcs11_lib' must be a Pkcs11Lib");
-            goto cleanup;
-        });
-        pkcs11_options.pkcs11_lib = pkcs11_lib_binding->native;
+    struct host_resolver_binding *binding = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&binding)) {
+        napi_throw_error(env, NULL, "resolver must be a node external");
+        return NULL;
+    }
 
-        /* user_pin property is required. null is allowed, but this is unusual, so we require the user to set it */
-        napi_value node_user_pin = NULL;
-        AWS_NAPI_CALL(env, napi_get_named_property(env, node_pkcs11_options, "user_pin", &node_user_pin), {
-            napi_throw_type_error(env, NULL, "'user_pin' is required for PKCS#11 (must be string or null)");
-            goto cleanup;
+    uint32_t count = 0;
+    if (napi_get_array_length(env, node_args[1], &count)) {
+        napi_throw_type_error(env, NULL, "hosts must be an Array of Strings");
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value node_host = NULL;
+        AWS_NAPI_CALL(env, napi_get_element(env, node_args[1], i, &node_host), {
+            napi_throw_error(env, NULL, "Unable to read hosts");
+            return NULL;
         });
 
-        napi_valuetype node_user_pin_type = napi_undefined;
-        napi_typeof(env, node_user_pin, &node_user_pin_type);
-        if (node_user_pin_type == napi_undefined) {
-            napi_throw_type_error(env, NULL, "user_pin' is required for PKCS#11 (must be string or null)");
-            goto cleanup;
+        struct aws_string *host_name = aws_string_new_from_napi(env, node_host);
+        if (!host_name) {
+            napi_throw_type_error(env, NULL, "hosts must be an Array of Strings");
+            return NULL;
         }
 
-        if (node_user_pin_type != napi_null) {
-            if (napi_ok != aws_byte_buf_init_from_napi(&pkcs11_pin, env, node_user_pin)) {
-                napi_throw_type_error(env, NULL, "PKCS#11 'user_pin' must be a string or null");
-                goto cleanup;
-            }
-            pkcs11_options.user_pin = aws_byte_cursor_from_buf(&pkcs11_pin);
+        int result = aws_host_resolver_resolve_host(
+            binding->resolver, host_name, s_host_resolver_on_prefetched, &binding->config, NULL);
+        aws_string_destroy(host_name);
+        if (result) {
+            aws_napi_throw_last_error(env);
+            return NULL;
         }
+    }
 
-        napi_value node_slot_id = NULL;
-        if (napi_ok == napi_get_named_property(env, node_pkcs11_options, "slot_id", &node_slot_id)) {
-            if (!aws_napi_is_null_or_undefined(env, node_slot_id)) {
-                if (napi_ok != napi_get_value_int64(env, node_slot_id, (int64_t *)&pkcs11_slot_id)) {
-                    napi_throw_type_error(env, NULL, "PKCS#11 'slot_id' must be an int");
-                    goto cleanup;
-                }
-                pkcs11_options.slot_id = &pkcs11_slot_id;
-            }
-        }
+    return NULL;
+}
 
-        /* clang-format off */
+struct client_bootstrap_binding {
+    struct aws_client_bootstrap *bootstrap;
+    struct aws_host_resolver *resolver;
+    /* Only set if this bootstrap owns its event loop group, otherwise the node default group is used */
+    struct aws_event_loop_group *elg;
+};
 
-        #define PARSE_PKCS11_OPTION_STR(property_name, option_cursor, storage_buffer) {                                \
-            napi_value node_property = NULL;                                                                           \
-            if (napi_ok == napi_get_named_property(env, node_pkcs11_options, property_name, &node_property)) {         \
-                if (!aws_napi_is_null_or_undefined(env, node_property)) {                                              \
-                    if (napi_ok != aws_byte_buf_init_from_napi(&storage_buffer, env, node_property)) {                 \
-                        napi_throw_type_error(                                                                         \
-                            env, NULL, "PKCS#11 '" property_name "' must be a string (or convertible to string)");     \
-                        goto cleanup;                                                                                  \
-                    }                                                                                                  \
-                    option_cursor = aws_byte_cursor_from_buf(&storage_buffer);                                         \
-                }                                                                                                      \
-            }                                                                                                          \
-        }
-        /* clang-format on */
+struct aws_client_bootstrap *aws_napi_get_client_bootstrap(struct client_bootstrap_binding *binding) {
+    return binding->bootstrap;
+}
 
-        PARSE_PKCS11_OPTION_STR("token_label", pkcs11_options.token_label, pkcs11_token_label);
-        PARSE_PKCS11_OPTION_STR("private_key_object_label", pkcs11_options.private_key_object_label, pkcs11_key_label);
-        PARSE_PKCS11_OPTION_STR("cert_file_path", pkcs11_options.cert_file_path, pkcs11_cert_path);
-        PARSE_PKCS11_OPTION_STR("cert_file_contents", pkcs11_options.cert_file_contents, pkcs11_cert_contents);
-    }
+/** Finalizer for an client_bootstrap external */
+static void s_client_bootstrap_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
 
-    napi_value node_windows_cert_store_path = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_windows_cert_store_path)) {
-        windows_cert_store_path = aws_string_new_from_napi(env, node_windows_cert_store_path);
-        if (!windows_cert_store_path) {
-            napi_throw_type_error(env, NULL, "windows_cert_store_path must be a String (or convertible to a String)");
-            goto cleanup;
-        }
-    }
+    (void)env;
+    (void)finalize_hint;
 
-    bool verify_peer = true;
-    napi_value node_verify_peer = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_verify_peer)) {
-        napi_value node_bool;
-        if (napi_ok != napi_coerce_to_bool(env, node_verify_peer, &node_bool)) {
-            napi_throw_type_error(env, NULL, "verify_peer must be a boolean (or convertible to a boolean)");
-            goto cleanup;
-        }
+    struct client_bootstrap_binding *binding = finalize_data;
+    AWS_ASSERT(binding);
 
-        status = napi_get_value_bool(env, node_bool, &verify_peer);
-        AWS_FATAL_ASSERT(status == napi_ok);
-    }
+    struct aws_allocator *allocator = binding->bootstrap->allocator;
 
-    if (certificate.buffer && private_key.buffer) {
-        struct aws_byte_cursor cert_cursor = aws_byte_cursor_from_buf(&certificate);
+    aws_host_resolver_release(binding->resolver);
+    aws_client_bootstrap_release(binding->bootstrap);
+    aws_event_loop_group_release(binding->elg);
+
+    aws_mem_release(allocator, binding);
+}
+
+#ifdef _MSC_VER
+#    pragma warning(push)
+#    pragma warning(disable : 4204 4221) /* non-standard aggregate initializer warnings */
+#endif
+
+napi_value aws_napi_io_client_bootstrap_new(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+
+    /* optional: build the bootstrap on its own event loop group with this many threads */
+    bool owns_elg = false;
+    uint32_t thread_count = 0;
+    if (num_args > 0 && !aws_napi_is_null_or_undefined(env, node_args[0])) {
+        if (napi_get_value_uint32(env, node_args[0], &thread_count) || thread_count > UINT16_MAX) {
+            napi_throw_type_error(env, NULL, "event_loop_thread_count must be a valid thread count");
+            return NULL;
+        }
+        owns_elg = true;
+    }
+
+    /* optional: resolve through a shared HostResolver instead of a private one */
+    struct host_resolver_binding *resolver_binding = NULL;
+    if (num_args > 1 && !aws_napi_is_null_or_undefined(env, node_args[1])) {
+        if (napi_get_value_external(env, node_args[1], (void **)&resolver_binding)) {
+            napi_throw_type_error(env, NULL, "host_resolver must be a HostResolver");
+            return NULL;
+        }
+    }
+
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+
+    struct client_bootstrap_binding *binding = aws_mem_acquire(allocator, sizeof(struct client_bootstrap_binding));
+    AWS_ZERO_STRUCT(*binding);
+
+    struct aws_event_loop_group *elg = NULL;
+    if (owns_elg) {
+        binding->elg = aws_event_loop_group_new_default(allocator, (uint16_t)thread_count, NULL);
+        if (binding->elg == NULL) {
+            aws_napi_throw_last_error_with_context(env, "Failed to create event loop group");
+            goto clean_up;
+        }
+        elg = binding->elg;
+    } else {
+        elg = aws_napi_get_node_elg();
+    }
+
+    const struct aws_host_resolution_config *resolution_config = NULL;
+    if (resolver_binding) {
+        binding->resolver = aws_host_resolver_acquire(resolver_binding->resolver);
+        resolution_config = &resolver_binding->config;
+    } else {
+        struct aws_host_resolver_default_options resolver_options = {
+            .max_entries = 64,
+            .el_group = elg,
+        };
+
+        binding->resolver = aws_host_resolver_new_default(allocator, &resolver_options);
+        if (binding->resolver == NULL) {
+            goto clean_up;
+        }
+    }
+
+    /* the bootstrap keeps its own copy of the resolution config */
+    struct aws_client_bootstrap_options options = {
+        .event_loop_group = elg,
+        .host_resolver = binding->resolver,
+        .host_resolution_config = resolution_config,
+    };
+
+    binding->bootstrap = aws_client_bootstrap_new(allocator, &options);
+    if (!binding->bootstrap) {
+        napi_throw_error(env, NULL, "Failed init client_bootstrap");
+        goto clean_up;
+    }
+
+    napi_value node_external = NULL;
+    if (napi_ok != napi_create_external(env, binding, s_client_bootstrap_finalize, NULL, &node_external)) {
+        napi_throw_error(env, NULL, "Failed create n-api external");
+        goto clean_up;
+    }
+
+    return node_external;
+
+clean_up:
+    if (binding->bootstrap) {
+        aws_client_bootstrap_release(binding->bootstrap);
+    }
+    if (binding->resolver) {
+        aws_host_resolver_release(binding->resolver);
+    }
+    if (binding->elg) {
+        aws_event_loop_group_release(binding->elg);
+    }
+    if (binding) {
+        aws_mem_release(allocator, binding);
+    }
+
+    return NULL;
+}
+
+#ifdef _MSC_VER
+#    pragma warning(pop)
+#endif
+
+struct pkcs11_lib_binding {
+    struct aws_pkcs11_lib *native;
+};
+
+static void s_pkcs11_lib_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+    (void)finalize_hint;
+
+    struct pkcs11_lib_binding *binding = finalize_data;
+    if (binding->native) {
+        aws_pkcs11_lib_release(binding->native);
+    }
+    aws_mem_release(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), binding);
+}
+
+napi_value aws_napi_io_pkcs11_lib_new(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    napi_value *arg = &node_args[0];
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_pkcs11_lib_new called with wrong number of args");
+        return NULL;
+    }
+
+    /* From hereon, need to clean up if errors occur */
+    struct aws_string *path = NULL;
+    napi_value node_external = NULL;
+    bool success = false;
+
+    /* parse path */
+    napi_value node_path = *arg++;
+    path = aws_string_new_from_napi(env, node_path);
+    if (path == NULL) {
+        napi_throw_type_error(env, NULL, "Cannot convert path to string");
+        goto cleanup;
+    }
+
+    struct aws_pkcs11_lib_options options = {
+        .filename = aws_byte_cursor_from_string(path),
+    };
+
+    /* parse behavior */
+    napi_value node_behavior_arg = *arg++;
+    napi_value node_behavior_val = NULL;
+    if (napi_coerce_to_number(env, node_behavior_arg, &node_behavior_val)) {
+        napi_throw_type_error(env, NULL, "Invalid behavior arg (cannot coerce to number)");
+        goto cleanup;
+    }
+
+    int32_t behavior_int = 0;
+    if (napi_get_value_int32(env, node_behavior_val, &behavior_int)) {
+        napi_throw_type_error(env, NULL, "Invalid behavior arg (cannot get int value)");
+        goto cleanup;
+    }
+    options.initialize_finalize_behavior = (enum aws_pcks11_lib_behavior)behavior_int;
+
+    /* create external */
+    struct pkcs11_lib_binding *binding =
+        aws_mem_calloc(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), 1, sizeof(struct pkcs11_lib_binding));
+    if (napi_create_external(env, binding, s_pkcs11_lib_finalize, NULL, &node_external)) {
+        napi_throw_error(env, NULL, "Failed to create n-api external");
+        goto cleanup;
+    }
+
+    /* create pkcs11_lib */
+    binding->native = aws_pkcs11_lib_new(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), &options);
+    if (binding->native == NULL) {
+        aws_napi_throw_last_error(env);
+        goto cleanup;
+    }
+
+    success = true;
+cleanup:
+    aws_string_destroy(path);
+
+    /* NOTE: don't need to clean up node_external, the finalizer will handle that the GC collects it */
+
+    return success ? node_external : NULL;
+}
+
+napi_value aws_napi_io_pkcs11_lib_close(napi_env env, napi_callback_info info) {
+    napi_value node_args[1];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    napi_value *arg = &node_args[0];
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "aws_napi_io_pkcs11_lib_close called with wrong number of args");
+        return NULL;
+    }
+
+    napi_value node_external = *arg++;
+
+    struct pkcs11_lib_binding *binding = NULL;
+    AWS_NAPI_CALL(env, napi_get_value_external(env, node_external, (void **)&binding), {
+        AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "expected valid Pkcs11Lib.handle"));
+        return NULL;
+    });
+
+    if (binding->native) {
+        aws_pkcs11_lib_release(binding->native);
+        binding->native = NULL;
+    }
+
+    return NULL;
+}
+
+/** Finalizer for a tls_ctx external */
+static void s_tls_ctx_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+
+    (void)env;
+    (void)finalize_hint;
+
+    struct aws_tls_ctx *tls_ctx = finalize_data;
+    AWS_ASSERT(tls_ctx);
+
+    aws_tls_ctx_release(tls_ctx);
+}
+
+/*
+ * Client TLS contexts created with use_cache are shared by every caller passing identical options, across all node
+ * environments. Entries are keyed by a SHA-256 digest of the options and hold no reference of their own: each external
+ * wrapping the context holds one, and the entry goes away with the last of them. Cached contexts are never handed to
+ * callers with different options, so nothing but memory and setup time is shared.
+ */
+struct tls_ctx_cache_entry {
+    struct aws_linked_list_node node;
+    uint8_t key[AWS_SHA256_LEN];
+    struct aws_tls_ctx *tls_ctx;
+    size_t external_count;
+};
+
+static struct aws_mutex s_tls_ctx_cache_lock = AWS_MUTEX_INIT;
+static struct aws_linked_list s_tls_ctx_cache; /* initialized on first use */
+static bool s_tls_ctx_cache_initialized = false;
+
+/* Digests every option that affects the resulting context. Each field is prefixed with whether it was given and its
+ * length, so that different combinations of fields cannot produce the same input. */
+static int s_tls_ctx_cache_key_compute(
+    struct aws_allocator *allocator,
+    const struct aws_byte_cursor *fields,
+    size_t num_fields,
+    uint8_t *out_key) {
+
+    struct aws_hash *sha256 = aws_sha256_new(allocator);
+    if (!sha256) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_ERR;
+    for (size_t i = 0; i < num_fields; ++i) {
+        uint8_t header[9];
+        struct aws_byte_buf header_buf = aws_byte_buf_from_empty_array(header, sizeof(header));
+        aws_byte_buf_write_u8(&header_buf, fields[i].ptr != NULL);
+        aws_byte_buf_write_be64(&header_buf, (uint64_t)fields[i].len);
+
+        struct aws_byte_cursor header_cur = aws_byte_cursor_from_buf(&header_buf);
+        if (aws_hash_update(sha256, &header_cur) || aws_hash_update(sha256, &fields[i])) {
+            goto done;
+        }
+    }
+
+    struct aws_byte_buf key_buf = aws_byte_buf_from_empty_array(out_key, AWS_SHA256_LEN);
+    if (aws_hash_finalize(sha256, &key_buf, 0)) {
+        goto done;
+    }
+
+    result = AWS_OP_SUCCESS;
+
+done:
+    aws_hash_destroy(sha256);
+    return result;
+}
+
+static struct aws_byte_cursor s_optional_string_cursor(const struct aws_string *string) {
+    struct aws_byte_cursor cursor;
+    AWS_ZERO_STRUCT(cursor);
+    if (string) {
+        cursor = aws_byte_cursor_from_string(string);
+    }
+    return cursor;
+}
+
+/*
+ * Returns the entry cached under key, counting one more external for it. If there is none and tls_ctx is not NULL, it
+ * is cached under key first. Each returned entry's context is acquired on the caller's behalf.
+ */
+static struct tls_ctx_cache_entry *s_tls_ctx_cache_find_or_add(const uint8_t *key, struct aws_tls_ctx *tls_ctx) {
+    struct tls_ctx_cache_entry *found = NULL;
+
+    aws_mutex_lock(&s_tls_ctx_cache_lock);
+    if (!s_tls_ctx_cache_initialized) {
+        aws_linked_list_init(&s_tls_ctx_cache);
+        s_tls_ctx_cache_initialized = true;
+    }
+
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&s_tls_ctx_cache);
+         node != aws_linked_list_end(&s_tls_ctx_cache);
+         node = aws_linked_list_next(node)) {
+        struct tls_ctx_cache_entry *entry = AWS_CONTAINER_OF(node, struct tls_ctx_cache_entry, node);
+        if (memcmp(entry->key, key, AWS_SHA256_LEN) == 0) {
+            found = entry;
+            break;
+        }
+    }
+
+    if (!found && tls_ctx) {
+        found = aws_mem_calloc(
+            aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), 1, sizeof(struct tls_ctx_cache_entry));
+        if (found) {
+            memcpy(found->key, key, AWS_SHA256_LEN);
+            found->tls_ctx = tls_ctx;
+            aws_linked_list_push_back(&s_tls_ctx_cache, &found->node);
+        }
+    }
+
+    if (found) {
+        ++found->external_count;
+        aws_tls_ctx_acquire(found->tls_ctx);
+    }
+    aws_mutex_unlock(&s_tls_ctx_cache_lock);
+
+    return found;
+}
+
+/** Finalizer for a cached tls_ctx external */
+static void s_tls_ctx_cached_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+
+    struct aws_tls_ctx *tls_ctx = finalize_data;
+    struct tls_ctx_cache_entry *entry = finalize_hint;
+
+    aws_mutex_lock(&s_tls_ctx_cache_lock);
+    if (--entry->external_count == 0) {
+        aws_linked_list_remove(&entry->node);
+        aws_mem_release(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), entry);
+    }
+    aws_mutex_unlock(&s_tls_ctx_cache_lock);
+
+    aws_tls_ctx_release(tls_ctx);
+}
+
+/* Wraps an entry returned by s_tls_ctx_cache_find_or_add, taking over the reference it counted */
+static napi_value s_tls_ctx_cached_external_new(napi_env env, struct tls_ctx_cache_entry *entry) {
+    napi_value node_external = NULL;
+    if (napi_ok != napi_create_external(env, entry->tls_ctx, s_tls_ctx_cached_finalize, entry, &node_external)) {
+        s_tls_ctx_cached_finalize(env, entry->tls_ctx, entry);
+        napi_throw_error(env, NULL, "Failed create n-api external");
+        return NULL;
+    }
+
+    return node_external;
+}
+
+napi_value aws_napi_io_tls_ctx_cache_statistics(napi_env env, napi_callback_info info) {
+    (void)info;
+
+    uint64_t entry_count = 0;
+    uint64_t external_count = 0;
+
+    aws_mutex_lock(&s_tls_ctx_cache_lock);
+    if (s_tls_ctx_cache_initialized) {
+        for (struct aws_linked_list_node *node = aws_linked_list_begin(&s_tls_ctx_cache);
+             node != aws_linked_list_end(&s_tls_ctx_cache);
+             node = aws_linked_list_next(node)) {
+            struct tls_ctx_cache_entry *entry = AWS_CONTAINER_OF(node, struct tls_ctx_cache_entry, node);
+            ++entry_count;
+            external_count += entry->external_count;
+        }
+    }
+    aws_mutex_unlock(&s_tls_ctx_cache_lock);
+
+    napi_value node_stats = NULL;
+    AWS_NAPI_CALL(env, napi_create_object(env, &node_stats), { return NULL; });
+
+    if (aws_napi_attach_object_property_u64(node_stats, env, "entry_count", entry_count) ||
+        aws_napi_attach_object_property_u64(node_stats, env, "external_count", external_count)) {
+        napi_throw_error(env, NULL, "Unable to build tls context cache statistics");
+        return NULL;
+    }
+
+    return node_stats;
+}
+
+napi_value aws_napi_io_tls_ctx_new(napi_env env, napi_callback_info info) {
+
+    struct aws_allocator *alloc = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+    napi_status status = napi_ok;
+    (void)status;
+
+    napi_value node_args[15];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    napi_value *arg = &node_args[0];
+    if (napi_ok != napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retreive callback information");
+        return NULL;
+    }
+    /* use_cache is optional */
+    if (num_args != AWS_ARRAY_SIZE(node_args) && num_args != AWS_ARRAY_SIZE(node_args) - 1) {
+        napi_throw_error(env, NULL, "aws_nodejs_io_client_tls_ctx_new called with wrong number of arguments");
+        return NULL;
+    }
+
+    napi_value result = NULL;
+
+    struct aws_string *pkcs12_path = NULL;
+    struct aws_byte_buf pkcs12_pwd;
+    AWS_ZERO_STRUCT(pkcs12_pwd);
+
+    struct aws_tls_ctx_options ctx_options;
+    AWS_ZERO_STRUCT(ctx_options);
+
+    struct aws_string *ca_path = NULL;
+    struct aws_string *ca_file = NULL;
+
+    struct aws_byte_buf certificate;
+    AWS_ZERO_STRUCT(certificate);
+    struct aws_byte_buf private_key;
+    AWS_ZERO_STRUCT(private_key);
+    struct aws_byte_buf ca_buf;
+    AWS_ZERO_STRUCT(ca_buf);
+
+    struct aws_string *cert_path = NULL;
+    struct aws_string *pkey_path = NULL;
+    struct aws_string *alpn_list = NULL;
+
+    struct aws_tls_ctx_pkcs11_options pkcs11_options;
+    AWS_ZERO_STRUCT(pkcs11_options);
+    struct aws_byte_buf pkcs11_pin;
+    AWS_ZERO_STRUCT(pkcs11_pin);
+    uint64_t pkcs11_slot_id = 0;
+    struct aws_byte_buf pkcs11_token_label;
+    AWS_ZERO_STRUCT(pkcs11_token_label);
+    struct aws_byte_buf pkcs11_key_label;
+    AWS_ZERO_STRUCT(pkcs11_key_label);
+    struct aws_byte_buf pkcs11_cert_path;
+    AWS_ZERO_STRUCT(pkcs11_cert_path);
+    struct aws_byte_buf pkcs11_cert_contents;
+    AWS_ZERO_STRUCT(pkcs11_cert_contents);
+
+    struct aws_string *windows_cert_store_path = NULL;
+
+    uint32_t min_tls_version = AWS_IO_TLS_VER_SYS_DEFAULTS;
+    napi_value node_tls_version = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_tls_version)) {
+        napi_value node_number;
+        if (napi_ok != napi_coerce_to_number(env, node_tls_version, &node_number)) {
+            napi_throw_type_error(env, NULL, "min_tls_version must be an enum/Number (or convertible to a Number)");
+            return result;
+        }
+        status = napi_get_value_uint32(env, node_number, &min_tls_version);
+        AWS_FATAL_ASSERT(status == napi_ok); /* We coerced the value to a number, so this must return ok */
+    }
+
+    napi_value node_ca_file = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_ca_file)) {
+        ca_file = aws_string_new_from_napi(env, node_ca_file);
+        if (!ca_file) {
+            napi_throw_type_error(env, NULL, "ca_filepath must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_ca_path = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_ca_path)) {
+        ca_path = aws_string_new_from_napi(env, node_ca_path);
+        if (!ca_path) {
+            napi_throw_type_error(env, NULL, "ca_dirpath must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_ca_buf = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_ca_buf)) {
+        if (aws_byte_buf_init_from_napi(&ca_buf, env, node_ca_buf)) {
+            napi_throw_type_error(env, NULL, "certificate_authority must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_alpn = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_alpn)) {
+        alpn_list = aws_string_new_from_napi(env, node_alpn);
+        if (!alpn_list) {
+            napi_throw_type_error(env, NULL, "alpn_list must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_cert_path = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_cert_path)) {
+        cert_path = aws_string_new_from_napi(env, node_cert_path);
+        if (!cert_path) {
+            napi_throw_type_error(env, NULL, "cert_path must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_cert_buf = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_cert_buf)) {
+        if (aws_byte_buf_init_from_napi(&certificate, env, node_cert_buf)) {
+            napi_throw_type_error(env, NULL, "certificate must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_key_path = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_key_path)) {
+        pkey_path = aws_string_new_from_napi(env, node_key_path);
+        if (!pkey_path) {
+            napi_throw_type_error(env, NULL, "private_key_path must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_key_buf = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_key_buf)) {
+        if (aws_byte_buf_init_from_napi(&private_key, env, node_key_buf)) {
+            napi_throw_type_error(env, NULL, "private_key must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_pkcs12_path = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_pkcs12_path)) {
+        pkcs12_path = aws_string_new_from_napi(env, node_pkcs12_path);
+        if (!pkcs12_path) {
+            napi_throw_type_error(env, NULL, "pkcs12_path must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_pkcs12_password = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_pkcs12_password)) {
+        if (napi_ok != aws_byte_buf_init_from_napi(&pkcs12_pwd, env, node_pkcs12_password)) {
+            napi_throw_type_error(env, NULL, "pkcs12_password must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    napi_value node_pkcs11_options = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_pkcs11_options)) {
+
+        napi_value node_pkcs11_lib = NULL;
+        AWS_NAPI_CALL(env, napi_get_named_property(env, node_pkcs11_options, "pkcs11_lib", &node_pkcs11_lib), {
+            napi_throw_type_error(env, NULL, "'pkcs11_lib' is required for PKCS#11");
+            goto cleanup;
+        });
+
+        napi_value node_pkcs11_lib_handle = NULL;
+        AWS_NAPI_CALL(env, napi_get_named_property(env, node_pkcs11_lib, "handle", &node_pkcs11_lib_handle), {
+            napi_throw_type_error(env, NULL, "'pkcs11_lib' must be a Pkcs11Lib");
+            goto cleanup;
+        });
+
+        struct pkcs11_lib_binding *pkcs11_lib_binding = NULL;
+        AWS_NAPI_CALL(env, napi_get_value_external(env, node_pkcs11_lib_handle, (void **)&pkcs11_lib_binding), {
+            napi_throw_type_error(env, NULL, "'pkcs11_lib' must be a Pkcs11Lib");
+            goto cleanup;
+        });
+        pkcs11_options.pkcs11_lib = pkcs11_lib_binding->native;
+
+        /* user_pin property is required. null is allowed, but this is unusual, so we require the user to set it */
+        napi_value node_user_pin = NULL;
+        AWS_NAPI_CALL(env, napi_get_named_property(env, node_pkcs11_options, "user_pin", &node_user_pin), {
+            napi_throw_type_error(env, NULL, "'user_pin' is required for PKCS#11 (must be string or null)");
+            goto cleanup;
+        });
+
+        napi_valuetype node_user_pin_type = napi_undefined;
+        napi_typeof(env, node_user_pin, &node_user_pin_type);
+        if (node_user_pin_type == napi_undefined) {
+            napi_throw_type_error(env, NULL, "user_pin' is required for PKCS#11 (must be string or null)");
+            goto cleanup;
+        }
+
+        if (node_user_pin_type != napi_null) {
+            if (napi_ok != aws_byte_buf_init_from_napi(&pkcs11_pin, env, node_user_pin)) {
+                napi_throw_type_error(env, NULL, "PKCS#11 'user_pin' must be a string or null");
+                goto cleanup;
+            }
+            pkcs11_options.user_pin = aws_byte_cursor_from_buf(&pkcs11_pin);
+        }
+
+        napi_value node_slot_id = NULL;
+        if (napi_ok == napi_get_named_property(env, node_pkcs11_options, "slot_id", &node_slot_id)) {
+            if (!aws_napi_is_null_or_undefined(env, node_slot_id)) {
+                if (napi_ok != napi_get_value_int64(env, node_slot_id, (int64_t *)&pkcs11_slot_id)) {
+                    napi_throw_type_error(env, NULL, "PKCS#11 'slot_id' must be an int");
+                    goto cleanup;
+                }
+                pkcs11_options.slot_id = &pkcs11_slot_id;
+            }
+        }
+
+        /* clang-format off */
+
+        #define PARSE_PKCS11_OPTION_STR(property_name, option_cursor, storage_buffer) {                                \
+            napi_value node_property = NULL;                                                                           \
+            if (napi_ok == napi_get_named_property(env, node_pkcs11_options, property_name, &node_property)) {         \
+                if (!aws_napi_is_null_or_undefined(env, node_property)) {                                              \
+                    if (napi_ok != aws_byte_buf_init_from_napi(&storage_buffer, env, node_property)) {                 \
+                        napi_throw_type_error(                                                                         \
+                            env, NULL, "PKCS#11 '" property_name "' must be a string (or convertible to string)");     \
+                        goto cleanup;                                                                                  \
+                    }                                                                                                  \
+                    option_cursor = aws_byte_cursor_from_buf(&storage_buffer);                                         \
+                }                                                                                                      \
+            }                                                                                                          \
+        }
+        /* clang-format on */
+
+        PARSE_PKCS11_OPTION_STR("token_label", pkcs11_options.token_label, pkcs11_token_label);
+        PARSE_PKCS11_OPTION_STR("private_key_object_label", pkcs11_options.private_key_object_label, pkcs11_key_label);
+        PARSE_PKCS11_OPTION_STR("cert_file_path", pkcs11_options.cert_file_path, pkcs11_cert_path);
+        PARSE_PKCS11_OPTION_STR("cert_file_contents", pkcs11_options.cert_file_contents, pkcs11_cert_contents);
+    }
+
+    napi_value node_windows_cert_store_path = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_windows_cert_store_path)) {
+        windows_cert_store_path = aws_string_new_from_napi(env, node_windows_cert_store_path);
+        if (!windows_cert_store_path) {
+            napi_throw_type_error(env, NULL, "windows_cert_store_path must be a String (or convertible to a String)");
+            goto cleanup;
+        }
+    }
+
+    bool verify_peer = true;
+    napi_value node_verify_peer = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_verify_peer)) {
+        napi_value node_bool;
+        if (napi_ok != napi_coerce_to_bool(env, node_verify_peer, &node_bool)) {
+            napi_throw_type_error(env, NULL, "verify_peer must be a boolean (or convertible to a boolean)");
+            goto cleanup;
+        }
+
+        status = napi_get_value_bool(env, node_bool, &verify_peer);
+        AWS_FATAL_ASSERT(status == napi_ok);
+    }
+
+    bool use_cache = false;
+    if (num_args == AWS_ARRAY_SIZE(node_args)) {
+        napi_value node_use_cache = *arg++;
+        if (!aws_napi_is_null_or_undefined(env, node_use_cache)) {
+            napi_value node_bool;
+            if (napi_ok != napi_coerce_to_bool(env, node_use_cache, &node_bool)) {
+                napi_throw_type_error(env, NULL, "use_cache must be a boolean (or convertible to a boolean)");
+                goto cleanup;
+            }
+
+            status = napi_get_value_bool(env, node_bool, &use_cache);
+            AWS_FATAL_ASSERT(status == napi_ok);
+        }
+    }
+
+    /* PKCS#11 contexts are tied to a library handle and a token session, so they are never shared */
+    uint8_t cache_key[AWS_SHA256_LEN];
+    if (use_cache && !aws_napi_is_null_or_undefined(env, node_pkcs11_options)) {
+        use_cache = false;
+    }
+
+    if (use_cache) {
+        uint8_t version_and_verify[5];
+        struct aws_byte_buf version_and_verify_buf =
+            aws_byte_buf_from_empty_array(version_and_verify, sizeof(version_and_verify));
+        aws_byte_buf_write_be32(&version_and_verify_buf, min_tls_version);
+        aws_byte_buf_write_u8(&version_and_verify_buf, verify_peer);
+
+        const struct aws_byte_cursor fields[] = {
+            aws_byte_cursor_from_buf(&version_and_verify_buf),
+            s_optional_string_cursor(ca_file),
+            s_optional_string_cursor(ca_path),
+            aws_byte_cursor_from_buf(&ca_buf),
+            s_optional_string_cursor(alpn_list),
+            s_optional_string_cursor(cert_path),
+            aws_byte_cursor_from_buf(&certificate),
+            s_optional_string_cursor(pkey_path),
+            aws_byte_cursor_from_buf(&private_key),
+            s_optional_string_cursor(pkcs12_path),
+            aws_byte_cursor_from_buf(&pkcs12_pwd),
+            s_optional_string_cursor(windows_cert_store_path),
+        };
+
+        if (s_tls_ctx_cache_key_compute(alloc, fields, AWS_ARRAY_SIZE(fields), cache_key)) {
+            aws_napi_throw_last_error(env);
+            goto cleanup;
+        }
+
+        struct tls_ctx_cache_entry *entry = s_tls_ctx_cache_find_or_add(cache_key, NULL);
+        if (entry) {
+            result = s_tls_ctx_cached_external_new(env, entry);
+            goto cleanup;
+        }
+    }
+
+    if (certificate.buffer && private_key.buffer) {
+        struct aws_byte_cursor cert_cursor = aws_byte_cursor_from_buf(&certificate);
         struct aws_byte_cursor pkey_cursor = aws_byte_cursor_from_buf(&private_key);
         if (aws_tls_ctx_options_init_client_mtls(&ctx_options, alloc, &cert_cursor, &pkey_cursor)) {
             aws_napi_throw_last_error(env);
@@ -609,403 +1458,1067 @@ napi_value aws_napi_io_tls_ctx_new(napi_env env, napi_callback_info info) {
             aws_napi_throw_last_error(env);
             goto cleanup;
         }
-    } else if (windows_cert_store_path) {
-        if (aws_tls_ctx_options_init_client_mtls_from_system_path(
-                &ctx_options, alloc, aws_string_c_str(windows_cert_store_path))) {
-            aws_napi_throw_last_error(env);
-            goto cleanup;
+    } else if (windows_cert_store_path) {
+        if (aws_tls_ctx_options_init_client_mtls_from_system_path(
+                &ctx_options, alloc, aws_string_c_str(windows_cert_store_path))) {
+            aws_napi_throw_last_error(env);
+            goto cleanup;
+        }
+    } else {
+        aws_tls_ctx_options_init_default_client(&ctx_options, alloc);
+    }
+
+    if (ca_buf.buffer) {
+        struct aws_byte_cursor ca_cursor = aws_byte_cursor_from_buf(&ca_buf);
+        if (aws_tls_ctx_options_override_default_trust_store(&ctx_options, &ca_cursor)) {
+            aws_napi_throw_last_error(env);
+            goto cleanup;
+        }
+    } else if (ca_path || ca_file) {
+        if (aws_tls_ctx_options_override_default_trust_store_from_path(
+                &ctx_options, ca_path ? aws_string_c_str(ca_path) : NULL, ca_file ? aws_string_c_str(ca_file) : NULL)) {
+            aws_napi_throw_last_error(env);
+            goto cleanup;
+        }
+    }
+
+    if (alpn_list) {
+        aws_tls_ctx_options_set_alpn_list(&ctx_options, aws_string_c_str(alpn_list));
+    }
+
+    aws_tls_ctx_options_set_verify_peer(&ctx_options, verify_peer);
+
+    /*
+     * aws_tls_ctx_options has no settings for session tickets or a client session cache, and the channel handlers do
+     * not hand session state back to us, so every connection made with this context does a full handshake. What the
+     * context does carry is the parsed trust store and key material, so sharing one context across connections is
+     * the cheapest setup available from here.
+     */
+    struct aws_tls_ctx *tls_ctx = aws_tls_client_ctx_new(alloc, &ctx_options);
+    if (!tls_ctx) {
+        aws_napi_throw_last_error(env);
+        goto cleanup;
+    }
+
+    if (use_cache) {
+        /* if another thread cached a context for the same options in the meantime, that one is used instead */
+        struct tls_ctx_cache_entry *entry = s_tls_ctx_cache_find_or_add(cache_key, tls_ctx);
+        aws_tls_ctx_release(tls_ctx);
+        if (!entry) {
+            aws_napi_throw_last_error(env);
+            goto cleanup;
+        }
+
+        result = s_tls_ctx_cached_external_new(env, entry);
+        goto cleanup;
+    }
+
+    napi_value node_external;
+    if (napi_ok != napi_create_external(env, tls_ctx, s_tls_ctx_finalize, NULL, &node_external)) {
+        napi_throw_error(env, NULL, "Failed create n-api external");
+        goto cleanup;
+    }
+
+    result = node_external;
+
+cleanup:
+    aws_string_destroy_secure(pkcs12_path);
+    aws_byte_buf_clean_up_secure(&pkcs12_pwd);
+    aws_string_destroy_secure(cert_path);
+    aws_byte_buf_clean_up_secure(&certificate);
+    aws_string_destroy_secure(pkey_path);
+    aws_byte_buf_clean_up_secure(&private_key);
+    aws_byte_buf_clean_up_secure(&ca_buf);
+    aws_string_destroy(alpn_list);
+    aws_byte_buf_clean_up_secure(&pkcs11_pin);
+    aws_byte_buf_clean_up(&pkcs11_token_label);
+    aws_byte_buf_clean_up(&pkcs11_key_label);
+    aws_byte_buf_clean_up(&pkcs11_cert_path);
+    aws_byte_buf_clean_up(&pkcs11_cert_contents);
+    aws_string_destroy(windows_cert_store_path);
+    aws_tls_ctx_options_clean_up(&ctx_options);
+
+    return result;
+}
+
+void s_tls_connection_options_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+    (void)finalize_hint;
+    struct aws_tls_connection_options *tls_opts = finalize_data;
+    aws_tls_connection_options_clean_up(tls_opts);
+    aws_mem_release(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), tls_opts);
+}
+
+napi_value aws_napi_io_tls_connection_options_new(napi_env env, napi_callback_info info) {
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    napi_value *arg = &node_args[0];
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_tls_connection_options_new requires exactly 3 arguments");
+        return NULL;
+    }
+
+    napi_value node_external = NULL; /* return value, external that wraps the aws_tls_connection_options */
+    struct aws_string *server_name = NULL;
+    struct aws_string *alpn_list = NULL;
+
+    napi_value node_tls_ctx = *arg++;
+    struct aws_tls_ctx *tls_ctx = NULL;
+    AWS_NAPI_CALL(env, napi_get_value_external(env, node_tls_ctx, (void **)&tls_ctx), {
+        AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "Unable to extract aws_tls_ctx from tls_ctx external"));
+        return NULL;
+    });
+
+    napi_value node_server_name = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_server_name)) {
+        server_name = aws_string_new_from_napi(env, node_server_name);
+        if (!server_name) {
+            AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "Unable to convert server_name to string"));
+            goto cleanup;
+        }
+    }
+
+    napi_value node_alpn_list = *arg++;
+    if (!aws_napi_is_null_or_undefined(env, node_alpn_list)) {
+        alpn_list = aws_string_new_from_napi(env, node_alpn_list);
+        if (!alpn_list) {
+            AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "Unable to convert alpn_list to string"));
+            goto cleanup;
+        }
+    }
+
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+    struct aws_tls_connection_options *tls_opts =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_tls_connection_options));
+    AWS_FATAL_ASSERT(tls_opts && "Failed to allocate new aws_tls_connection_options");
+
+    aws_tls_connection_options_init_from_ctx(tls_opts, tls_ctx);
+
+    if (server_name) {
+        struct aws_byte_cursor server_name_cursor = aws_byte_cursor_from_string(server_name);
+        aws_tls_connection_options_set_server_name(tls_opts, allocator, &server_name_cursor);
+    }
+
+    if (alpn_list) {
+        aws_tls_connection_options_set_alpn_list(tls_opts, allocator, aws_string_c_str(alpn_list));
+    }
+
+    AWS_NAPI_CALL(env, napi_create_external(env, tls_opts, s_tls_connection_options_finalize, NULL, &node_external), {
+        goto cleanup;
+    });
+
+cleanup:
+    aws_string_destroy(server_name);
+    aws_string_destroy(alpn_list);
+    return node_external;
+}
+
+void s_socket_options_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+    (void)finalize_hint;
+
+    struct aws_socket_options *socket_options = finalize_data;
+    aws_mem_release(aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO), socket_options);
+}
+
+napi_value aws_napi_io_socket_options_new(napi_env env, napi_callback_info info) {
+    napi_value node_args[7];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_socket_options_new requires exactly 7 arguments");
+        return NULL;
+    }
+
+    struct aws_socket_options options;
+
+    uint32_t enum_value = 0;
+    if (napi_get_value_uint32(env, node_args[0], &enum_value) || enum_value > AWS_SOCKET_DGRAM) {
+        napi_throw_type_error(env, NULL, "First argument (type) must be a Number between 0 and 1");
+        return NULL;
+    }
+    options.type = (enum aws_socket_type)enum_value;
+
+    if (napi_get_value_uint32(env, node_args[1], &enum_value) || enum_value > AWS_SOCKET_LOCAL) {
+        napi_throw_type_error(env, NULL, "Second argument (domain) must be a Number between 0 and 2");
+        return NULL;
+    }
+    options.domain = (enum aws_socket_domain)enum_value;
+
+    if (napi_get_value_uint32(env, node_args[2], &enum_value) || enum_value > UINT16_MAX) {
+        napi_throw_type_error(env, NULL, "Third argument (connect_timeout_ms) must be a Number");
+        return NULL;
+    }
+    options.connect_timeout_ms = (uint16_t)enum_value;
+
+    uint32_t keep_alive_interval_sec;
+    if (napi_get_value_uint32(env, node_args[3], &keep_alive_interval_sec)) {
+        napi_throw_type_error(
+            env, NULL, "Fourth argument (keep_alive_interval_sec) must be a Number between 0 and 32767");
+        return NULL;
+    }
+    options.keep_alive_interval_sec = (keep_alive_interval_sec > 0x7fff) ? 0x7fff : (uint16_t)keep_alive_interval_sec;
+
+    uint32_t keep_alive_timeout_sec;
+    if (napi_get_value_uint32(env, node_args[4], &keep_alive_timeout_sec)) {
+        napi_throw_type_error(
+            env, NULL, "Fifth argument (keep_alive_timeout_sec) must be a Number between 0 and 32767");
+        return NULL;
+    }
+    options.keep_alive_timeout_sec = (keep_alive_timeout_sec > 0x7fff) ? 0x7fff : (uint16_t)keep_alive_timeout_sec;
+
+    uint32_t keep_alive_max_failed_probes;
+    if (napi_get_value_uint32(env, node_args[5], &keep_alive_max_failed_probes)) {
+        napi_throw_type_error(
+            env, NULL, "Sixth argument (keep_alive_max_failed_probes) must be a Number between 0 and 32767");
+        return NULL;
+    }
+    options.keep_alive_max_failed_probes =
+        (keep_alive_max_failed_probes > 0x7fff) ? 0x7fff : (uint16_t)keep_alive_max_failed_probes;
+
+    if (napi_get_value_bool(env, node_args[6], &options.keepalive)) {
+        napi_throw_type_error(env, NULL, "Seventh argument (keepalive) must be a Boolean value");
+        return NULL;
+    }
+
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+    struct aws_socket_options *socket_options = aws_mem_acquire(allocator, sizeof(struct aws_socket_options));
+    if (!socket_options) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+
+    *socket_options = options;
+
+    napi_value node_external;
+    if (napi_create_external(env, socket_options, s_socket_options_finalize, NULL, &node_external)) {
+        aws_mem_release(allocator, socket_options);
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+
+    return node_external;
+}
+
+/*
+ * Data appended from node is copied into a list of chunks. Reads copy out of the chunk at the read position and
+ * advance its offset, so the cost of a read is proportional to the bytes it returns rather than to the amount of data
+ * still buffered. Chunks that have been fully consumed are kept around for as long as they fit in the replay window,
+ * so that a request can seek back and send the body again, then released from the front of the list.
+ */
+struct aws_napi_input_stream_chunk {
+    struct aws_linked_list_node node;
+    uint8_t *data;
+    size_t capacity;
+    size_t len;
+    size_t offset; /* bytes already consumed by the reader */
+};
+
+struct aws_napi_input_stream_impl {
+    /* this MUST be the first member, allows polymorphism with aws_input_stream* */
+    struct aws_input_stream base;
+    struct aws_allocator *allocator;
+    struct aws_linked_list chunks;
+    struct aws_linked_list_node *read_node; /* chunk holding the next unread byte, NULL when everything is read */
+    struct aws_mutex mutex;
+    size_t chunk_size;      /* minimum size of a chunk, small appends are coalesced up to this size */
+    size_t buffered;        /* bytes appended but not yet consumed by the reader */
+    uint64_t bytes_read;    /* bytes already consumed by the reader */
+    uint64_t window_start;  /* stream offset of the first byte still held, the earliest seek position */
+    uint64_t replay_window; /* most consumed bytes to keep around for seeking backwards */
+    bool eos;               /* end of stream */
+
+    /*
+     * Flow control. Once more than high_watermark bytes are buffered, append tells node to pause the source. When
+     * reads bring the buffer back down to low_watermark, on_resume is queued to start it again. A high_watermark of
+     * 0 disables flow control.
+     */
+    size_t high_watermark;
+    size_t low_watermark;
+    bool paused;
+    napi_threadsafe_function on_resume;
+};
+
+static void s_input_stream_chunk_destroy(
+    struct aws_napi_input_stream_impl *impl,
+    struct aws_napi_input_stream_chunk *chunk) {
+
+    aws_linked_list_remove(&chunk->node);
+    aws_mem_release(impl->allocator, chunk);
+}
+
+static struct aws_napi_input_stream_chunk *s_input_stream_chunk_new(
+    struct aws_napi_input_stream_impl *impl,
+    size_t capacity) {
+
+    /* the data lives in the same allocation, directly after the header */
+    struct aws_napi_input_stream_chunk *chunk =
+        aws_mem_acquire(impl->allocator, sizeof(struct aws_napi_input_stream_chunk) + capacity);
+    if (!chunk) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*chunk);
+
+    chunk->data = (uint8_t *)(chunk + 1);
+    chunk->capacity = capacity;
+    aws_linked_list_push_back(&impl->chunks, &chunk->node);
+    return chunk;
+}
+
+/* Releases consumed chunks from the front of the list for as long as the consumed bytes behind them still cover the
+ * whole replay window. Must be called with the mutex held. */
+static void s_input_stream_trim_locked(struct aws_napi_input_stream_impl *impl) {
+    while (!aws_linked_list_empty(&impl->chunks)) {
+        struct aws_linked_list_node *front = aws_linked_list_front(&impl->chunks);
+        if (front == impl->read_node) {
+            break;
+        }
+
+        /* everything ahead of the read position has been consumed */
+        struct aws_napi_input_stream_chunk *chunk = AWS_CONTAINER_OF(front, struct aws_napi_input_stream_chunk, node);
+        if (impl->bytes_read - (impl->window_start + chunk->len) < impl->replay_window) {
+            break;
         }
-    } else {
-        aws_tls_ctx_options_init_default_client(&ctx_options, alloc);
+
+        impl->window_start += chunk->len;
+        s_input_stream_chunk_destroy(impl, chunk);
     }
+}
 
-    if (ca_buf.buffer) {
-        struct aws_byte_cursor ca_cursor = aws_byte_cursor_from_buf(&ca_buf);
-        if (aws_tls_ctx_options_override_default_trust_store(&ctx_options, &ca_cursor)) {
-            aws_napi_throw_last_error(env);
-            goto cleanup;
+/* Consumes up to length bytes from the read position, copying them to dest if it is not NULL. Must be called with
+ * the mutex held. Returns the number of bytes consumed. */
+static size_t s_input_stream_consume_locked(
+    struct aws_napi_input_stream_impl *impl,
+    struct aws_byte_buf *dest,
+    size_t length) {
+
+    size_t consumed = 0;
+    while (consumed < length && impl->read_node) {
+        struct aws_napi_input_stream_chunk *chunk =
+            AWS_CONTAINER_OF(impl->read_node, struct aws_napi_input_stream_chunk, node);
+
+        size_t available = chunk->len - chunk->offset;
+        size_t to_consume = aws_min_size(available, length - consumed);
+        if (dest) {
+            aws_byte_buf_write(dest, chunk->data + chunk->offset, to_consume);
         }
-    } else if (ca_path || ca_file) {
-        if (aws_tls_ctx_options_override_default_trust_store_from_path(
-                &ctx_options, ca_path ? aws_string_c_str(ca_path) : NULL, ca_file ? aws_string_c_str(ca_file) : NULL)) {
-            aws_napi_throw_last_error(env);
-            goto cleanup;
+        chunk->offset += to_consume;
+        consumed += to_consume;
+
+        if (chunk->offset == chunk->len) {
+            struct aws_linked_list_node *next = aws_linked_list_next(impl->read_node);
+            impl->read_node = next != aws_linked_list_end(&impl->chunks) ? next : NULL;
         }
     }
 
-    if (alpn_list) {
-        aws_tls_ctx_options_set_alpn_list(&ctx_options, aws_string_c_str(alpn_list));
+    impl->buffered -= consumed;
+    impl->bytes_read += consumed;
+    s_input_stream_trim_locked(impl);
+
+    if (impl->paused && impl->buffered <= impl->low_watermark) {
+        impl->paused = false;
+        if (impl->on_resume) {
+            /* the stream must outlive the queued call, which releases this reference */
+            aws_input_stream_acquire(&impl->base);
+            if (aws_napi_queue_threadsafe_function(impl->on_resume, impl) != napi_ok) {
+                /* node is shutting down, nobody is left to resume */
+                aws_input_stream_release(&impl->base);
+            }
+        }
     }
 
-    aws_tls_ctx_options_set_verify_peer(&ctx_options, verify_peer);
+    return consumed;
+}
 
-    struct aws_tls_ctx *tls_ctx = aws_tls_client_ctx_new(alloc, &ctx_options);
-    if (!tls_ctx) {
-        aws_napi_throw_last_error(env);
-        goto cleanup;
+/* Moves the read position back by length bytes, which must all still be held. Must be called with the mutex held. */
+static void s_input_stream_rewind_locked(struct aws_napi_input_stream_impl *impl, uint64_t length) {
+    AWS_ASSERT(length <= impl->bytes_read - impl->window_start);
+
+    struct aws_linked_list_node *node = impl->read_node ? impl->read_node : aws_linked_list_back(&impl->chunks);
+    uint64_t remaining = length;
+    while (remaining > 0) {
+        struct aws_napi_input_stream_chunk *chunk = AWS_CONTAINER_OF(node, struct aws_napi_input_stream_chunk, node);
+        if (chunk->offset >= remaining) {
+            chunk->offset -= (size_t)remaining;
+            break;
+        }
+
+        remaining -= chunk->offset;
+        chunk->offset = 0;
+        node = aws_linked_list_prev(node);
     }
 
-    napi_value node_external;
-    if (napi_ok != napi_create_external(env, tls_ctx, s_tls_ctx_finalize, NULL, &node_external)) {
-        napi_throw_error(env, NULL, "Failed create n-api external");
-        goto cleanup;
+    impl->read_node = node;
+    impl->buffered += (size_t)length;
+    impl->bytes_read -= length;
+}
+
+static int s_input_stream_seek(struct aws_input_stream *stream, int64_t offset, enum aws_stream_seek_basis basis) {
+    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
+
+    int result = AWS_OP_SUCCESS;
+    uint64_t position = 0;
+
+    aws_mutex_lock(&impl->mutex);
+    uint64_t total_bytes = impl->bytes_read + impl->buffered;
+
+    switch (basis) {
+        case AWS_SSB_BEGIN:
+            if (offset < 0) {
+                result = aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+                goto failed;
+            }
+            position = (uint64_t)offset;
+            break;
+        case AWS_SSB_END:
+            if (offset > 0 || offset == INT64_MIN || (uint64_t)(-offset) > total_bytes) {
+                result = aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+                goto failed;
+            }
+            position = total_bytes - (uint64_t)(-offset);
+            break;
+        default:
+            result = aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            goto failed;
     }
 
-    result = node_external;
+    /* The position must not be past what has been appended so far, and must not be before the start of the replay
+     * window, because those bytes have been released */
+    if (position > total_bytes || position < impl->window_start) {
+        result = aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+        goto failed;
+    }
 
-cleanup:
-    aws_string_destroy_secure(pkcs12_path);
-    aws_byte_buf_clean_up_secure(&pkcs12_pwd);
-    aws_string_destroy_secure(cert_path);
-    aws_byte_buf_clean_up_secure(&certificate);
-    aws_string_destroy_secure(pkey_path);
-    aws_byte_buf_clean_up_secure(&private_key);
-    aws_byte_buf_clean_up_secure(&ca_buf);
-    aws_string_destroy(alpn_list);
-    aws_byte_buf_clean_up_secure(&pkcs11_pin);
-    aws_byte_buf_clean_up(&pkcs11_token_label);
-    aws_byte_buf_clean_up(&pkcs11_key_label);
-    aws_byte_buf_clean_up(&pkcs11_cert_path);
-    aws_byte_buf_clean_up(&pkcs11_cert_contents);
-    aws_string_destroy(windows_cert_store_path);
-    aws_tls_ctx_options_clean_up(&ctx_options);
+    if (position >= impl->bytes_read) {
+        s_input_stream_consume_locked(impl, NULL, (size_t)(position - impl->bytes_read));
+    } else {
+        s_input_stream_rewind_locked(impl, impl->bytes_read - position);
+    }
+
+failed:
+    aws_mutex_unlock(&impl->mutex);
+    return result;
+}
+
+static int s_input_stream_read(struct aws_input_stream *stream, struct aws_byte_buf *dest) {
+    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
+
+    aws_mutex_lock(&impl->mutex);
+    s_input_stream_consume_locked(impl, dest, dest->capacity - dest->len);
+    aws_mutex_unlock(&impl->mutex);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_input_stream_get_status(struct aws_input_stream *stream, struct aws_stream_status *status) {
+    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
+    aws_mutex_lock(&impl->mutex);
+    status->is_end_of_stream = impl->eos && impl->buffered == 0;
+    aws_mutex_unlock(&impl->mutex);
+    status->is_valid = true;
+    return AWS_OP_SUCCESS;
+}
 
+static int s_input_stream_get_length(struct aws_input_stream *stream, int64_t *out_length) {
+    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
+
+    /* the length is only known once the source has ended */
+    int result = AWS_OP_SUCCESS;
+    aws_mutex_lock(&impl->mutex);
+    if (impl->eos) {
+        *out_length = (int64_t)(impl->bytes_read + impl->buffered);
+    } else {
+        result = aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+    }
+    aws_mutex_unlock(&impl->mutex);
     return result;
 }
 
-void s_tls_connection_options_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+static void s_input_stream_on_resume_call(napi_env env, napi_value on_resume, void *context, void *user_data) {
+    (void)context;
+    struct aws_napi_input_stream_impl *impl = user_data;
+
+    /* on_resume is only cleared on the node thread, so it cannot change underneath this call */
+    if (env && impl->on_resume) {
+        AWS_NAPI_ENSURE(env, aws_napi_dispatch_threadsafe_function(env, impl->on_resume, NULL, on_resume, 0, NULL));
+    }
+
+    aws_input_stream_release(&impl->base);
+}
+
+/* Must be called from the node thread */
+static void s_input_stream_release_on_resume(struct aws_napi_input_stream_impl *impl) {
+    aws_mutex_lock(&impl->mutex);
+    napi_threadsafe_function on_resume = impl->on_resume;
+    impl->on_resume = NULL;
+    aws_mutex_unlock(&impl->mutex);
+
+    if (on_resume) {
+        AWS_NAPI_ENSURE(NULL, aws_napi_release_threadsafe_function(on_resume, napi_tsfn_abort));
+    }
+}
+
+static void s_input_stream_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
     (void)env;
     (void)finalize_hint;
-    struct aws_tls_connection_options *tls_opts = finalize_data;
-    aws_tls_connection_options_clean_up(tls_opts);
-    aws_mem_release(aws_napi_get_allocator(), tls_opts);
+
+    struct aws_napi_input_stream_impl *impl = finalize_data;
+    s_input_stream_release_on_resume(impl);
+
+    /* Any request using the stream holds its own reference */
+    aws_input_stream_release(&impl->base);
 }
 
-napi_value aws_napi_io_tls_connection_options_new(napi_env env, napi_callback_info info) {
-    napi_value node_args[3];
+static void s_input_stream_destroy(struct aws_napi_input_stream_impl *impl) {
+    struct aws_allocator *allocator = impl->allocator;
+    while (!aws_linked_list_empty(&impl->chunks)) {
+        s_input_stream_chunk_destroy(
+            impl, AWS_CONTAINER_OF(aws_linked_list_front(&impl->chunks), struct aws_napi_input_stream_chunk, node));
+    }
+    aws_mutex_clean_up(&impl->mutex);
+    aws_mem_release(allocator, impl);
+}
+
+static struct aws_input_stream_vtable s_input_stream_vtable = {
+    .seek = s_input_stream_seek,
+    .read = s_input_stream_read,
+    .get_status = s_input_stream_get_status,
+    .get_length = s_input_stream_get_length,
+};
+
+napi_value aws_napi_io_input_stream_new(napi_env env, napi_callback_info info) {
+    napi_value node_args[5];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
-    napi_value *arg = &node_args[0];
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retrieve callback information");
         return NULL;
     }
-    if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "io_tls_connection_options_new requires exactly 3 arguments");
+    if (num_args != 1 && num_args != 4 && num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_input_stream_new requires exactly 1, 4 or 5 arguments");
         return NULL;
     }
 
-    napi_value node_external = NULL; /* return value, external that wraps the aws_tls_connection_options */
-    struct aws_string *server_name = NULL;
-    struct aws_string *alpn_list = NULL;
-
-    napi_value node_tls_ctx = *arg++;
-    struct aws_tls_ctx *tls_ctx = NULL;
-    AWS_NAPI_CALL(env, napi_get_value_external(env, node_tls_ctx, (void **)&tls_ctx), {
-        AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "Unable to extract aws_tls_ctx from tls_ctx external"));
+    int64_t capacity = 0;
+    if (napi_get_value_int64(env, node_args[0], &capacity)) {
+        napi_throw_error(env, NULL, "capacity must be a number");
         return NULL;
-    });
+    }
+    if (capacity <= 0) {
+        napi_throw_error(env, NULL, "capacity must be a positive number");
+        return NULL;
+    }
 
-    napi_value node_server_name = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_server_name)) {
-        server_name = aws_string_new_from_napi(env, node_server_name);
-        if (!server_name) {
-            AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "Unable to convert server_name to string"));
-            goto cleanup;
+    int64_t high_watermark = 0;
+    int64_t low_watermark = 0;
+    napi_value node_on_resume = NULL;
+    if (num_args >= 4) {
+        if (napi_get_value_int64(env, node_args[1], &high_watermark) ||
+            napi_get_value_int64(env, node_args[2], &low_watermark)) {
+            napi_throw_error(env, NULL, "high_watermark and low_watermark must be numbers");
+            return NULL;
+        }
+        if (low_watermark < 0 || high_watermark < low_watermark) {
+            napi_throw_error(env, NULL, "low_watermark must be between 0 and high_watermark");
+            return NULL;
+        }
+        if (!aws_napi_is_null_or_undefined(env, node_args[3])) {
+            node_on_resume = node_args[3];
         }
     }
 
-    napi_value node_alpn_list = *arg++;
-    if (!aws_napi_is_null_or_undefined(env, node_alpn_list)) {
-        alpn_list = aws_string_new_from_napi(env, node_alpn_list);
-        if (!alpn_list) {
-            AWS_NAPI_ENSURE(env, napi_throw_type_error(env, NULL, "Unable to convert alpn_list to string"));
-            goto cleanup;
+    int64_t replay_window = 0;
+    if (num_args == AWS_ARRAY_SIZE(node_args) && !aws_napi_is_null_or_undefined(env, node_args[4])) {
+        if (napi_get_value_int64(env, node_args[4], &replay_window) || replay_window < 0) {
+            napi_throw_error(env, NULL, "replay_window must be a non-negative number");
+            return NULL;
         }
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
-    struct aws_tls_connection_options *tls_opts =
-        aws_mem_calloc(allocator, 1, sizeof(struct aws_tls_connection_options));
-    AWS_FATAL_ASSERT(tls_opts && "Failed to allocate new aws_tls_connection_options");
-
-    aws_tls_connection_options_init_from_ctx(tls_opts, tls_ctx);
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+    struct aws_napi_input_stream_impl *impl = aws_mem_calloc(allocator, 1, sizeof(struct aws_napi_input_stream_impl));
+    if (!impl) {
+        napi_throw_error(env, NULL, "Unable to allocate native aws_input_stream");
+        return NULL;
+    }
 
-    if (server_name) {
-        struct aws_byte_cursor server_name_cursor = aws_byte_cursor_from_string(server_name);
-        aws_tls_connection_options_set_server_name(tls_opts, allocator, &server_name_cursor);
+    impl->base.vtable = &s_input_stream_vtable;
+    impl->allocator = allocator;
+    impl->chunk_size = (size_t)aws_min_u64((uint64_t)capacity, SIZE_MAX);
+    impl->replay_window = (uint64_t)replay_window;
+    aws_linked_list_init(&impl->chunks);
+    aws_ref_count_init(&impl->base.ref_count, impl, (aws_simple_completion_callback *)s_input_stream_destroy);
+    if (aws_mutex_init(&impl->mutex)) {
+        aws_napi_throw_last_error(env);
+        goto failed;
     }
 
-    if (alpn_list) {
-        aws_tls_connection_options_set_alpn_list(tls_opts, allocator, aws_string_c_str(alpn_list));
+    /* without a way to resume the source there is no point pausing it */
+    if (node_on_resume && high_watermark > 0) {
+        impl->high_watermark = (size_t)aws_min_u64((uint64_t)high_watermark, SIZE_MAX);
+        impl->low_watermark = (size_t)aws_min_u64((uint64_t)low_watermark, SIZE_MAX);
+
+        AWS_NAPI_CALL(
+            env,
+            aws_napi_create_threadsafe_function(
+                env,
+                node_on_resume,
+                "aws_input_stream_on_resume",
+                s_input_stream_on_resume_call,
+                impl,
+                &impl->on_resume),
+            {
+                napi_throw_error(env, NULL, "Unable to create threadsafe function for on_resume");
+                goto failed;
+            });
+
+        /* a paused upload should not keep node alive on its own */
+        AWS_NAPI_CALL(env, aws_napi_unref_threadsafe_function(env, impl->on_resume), {
+            napi_throw_error(env, NULL, "Unable to unref on_resume");
+            goto failed;
+        });
     }
 
-    AWS_NAPI_CALL(env, napi_create_external(env, tls_opts, s_tls_connection_options_finalize, NULL, &node_external), {
-        goto cleanup;
-    });
+    napi_value node_external = NULL;
+    if (napi_create_external(env, impl, s_input_stream_finalize, NULL, &node_external)) {
+        napi_throw_error(env, NULL, "Unable to create external for native aws_input_stream");
+        goto failed;
+    }
 
-cleanup:
-    aws_string_destroy(server_name);
-    aws_string_destroy(alpn_list);
     return node_external;
-}
 
-void s_socket_options_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
-    (void)env;
-    (void)finalize_hint;
+failed:
+    if (impl) {
+        s_input_stream_release_on_resume(impl);
+        aws_input_stream_release(&impl->base);
+    }
 
-    struct aws_socket_options *socket_options = finalize_data;
-    aws_mem_release(aws_napi_get_allocator(), socket_options);
+    return NULL;
 }
 
-napi_value aws_napi_io_socket_options_new(napi_env env, napi_callback_info info) {
-    napi_value node_args[7];
+napi_value aws_napi_io_input_stream_append(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retrieve callback information");
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "io_socket_options_new requires exactly 7 arguments");
+        napi_throw_error(env, NULL, "io_input_stream_append requires exactly 2 arguments");
         return NULL;
     }
 
-    struct aws_socket_options options;
-
-    uint32_t enum_value = 0;
-    if (napi_get_value_uint32(env, node_args[0], &enum_value) || enum_value > AWS_SOCKET_DGRAM) {
-        napi_throw_type_error(env, NULL, "First argument (type) must be a Number between 0 and 1");
+    struct aws_napi_input_stream_impl *impl = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&impl)) {
+        napi_throw_error(env, NULL, "stream must be a node external");
         return NULL;
     }
-    options.type = (enum aws_socket_type)enum_value;
 
-    if (napi_get_value_uint32(env, node_args[1], &enum_value) || enum_value > AWS_SOCKET_LOCAL) {
-        napi_throw_type_error(env, NULL, "Second argument (domain) must be a Number between 0 and 2");
-        return NULL;
-    }
-    options.domain = (enum aws_socket_domain)enum_value;
+    /* null means end of stream */
+    if (aws_napi_is_null_or_undefined(env, node_args[1])) {
+        aws_mutex_lock(&impl->mutex);
+        impl->eos = true;
+        impl->paused = false;
+        aws_mutex_unlock(&impl->mutex);
 
-    if (napi_get_value_uint32(env, node_args[2], &enum_value) || enum_value > UINT16_MAX) {
-        napi_throw_type_error(env, NULL, "Third argument (connect_timeout_ms) must be a Number");
+        /* The source has nothing more to give, and on_resume keeps it reachable from a GC root */
+        s_input_stream_release_on_resume(impl);
         return NULL;
     }
-    options.connect_timeout_ms = (uint16_t)enum_value;
 
-    uint32_t keep_alive_interval_sec;
-    if (napi_get_value_uint32(env, node_args[3], &keep_alive_interval_sec)) {
-        napi_throw_type_error(
-            env, NULL, "Fourth argument (keep_alive_interval_sec) must be a Number between 0 and 32767");
+    /* not null or undefined, so it should be a buffer */
+    bool is_buffer = false;
+    if (napi_is_buffer(env, node_args[1], &is_buffer) || !is_buffer) {
+        napi_throw_error(env, NULL, "buffer must be a valid Buffer object or undefined/null");
         return NULL;
     }
-    options.keep_alive_interval_sec = (keep_alive_interval_sec > 0x7fff) ? 0x7fff : (uint16_t)keep_alive_interval_sec;
 
-    uint32_t keep_alive_timeout_sec;
-    if (napi_get_value_uint32(env, node_args[4], &keep_alive_timeout_sec)) {
-        napi_throw_type_error(
-            env, NULL, "Fifth argument (keep_alive_timeout_sec) must be a Number between 0 and 32767");
+    struct aws_byte_cursor data;
+    if (napi_get_buffer_info(env, node_args[1], (void **)&data.ptr, &data.len)) {
+        napi_throw_error(env, NULL, "Unable to extract data from buffer");
         return NULL;
     }
-    options.keep_alive_timeout_sec = (keep_alive_timeout_sec > 0x7fff) ? 0x7fff : (uint16_t)keep_alive_timeout_sec;
 
-    uint32_t keep_alive_max_failed_probes;
-    if (napi_get_value_uint32(env, node_args[5], &keep_alive_max_failed_probes)) {
-        napi_throw_type_error(
-            env, NULL, "Sixth argument (keep_alive_max_failed_probes) must be a Number between 0 and 32767");
-        return NULL;
+    bool pause = false;
+    if (data.len == 0) {
+        goto done;
     }
-    options.keep_alive_max_failed_probes =
-        (keep_alive_max_failed_probes > 0x7fff) ? 0x7fff : (uint16_t)keep_alive_max_failed_probes;
 
-    if (napi_get_value_bool(env, node_args[6], &options.keepalive)) {
-        napi_throw_type_error(env, NULL, "Seventh argument (keepalive) must be a Boolean value");
-        return NULL;
-    }
+    aws_mutex_lock(&impl->mutex);
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
-    struct aws_socket_options *socket_options = aws_mem_acquire(allocator, sizeof(struct aws_socket_options));
-    if (!socket_options) {
-        aws_napi_throw_last_error(env);
-        return NULL;
+    /* Top up the tail chunk if it has room, so that a source producing many small buffers does not turn into a long
+     * list of tiny allocations */
+    if (!aws_linked_list_empty(&impl->chunks)) {
+        struct aws_napi_input_stream_chunk *tail =
+            AWS_CONTAINER_OF(aws_linked_list_back(&impl->chunks), struct aws_napi_input_stream_chunk, node);
+        size_t to_copy = aws_min_size(tail->capacity - tail->len, data.len);
+        if (to_copy > 0) {
+            memcpy(tail->data + tail->len, data.ptr, to_copy);
+            tail->len += to_copy;
+            impl->buffered += to_copy;
+            aws_byte_cursor_advance(&data, to_copy);
+            if (!impl->read_node) {
+                impl->read_node = &tail->node;
+            }
+        }
     }
 
-    *socket_options = options;
+    if (data.len > 0) {
+        struct aws_napi_input_stream_chunk *chunk =
+            s_input_stream_chunk_new(impl, aws_max_size(impl->chunk_size, data.len));
+        if (!chunk) {
+            aws_mutex_unlock(&impl->mutex);
+            aws_napi_throw_last_error(env);
+            return NULL;
+        }
+        memcpy(chunk->data, data.ptr, data.len);
+        chunk->len = data.len;
+        impl->buffered += data.len;
+        if (!impl->read_node) {
+            impl->read_node = &chunk->node;
+        }
+    }
 
-    napi_value node_external;
-    if (napi_create_external(env, socket_options, s_socket_options_finalize, NULL, &node_external)) {
-        aws_mem_release(allocator, socket_options);
-        aws_napi_throw_last_error(env);
-        return NULL;
+    if (impl->on_resume && impl->buffered > impl->high_watermark) {
+        impl->paused = true;
     }
+    pause = impl->paused;
 
-    return node_external;
+    aws_mutex_unlock(&impl->mutex);
+
+done:;
+    /* tell node whether to pause the source until on_resume is called */
+    napi_value node_pause = NULL;
+    AWS_NAPI_ENSURE(env, napi_get_boolean(env, pause, &node_pause));
+    return node_pause;
 }
 
-struct aws_napi_input_stream_impl {
+/*
+ * A stream over a byte range of a file, read either through the file system or, where supported, from a private
+ * read-only mapping of the file. Either way the data never passes through node.
+ */
+struct aws_napi_file_stream_impl {
     /* this MUST be the first member, allows polymorphism with aws_input_stream* */
     struct aws_input_stream base;
-    struct aws_byte_buf buffer;
-    struct aws_byte_cursor cursor;
-    struct aws_mutex mutex;
-    size_t bytes_read; /* bytes already consumed by the reader, flushed from the buffer */
-    bool eos;          /* end of stream */
+    struct aws_allocator *allocator;
+    struct aws_input_stream *source; /* stream over the whole file */
+    uint64_t start;                  /* offset of the range within the file */
+    uint64_t length;                 /* length of the range */
+    uint64_t position;               /* read position within the range */
+    void *mapping;                   /* mapped file contents, if the file was mapped */
+    size_t mapping_size;
 };
 
-static int s_input_stream_seek(struct aws_input_stream *stream, int64_t offset, enum aws_stream_seek_basis basis) {
-    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
-
-    int result = AWS_OP_SUCCESS;
-    uint64_t final_offset = 0;
-
-    aws_mutex_lock(&impl->mutex);
-    uint64_t total_bytes = impl->bytes_read + impl->buffer.len;
+static int s_file_stream_seek(struct aws_input_stream *stream, int64_t offset, enum aws_stream_seek_basis basis) {
+    struct aws_napi_file_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_file_stream_impl, base);
 
+    uint64_t position = 0;
     switch (basis) {
         case AWS_SSB_BEGIN:
-            /* Offset must be positive, must be greater than the bytes already read (because those
-             * bytes are gone from the buffer), and must not be greater than the sum of the bytes
-             * read so far and the size of the buffer
-             */
-            if (offset < 0 || (uint64_t)offset > total_bytes || (uint64_t)offset < impl->bytes_read) {
-                result = aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
-                goto failed;
+            if (offset < 0 || (uint64_t)offset > impl->length) {
+                return aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
             }
-            final_offset = (uint64_t)offset - impl->bytes_read;
+            position = (uint64_t)offset;
             break;
         case AWS_SSB_END:
-            /* Offset must be negative, and must not be trying to go further back than the
-             * current length of the buffer, because those bytes have been purged
-             */
-            if (offset > 0 || offset == INT64_MIN || (uint64_t)(-offset) > impl->buffer.len) {
-                result = aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
-                goto failed;
+            if (offset > 0 || offset == INT64_MIN || (uint64_t)(-offset) > impl->length) {
+                return aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
             }
-            final_offset = (uint64_t)impl->buffer.len - (uint64_t)(-offset);
+            position = impl->length - (uint64_t)(-offset);
             break;
         default:
-            result = aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-            goto failed;
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
-    AWS_ASSERT(final_offset <= SIZE_MAX);
-    size_t buf_offset = (size_t)final_offset;
-    AWS_ASSERT(buf_offset <= impl->buffer.len);
-
-    if (buf_offset == impl->buffer.len) {
-        impl->bytes_read += impl->buffer.len;
-        impl->buffer.len = 0;
-    } else if (buf_offset > 0) {
-        size_t new_len = impl->buffer.len - buf_offset;
-        memmove(impl->buffer.buffer, impl->buffer.buffer + buf_offset, new_len);
-        impl->buffer.len = new_len;
+    /* the range was validated against the file length, which fits in an int64_t */
+    if (aws_input_stream_seek(impl->source, (int64_t)(impl->start + position), AWS_SSB_BEGIN)) {
+        return AWS_OP_ERR;
     }
 
-failed:
-    aws_mutex_unlock(&impl->mutex);
-    return result;
+    impl->position = position;
+    return AWS_OP_SUCCESS;
 }
 
-static int s_input_stream_read(struct aws_input_stream *stream, struct aws_byte_buf *dest) {
-    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
+static int s_file_stream_read(struct aws_input_stream *stream, struct aws_byte_buf *dest) {
+    struct aws_napi_file_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_file_stream_impl, base);
 
-    size_t bytes_to_read = dest->capacity - dest->len;
-    if (bytes_to_read > impl->buffer.len) {
-        bytes_to_read = impl->buffer.len;
+    size_t to_read = (size_t)aws_min_u64(dest->capacity - dest->len, impl->length - impl->position);
+    if (to_read == 0) {
+        return AWS_OP_SUCCESS;
     }
 
-    aws_mutex_lock(&impl->mutex);
-    if (!aws_byte_buf_write(dest, impl->buffer.buffer, bytes_to_read)) {
-        aws_mutex_unlock(&impl->mutex);
+    /* read into a window of dest so the source cannot run past the end of the range */
+    struct aws_byte_buf window = aws_byte_buf_from_empty_array(dest->buffer + dest->len, to_read);
+    if (aws_input_stream_read(impl->source, &window)) {
         return AWS_OP_ERR;
     }
-    aws_mutex_unlock(&impl->mutex);
 
-    /* seek the stream past what's been read to advance the buffer/bytes_read */
-    aws_input_stream_seek(&impl->base, impl->bytes_read + bytes_to_read, AWS_SSB_BEGIN);
+    dest->len += window.len;
+    impl->position += window.len;
     return AWS_OP_SUCCESS;
 }
 
-static int s_input_stream_get_status(struct aws_input_stream *stream, struct aws_stream_status *status) {
-    struct aws_napi_input_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_input_stream_impl, base);
-    aws_mutex_lock(&impl->mutex);
-    status->is_end_of_stream = impl->eos;
-    aws_mutex_unlock(&impl->mutex);
-    status->is_valid = true;
+static int s_file_stream_get_status(struct aws_input_stream *stream, struct aws_stream_status *status) {
+    struct aws_napi_file_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_file_stream_impl, base);
+
+    if (aws_input_stream_get_status(impl->source, status)) {
+        return AWS_OP_ERR;
+    }
+
+    if (impl->position == impl->length) {
+        status->is_end_of_stream = true;
+    }
     return AWS_OP_SUCCESS;
 }
 
-static int s_input_stream_get_length(struct aws_input_stream *stream, int64_t *out_length) {
-    (void)stream;
-    (void)out_length;
-    return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+static int s_file_stream_get_length(struct aws_input_stream *stream, int64_t *out_length) {
+    struct aws_napi_file_stream_impl *impl = AWS_CONTAINER_OF(stream, struct aws_napi_file_stream_impl, base);
+    *out_length = (int64_t)impl->length;
+    return AWS_OP_SUCCESS;
 }
 
-static void s_input_stream_destroy(struct aws_napi_input_stream_impl *impl) {
-    struct aws_allocator *allocator = impl->buffer.allocator;
-    aws_mutex_clean_up(&impl->mutex);
-    aws_byte_buf_clean_up(&impl->buffer);
-    aws_mem_release(allocator, impl);
+#if defined(_WIN32)
+static void s_file_stream_unmap(struct aws_napi_file_stream_impl *impl) {
+    (void)impl;
 }
+#else
+static int s_file_stream_map(struct aws_napi_file_stream_impl *impl, const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+
+    int result = AWS_OP_ERR;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        aws_translate_and_raise_io_error(errno);
+        goto done;
+    }
+    if (!S_ISREG(file_stat.st_mode)) {
+        aws_raise_error(AWS_ERROR_FILE_INVALID_PATH);
+        goto done;
+    }
+    if ((uint64_t)file_stat.st_size > SIZE_MAX) {
+        aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        goto done;
+    }
+
+    /* an empty file cannot be mapped, but an empty cursor serves just as well */
+    size_t size = (size_t)file_stat.st_size;
+    if (size > 0) {
+        void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            aws_translate_and_raise_io_error(errno);
+            goto done;
+        }
 
-static struct aws_input_stream_vtable s_input_stream_vtable = {
-    .seek = s_input_stream_seek,
-    .read = s_input_stream_read,
-    .get_status = s_input_stream_get_status,
-    .get_length = s_input_stream_get_length,
+        /* uploads read front to back, let the kernel read ahead aggressively */
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        impl->mapping = mapping;
+        impl->mapping_size = size;
+    }
+
+    result = AWS_OP_SUCCESS;
+
+done:
+    close(fd);
+    return result;
+}
+
+static void s_file_stream_unmap(struct aws_napi_file_stream_impl *impl) {
+    if (impl->mapping) {
+        munmap(impl->mapping, impl->mapping_size);
+    }
+}
+#endif /* _WIN32 */
+
+static void s_file_stream_destroy(struct aws_napi_file_stream_impl *impl) {
+    if (impl->source) {
+        aws_input_stream_release(impl->source);
+    }
+    s_file_stream_unmap(impl);
+    aws_mem_release(impl->allocator, impl);
+}
+
+static struct aws_input_stream_vtable s_file_stream_vtable = {
+    .seek = s_file_stream_seek,
+    .read = s_file_stream_read,
+    .get_status = s_file_stream_get_status,
+    .get_length = s_file_stream_get_length,
 };
 
-napi_value aws_napi_io_input_stream_new(napi_env env, napi_callback_info info) {
-    napi_value node_args[1];
+/* A negative length means everything from offset to the end of the file */
+static struct aws_input_stream *s_file_stream_new(
+    struct aws_allocator *allocator,
+    const char *path,
+    uint64_t offset,
+    int64_t length,
+    bool use_mmap) {
+
+    struct aws_napi_file_stream_impl *impl = aws_mem_calloc(allocator, 1, sizeof(struct aws_napi_file_stream_impl));
+    if (!impl) {
+        return NULL;
+    }
+
+    impl->base.vtable = &s_file_stream_vtable;
+    impl->allocator = allocator;
+    aws_ref_count_init(&impl->base.ref_count, impl, (aws_simple_completion_callback *)s_file_stream_destroy);
+
+#if defined(_WIN32)
+    /* Mapping is only implemented on POSIX platforms, elsewhere the file is read normally */
+    (void)use_mmap;
+    impl->source = aws_input_stream_new_from_file(allocator, path);
+#else
+    if (use_mmap) {
+        if (s_file_stream_map(impl, path)) {
+            goto failed;
+        }
+        struct aws_byte_cursor contents = aws_byte_cursor_from_array(impl->mapping, impl->mapping_size);
+        impl->source = aws_input_stream_new_from_cursor(allocator, &contents);
+    } else {
+        impl->source = aws_input_stream_new_from_file(allocator, path);
+    }
+#endif
+    if (!impl->source) {
+        goto failed;
+    }
+
+    int64_t file_length = 0;
+    if (aws_input_stream_get_length(impl->source, &file_length)) {
+        goto failed;
+    }
+
+    if (offset > (uint64_t)file_length) {
+        aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+        goto failed;
+    }
+
+    uint64_t available = (uint64_t)file_length - offset;
+    if (length >= 0 && (uint64_t)length > available) {
+        aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+        goto failed;
+    }
+
+    impl->start = offset;
+    impl->length = length >= 0 ? (uint64_t)length : available;
+
+    if (offset > 0 && aws_input_stream_seek(impl->source, (int64_t)offset, AWS_SSB_BEGIN)) {
+        goto failed;
+    }
+
+    return &impl->base;
+
+failed:
+    aws_input_stream_release(&impl->base);
+    return NULL;
+}
+
+static void s_file_stream_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+    (void)finalize_hint;
+
+    /* Any request using the stream holds its own reference */
+    struct aws_input_stream *stream = finalize_data;
+    aws_input_stream_release(stream);
+}
+
+napi_value aws_napi_io_input_stream_new_from_file(napi_env env, napi_callback_info info) {
+    napi_value node_args[4];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
         napi_throw_error(env, NULL, "Failed to retrieve callback information");
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "io_input_stream_new requires exactly 1 arguments");
+        napi_throw_error(env, NULL, "io_input_stream_new_from_file requires exactly 4 arguments");
         return NULL;
     }
 
-    int64_t capacity = 0;
-    if (napi_get_value_int64(env, node_args[0], &capacity)) {
-        napi_throw_error(env, NULL, "capacity must be a number");
+    int64_t offset = 0;
+    if (napi_get_value_int64(env, node_args[1], &offset) || offset < 0) {
+        napi_throw_type_error(env, NULL, "offset must be a non-negative number");
         return NULL;
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
-    struct aws_napi_input_stream_impl *impl = aws_mem_calloc(allocator, 1, sizeof(struct aws_napi_input_stream_impl));
-    if (!impl) {
-        napi_throw_error(env, NULL, "Unable to allocate native aws_input_stream");
+    int64_t length = -1;
+    if (!aws_napi_is_null_or_undefined(env, node_args[2])) {
+        if (napi_get_value_int64(env, node_args[2], &length) || length < 0) {
+            napi_throw_type_error(env, NULL, "length must be a non-negative number or undefined");
+            return NULL;
+        }
+    }
+
+    bool use_mmap = false;
+    if (napi_get_value_bool(env, node_args[3], &use_mmap)) {
+        napi_throw_type_error(env, NULL, "mmap must be a boolean");
         return NULL;
     }
 
-    impl->base.vtable = &s_input_stream_vtable;
-    aws_ref_count_init(&impl->base.ref_count, impl, (aws_simple_completion_callback *)s_input_stream_destroy);
-    if (aws_mutex_init(&impl->mutex)) {
-        aws_napi_throw_last_error(env);
-        goto failed;
+    struct aws_string *path = aws_string_new_from_napi(env, node_args[0]);
+    if (!path) {
+        napi_throw_type_error(env, NULL, "path must be a String");
+        return NULL;
     }
 
-    if (aws_byte_buf_init(&impl->buffer, allocator, 16 * 1024)) {
-        napi_throw_error(env, NULL, "Unable to allocate stream buffer");
-        goto failed;
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_IO);
+    struct aws_input_stream *stream =
+        s_file_stream_new(allocator, aws_string_c_str(path), (uint64_t)offset, length, use_mmap);
+    aws_string_destroy(path);
+    if (!stream) {
+        aws_napi_throw_last_error(env);
+        return NULL;
     }
 
     napi_value node_external = NULL;
-    if (napi_create_external(env, impl, NULL, NULL, &node_external)) {
+    if (napi_create_external(env, stream, s_file_stream_finalize, NULL, &node_external)) {
+        aws_input_stream_release(stream);
         napi_throw_error(env, NULL, "Unable to create external for native aws_input_stream");
-        goto failed;
+        return NULL;
     }
 
     return node_external;
+}
 
-failed:
-    if (impl) {
-        aws_input_stream_release(&impl->base);
+napi_value aws_napi_io_input_stream_get_length(napi_env env, napi_callback_info info) {
+    napi_value node_args[1];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_input_stream_get_length requires exactly 1 argument");
+        return NULL;
     }
 
-    return NULL;
+    struct aws_input_stream *stream = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&stream)) {
+        napi_throw_error(env, NULL, "stream must be a node external");
+        return NULL;
+    }
+
+    /* undefined when the length is not known (yet) */
+    int64_t length = 0;
+    if (aws_input_stream_get_length(stream, &length)) {
+        return NULL;
+    }
+
+    napi_value node_length = NULL;
+    AWS_NAPI_CALL(env, napi_create_int64(env, length, &node_length), {
+        napi_throw_error(env, NULL, "Unable to create length");
+        return NULL;
+    });
+    return node_length;
 }
 
-napi_value aws_napi_io_input_stream_append(napi_env env, napi_callback_info info) {
+napi_value aws_napi_io_input_stream_read(napi_env env, napi_callback_info info) {
     napi_value node_args[2];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
     if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
@@ -1013,40 +2526,100 @@ napi_value aws_napi_io_input_stream_append(napi_env env, napi_callback_info info
         return NULL;
     }
     if (num_args != AWS_ARRAY_SIZE(node_args)) {
-        napi_throw_error(env, NULL, "io_input_stream_append requires exactly 2 arguments");
+        napi_throw_error(env, NULL, "io_input_stream_read requires exactly 2 arguments");
         return NULL;
     }
 
-    struct aws_napi_input_stream_impl *impl = NULL;
-    if (napi_get_value_external(env, node_args[0], (void **)&impl)) {
+    struct aws_input_stream *stream = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&stream)) {
         napi_throw_error(env, NULL, "stream must be a node external");
         return NULL;
     }
 
-    /* null means end of stream */
-    if (aws_napi_is_null_or_undefined(env, node_args[1])) {
-        aws_mutex_lock(&impl->mutex);
-        impl->eos = true;
-        aws_mutex_unlock(&impl->mutex);
+    uint8_t *data = NULL;
+    size_t capacity = 0;
+    if (napi_get_buffer_info(env, node_args[1], (void **)&data, &capacity)) {
+        napi_throw_error(env, NULL, "dest must be a valid Buffer object");
         return NULL;
     }
 
-    /* not null or undefined, so it should be a buffer */
-    bool is_buffer = false;
-    if (napi_is_buffer(env, node_args[1], &is_buffer) || !is_buffer) {
-        napi_throw_error(env, NULL, "buffer must be a valid Buffer object or undefined/null");
+    struct aws_byte_buf dest = aws_byte_buf_from_empty_array(data, capacity);
+    if (aws_input_stream_read(stream, &dest)) {
+        aws_napi_throw_last_error(env);
         return NULL;
     }
 
-    struct aws_byte_cursor data;
-    if (napi_get_buffer_info(env, node_args[1], (void **)&data.ptr, &data.len)) {
-        napi_throw_error(env, NULL, "Unable to extract data from buffer");
+    napi_value node_length = NULL;
+    AWS_NAPI_CALL(env, napi_create_uint32(env, (uint32_t)dest.len, &node_length), {
+        napi_throw_error(env, NULL, "Unable to create length");
+        return NULL;
+    });
+    return node_length;
+}
+
+napi_value aws_napi_io_input_stream_is_end_of_stream(napi_env env, napi_callback_info info) {
+    napi_value node_args[1];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_input_stream_is_end_of_stream requires exactly 1 argument");
         return NULL;
     }
 
-    aws_mutex_lock(&impl->mutex);
-    aws_byte_buf_append(&impl->buffer, &data);
-    aws_mutex_unlock(&impl->mutex);
+    struct aws_input_stream *stream = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&stream)) {
+        napi_throw_error(env, NULL, "stream must be a node external");
+        return NULL;
+    }
+
+    struct aws_stream_status status;
+    AWS_ZERO_STRUCT(status);
+    if (aws_input_stream_get_status(stream, &status)) {
+        aws_napi_throw_last_error(env);
+        return NULL;
+    }
+
+    napi_value node_eos = NULL;
+    AWS_NAPI_ENSURE(env, napi_get_boolean(env, status.is_end_of_stream, &node_eos));
+    return node_eos;
+}
+
+napi_value aws_napi_io_input_stream_seek(napi_env env, napi_callback_info info) {
+    napi_value node_args[3];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    if (napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL)) {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    }
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_input_stream_seek requires exactly 3 arguments");
+        return NULL;
+    }
+
+    struct aws_input_stream *stream = NULL;
+    if (napi_get_value_external(env, node_args[0], (void **)&stream)) {
+        napi_throw_error(env, NULL, "stream must be a node external");
+        return NULL;
+    }
+
+    int64_t offset = 0;
+    if (napi_get_value_int64(env, node_args[1], &offset)) {
+        napi_throw_error(env, NULL, "offset must be a number");
+        return NULL;
+    }
+
+    bool from_end = false;
+    if (napi_get_value_bool(env, node_args[2], &from_end)) {
+        napi_throw_error(env, NULL, "from_end must be a boolean");
+        return NULL;
+    }
+
+    if (aws_input_stream_seek(stream, offset, from_end ? AWS_SSB_END : AWS_SSB_BEGIN)) {
+        aws_napi_throw_last_error(env);
+    }
 
     return NULL;
 }
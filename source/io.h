@@ -34,6 +34,21 @@ napi_value aws_napi_is_alpn_available(napi_env env, napi_callback_info info);
  */
 napi_value aws_napi_io_client_bootstrap_new(napi_env env, napi_callback_info info);
 
+/**
+ * Create a new aws_host_resolver, or share the default one, to be managed by an napi_external.
+ */
+napi_value aws_napi_io_host_resolver_new(napi_env env, napi_callback_info info);
+
+/**
+ * Resolve a host name through a host resolver, calling back with the addresses found
+ */
+napi_value aws_napi_io_host_resolver_resolve(napi_env env, napi_callback_info info);
+
+/**
+ * Start resolving a list of host names, so that later lookups find them cached
+ */
+napi_value aws_napi_io_host_resolver_prefetch(napi_env env, napi_callback_info info);
+
 /* extracts the underlying aws_client_bootstrap from an opaque binding, usually found in a node external */
 struct aws_client_bootstrap *aws_napi_get_client_bootstrap(struct client_bootstrap_binding *binding);
 
@@ -42,6 +57,11 @@ struct aws_client_bootstrap *aws_napi_get_client_bootstrap(struct client_bootstr
  */
 napi_value aws_napi_io_tls_ctx_new(napi_env env, napi_callback_info info);
 
+/**
+ * Returns the number of contexts in the shared tls context cache, and the number of externals using them. For tests.
+ */
+napi_value aws_napi_io_tls_ctx_cache_statistics(napi_env env, napi_callback_info info);
+
 /**
  * Create a new aws_tls_connection_options to be managed by a napi_external
  */
@@ -57,6 +77,32 @@ napi_value aws_napi_io_socket_options_new(napi_env env, napi_callback_info info)
  */
 napi_value aws_napi_io_logging_enable(napi_env env, napi_callback_info info);
 
+/**
+ * Send CRT logging to a file, written from a native thread rather than through node
+ */
+napi_value aws_napi_io_logging_enable_file(napi_env env, napi_callback_info info);
+napi_value aws_napi_io_logging_disable_file(napi_env env, napi_callback_info info);
+
+/**
+ * Override the log level of a single log subject
+ */
+napi_value aws_napi_io_logging_set_subject_level(napi_env env, napi_callback_info info);
+
+/**
+ * Limit the rate at which a single log subject may log
+ */
+napi_value aws_napi_io_logging_set_subject_rate_limit(napi_env env, napi_callback_info info);
+
+/**
+ * Returns the level a single log subject is logging at, after any override. For tests.
+ */
+napi_value aws_napi_io_logging_get_subject_level(napi_env env, napi_callback_info info);
+
+/**
+ * Logs a line as the given subject, through the same filters as native logging. For tests.
+ */
+napi_value aws_napi_io_logging_log(napi_env env, napi_callback_info info);
+
 /**
  * Create an input stream
  */
@@ -67,6 +113,31 @@ napi_value aws_napi_io_input_stream_new(napi_env, napi_callback_info info);
  */
 napi_value aws_napi_io_input_stream_append(napi_env env, napi_callback_info info);
 
+/**
+ * Create an input stream over a range of a file, optionally memory mapped
+ */
+napi_value aws_napi_io_input_stream_new_from_file(napi_env env, napi_callback_info info);
+
+/**
+ * Get the length of an input stream, if it is known
+ */
+napi_value aws_napi_io_input_stream_get_length(napi_env env, napi_callback_info info);
+
+/**
+ * Read from an input stream into a Buffer, returning the number of bytes read. For tests and benchmarks.
+ */
+napi_value aws_napi_io_input_stream_read(napi_env env, napi_callback_info info);
+
+/**
+ * Whether an input stream has produced all of its data. For tests and benchmarks.
+ */
+napi_value aws_napi_io_input_stream_is_end_of_stream(napi_env env, napi_callback_info info);
+
+/**
+ * Seek an input stream, relative to its start or its end. For tests and benchmarks.
+ */
+napi_value aws_napi_io_input_stream_seek(napi_env env, napi_callback_info info);
+
 /**
  * Create a new aws_pkcs11_lib to be managed by a napi_external
  */
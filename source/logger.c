@@ -5,107 +5,622 @@
 
 #include "logger.h"
 
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/logging.h>
+#include <aws/common/condition_variable.h>
+#include <aws/common/file.h>
 #include <aws/common/linked_list.h>
 #include <aws/common/log_channel.h>
 #include <aws/common/log_formatter.h>
 #include <aws/common/log_writer.h>
 #include <aws/common/mutex.h>
-#include <aws/common/ring_buffer.h>
+#include <aws/common/rw_lock.h>
+#include <aws/common/string.h>
+#include <aws/common/thread.h>
 
 #include <ctype.h>
+#include <stdio.h>
 
-#define LOG_RING_BUFFER_CAPACITY (128 * 1024)
+/* Number of records in each context's log queue, must be a power of 2 */
+#define LOG_QUEUE_CAPACITY 256
+/* Size of a single queued log line, longer lines are truncated */
+#define LOG_RECORD_SIZE 1024
+/* Smallest batch buffer the file sink will use, so that a single line always fits */
+#define LOG_FILE_MIN_BUFFER_SIZE (2 * LOG_RECORD_SIZE)
+/* Dimensions of the per-subject filter table. Subjects outside of it always use the global level */
+#define LOG_FILTER_PACKAGES 32
+#define LOG_FILTER_SUBJECTS_PER_PACKAGE 64
 
 #ifdef _MSC_VER
 #    pragma warning(disable : 4204)
 #endif /* _MSC_VER */
 
+/*
+ * A single slot in the log queue. sequence tells producers and the consumer whose turn it is to use the slot: it equals
+ * the enqueue position when the slot is free, and the enqueue position + 1 once the record has been written.
+ */
+struct log_record {
+    struct aws_atomic_var sequence;
+    size_t len;
+    char data[LOG_RECORD_SIZE];
+};
+
 /*
  * One of these is allocated per napi_env/thread and stored in TLS. Worker threads will call into
- * their env's instance, and all other event loop threads will call into the main thread's
- * instance.
+ * their env's instance, and all other event loop threads will call into the default instance, which
+ * is the oldest env that is still alive.
  */
 struct aws_napi_logger_ctx {
     napi_env env;
     struct aws_allocator *allocator;
-    /* ring buffer for copying log messages for queueing */
-    struct aws_ring_buffer buffer;
-    /* allocator that uses the ring buffer */
-    struct aws_allocator buffer_allocator;
-    /* messages to be logged, filled from any thread, drained from node thread */
+    /* the module can be initialized more than once in the same env, each of which shares this context */
+    size_t ref_count;
+    /* entry in s_napi_logger.contexts */
+    struct aws_linked_list_node node;
+    /*
+     * Bounded multi-producer/single-consumer queue of log lines. Any thread may write a record into the next free slot
+     * without locking or allocating; only the node thread drains it. When it is full, messages are counted and dropped.
+     */
     struct {
-        struct aws_mutex mutex;
-        struct aws_linked_list messages;
+        struct log_record *records;
+        struct aws_atomic_var enqueue_pos;
+        /* only touched by the node thread */
+        size_t dequeue_pos;
+        /* messages dropped because the queue was full, reported on the next drain */
+        struct aws_atomic_var dropped;
+        /* set while a call to log_drain is queued, so that only one is in flight per drain */
+        struct aws_atomic_var drain_pending;
     } msg_queue;
     /* log function in node */
     napi_threadsafe_function log_drain;
+    /* set once log_drain has been released, after which lines are dropped */
+    struct aws_atomic_var log_drain_closed;
 };
 
 static AWS_THREAD_LOCAL struct aws_napi_logger_ctx *tl_logger_ctx;
 
+/*
+ * Writes logs straight to a file from a dedicated native thread, without involving any node env. Logging threads append
+ * formatted lines to the pending buffer, and the writer thread swaps it out and writes the whole batch at once when it
+ * is half full, when flush_interval_ns has passed, or at shutdown.
+ */
+struct aws_napi_log_file_sink {
+    struct aws_allocator *allocator;
+    struct aws_string *path;
+    uint64_t flush_interval_ns;
+    size_t max_file_size;
+    size_t max_files;
+    struct aws_thread thread;
+
+    struct {
+        struct aws_mutex lock;
+        struct aws_condition_variable signal;
+        struct aws_byte_buf pending;
+        /* lines that did not fit in pending, reported by the writer thread */
+        size_t dropped;
+        bool flush_requested;
+        bool shutting_down;
+    } sync;
+
+    /* only touched by the writer thread */
+    FILE *file;
+    uint64_t file_size;
+    struct aws_byte_buf writing;
+};
+
 /* aws_log_pipeline components */
 static struct {
+    /* the logger installed in the CRT, which applies per-subject filters before handing off to the pipeline */
+    struct aws_logger filter;
     struct aws_logger logger;
     struct aws_log_formatter formatter;
     struct aws_log_writer writer;
     struct aws_log_channel channel;
-    struct aws_napi_logger_ctx *default_ctx;
-} s_napi_logger;
-
-struct log_message {
-    struct aws_linked_list_node node;
-    struct aws_string *message;
+    /*
+     * Every live context, oldest first, guarded by contexts_lock. Contexts come and go as worker threads start and
+     * stop, which also serializes changes to the default context and the shutdown of contexts.
+     */
+    struct aws_rw_lock contexts_lock;
+    struct aws_linked_list contexts;
+    /*
+     * struct aws_napi_logger_ctx *, the context non-node threads log through. They read it without taking a lock, and
+     * count themselves in default_ctx_users[default_ctx_epoch & 1] while they use it (see s_default_ctx_enter()).
+     */
+    struct aws_atomic_var default_ctx;
+    struct aws_atomic_var default_ctx_epoch;
+    struct aws_atomic_var default_ctx_users[2];
+    /*
+     * When set, all logging goes to this sink instead of through node. Loggers hold file_sink_lock for reading while
+     * they use it; file_sink_active lets them skip the lock entirely when there is no sink.
+     */
+    struct aws_rw_lock file_sink_lock;
+    struct aws_atomic_var file_sink_active;
+    struct aws_napi_log_file_sink *file_sink;
+} s_napi_logger = {
+    .contexts_lock = AWS_RW_LOCK_INIT,
+    .file_sink_lock = AWS_RW_LOCK_INIT,
+    .default_ctx = AWS_ATOMIC_INIT_PTR(NULL),
+    .default_ctx_epoch = AWS_ATOMIC_INIT_INT(0),
+    .default_ctx_users = {AWS_ATOMIC_INIT_INT(0), AWS_ATOMIC_INIT_INT(0)},
+    .file_sink_active = AWS_ATOMIC_INIT_INT(0),
+    .contexts =
+        {
+            .head = {.next = &s_napi_logger.contexts.tail},
+            .tail = {.prev = &s_napi_logger.contexts.head},
+        },
 };
 
-/* custom aws_log_writer that writes via process._rawDebug() within the node env via threadsafe function */
-static int s_napi_log_writer_write(struct aws_log_writer *writer, const struct aws_string *output) {
-    (void)writer;
-    struct aws_napi_logger_ctx *ctx = tl_logger_ctx ? tl_logger_ctx : s_napi_logger.default_ctx;
-    /* this can only happen if someone tries to log after the main thread has cleaned up */
-    AWS_FATAL_ASSERT(ctx && "No TLS log context, and no default fallback");
+/*
+ * Threads without an env of their own use the default context without locking. While it does, a thread is counted in
+ * the users slot picked by the epoch it saw. Whatever swaps out or shuts down a context flips the epoch and then waits
+ * for the old slot to empty (s_default_ctx_synchronize()), after which no thread can still be using the old state. New
+ * users count themselves in the other slot, so the wait can't be held up indefinitely by a steady stream of logging.
+ */
+static size_t s_default_ctx_enter(void) {
+    for (;;) {
+        size_t epoch = aws_atomic_load_int(&s_napi_logger.default_ctx_epoch);
+        aws_atomic_fetch_add(&s_napi_logger.default_ctx_users[epoch & 1], 1);
+        /* a flip in between may not have waited for this slot, so count in the new one instead */
+        if (aws_atomic_load_int(&s_napi_logger.default_ctx_epoch) == epoch) {
+            return epoch & 1;
+        }
+        aws_atomic_fetch_sub(&s_napi_logger.default_ctx_users[epoch & 1], 1);
+    }
+}
 
-    /* node will append a newline, so strip the ones from the logger */
-    size_t newlines = 0;
-    while (isspace((const char)(aws_string_bytes(output)[output->len - newlines - 1])) && newlines < output->len) {
-        ++newlines;
+static void s_default_ctx_leave(size_t slot) {
+    aws_atomic_fetch_sub(&s_napi_logger.default_ctx_users[slot], 1);
+}
+
+/* Waits out every thread that may have seen the default context before now. Must hold contexts_lock for writing. */
+static void s_default_ctx_synchronize(void) {
+    size_t slot = aws_atomic_fetch_add(&s_napi_logger.default_ctx_epoch, 1) & 1;
+    while (aws_atomic_load_int(&s_napi_logger.default_ctx_users[slot]) != 0) {
+        aws_thread_yield();
+    }
+}
+
+/* Claims the next free slot for writing, returns NULL if the queue is full. Publish it with s_log_queue_publish(). */
+static struct log_record *s_log_queue_claim(struct aws_napi_logger_ctx *ctx, size_t *out_pos) {
+    size_t pos = aws_atomic_load_int(&ctx->msg_queue.enqueue_pos);
+    struct log_record *record = NULL;
+    for (;;) {
+        record = &ctx->msg_queue.records[pos & (LOG_QUEUE_CAPACITY - 1)];
+        size_t sequence = aws_atomic_load_int(&record->sequence);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            /* slot is free, claim it. On failure, pos is updated to the current enqueue position */
+            if (aws_atomic_compare_exchange_int(&ctx->msg_queue.enqueue_pos, &pos, pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* the consumer has not gotten to this slot since the last lap, queue is full */
+            return NULL;
+        } else {
+            /* another producer claimed this slot first */
+            pos = aws_atomic_load_int(&ctx->msg_queue.enqueue_pos);
+        }
+    }
+
+    *out_pos = pos;
+    return record;
+}
+
+/* Hands a record written after s_log_queue_claim() to the consumer */
+static void s_log_queue_publish(struct log_record *record, size_t pos) {
+    aws_atomic_store_int(&record->sequence, pos + 1);
+}
+
+/* node will append a newline, so leave off the ones from the formatter */
+static size_t s_log_line_trimmed_length(const char *line, size_t len) {
+    while (len > 0 && isspace((unsigned char)line[len - 1])) {
+        --len;
+    }
+    return len;
+}
+
+/* Returns the next written record, or NULL if there is none. Only called from the node thread */
+static struct log_record *s_log_queue_peek(struct aws_napi_logger_ctx *ctx) {
+    size_t pos = ctx->msg_queue.dequeue_pos;
+    struct log_record *record = &ctx->msg_queue.records[pos & (LOG_QUEUE_CAPACITY - 1)];
+    if (aws_atomic_load_int(&record->sequence) != pos + 1) {
+        return NULL;
+    }
+    return record;
+}
+
+/* Hands the slot returned by s_log_queue_peek() back to producers for the next lap */
+static void s_log_queue_pop(struct aws_napi_logger_ctx *ctx, struct log_record *record) {
+    size_t pos = ctx->msg_queue.dequeue_pos++;
+    aws_atomic_store_int(&record->sequence, pos + LOG_QUEUE_CAPACITY);
+}
+
+/* Queues a call to log_drain, unless one is already queued and has not started draining yet */
+static void s_log_schedule_drain(struct aws_napi_logger_ctx *ctx) {
+    if (aws_atomic_exchange_int(&ctx->msg_queue.drain_pending, 1) != 0) {
+        return;
     }
 
     /*
-     * If log_drain is null, it's been released and we can't use it anymore, but we don't want
-     * to lose logs at shutdown. Node should not close and re-open stderr at this point, so we'll
-     * just write to it immediately. These messages will escape any application log overrides.
+     * Pin the log drain function until it runs. If this fails, the function has been released, which means we are
+     * shutting down, so drain_pending is left set and nothing more will be queued.
      */
-    if (!ctx->log_drain) {
+    if (napi_acquire_threadsafe_function(ctx->log_drain) != napi_ok) {
+        return;
+    }
+
+    /* if the env is closing, queued messages are dropped along with the queue when it finalizes */
+    if (napi_call_threadsafe_function(ctx->log_drain, NULL, napi_tsfn_nonblocking) != napi_ok) {
+        napi_release_threadsafe_function(ctx->log_drain, napi_tsfn_release);
+    }
+}
+
+/*
+ * Formats a line straight into a claimed slot of ctx's queue, so that logging from any thread neither allocates nor
+ * locks. If the queue is full, the line is counted and dropped without being formatted.
+ */
+static int s_napi_log_ctx_vlog(
+    struct aws_napi_logger_ctx *ctx,
+    enum aws_log_level level,
+    aws_log_subject_t subject,
+    const char *format,
+    va_list args) {
+
+    /*
+     * If log_drain has been released we can't use it anymore, but we don't want to lose logs at shutdown. Node should
+     * not close and re-open stderr at this point, so we'll just write to it immediately. These messages will escape
+     * any application log overrides.
+     */
+    if (aws_atomic_load_int(&ctx->log_drain_closed)) {
 #ifdef AWS_NAPI_LOG_AFTER_SHUTDOWN
-        fprintf(stderr, "%*s", (int)(output->len - newlines), aws_string_c_str(output));
+        char line[LOG_RECORD_SIZE];
+        struct aws_logging_standard_formatting_data format_data = {
+            .log_line_buffer = line,
+            .total_length = sizeof(line),
+            .level = level,
+            .subject_name = aws_log_subject_name(subject),
+            .format = format,
+            .date_format = AWS_DATE_FORMAT_ISO_8601,
+            .allocator = ctx->allocator,
+        };
+        if (aws_format_standard_log_line(&format_data, args) == AWS_OP_SUCCESS) {
+            size_t len = aws_min_size(format_data.amount_written, sizeof(line) - 1);
+            fprintf(stderr, "%.*s\n", (int)s_log_line_trimmed_length(line, len), line);
+        }
 #endif
         return AWS_OP_SUCCESS;
     }
 
-    /*
-     * Pin the log drain function until we try to call it. If napi_closing is returned, the function
-     * has been released, which means we are shutting down, so we just bail
-     */
-    AWS_NAPI_CALL(env, napi_acquire_threadsafe_function(ctx->log_drain), {
-        return (status == napi_closing) ? AWS_OP_SUCCESS : AWS_OP_ERR;
-    });
-
-    /* must allocate in the order things will be freed because we use a ring buffer */
-    struct aws_string *message =
-        aws_string_new_from_array(&ctx->buffer_allocator, aws_string_bytes(output), output->len - newlines);
-    struct log_message *msg = aws_mem_calloc(&ctx->buffer_allocator, 1, sizeof(struct log_message));
-    msg->message = message;
-
-    /* queue up the message to be logged next time the function runs */
-    aws_mutex_lock(&ctx->msg_queue.mutex);
-    aws_linked_list_push_back(&ctx->msg_queue.messages, &msg->node);
-    aws_mutex_unlock(&ctx->msg_queue.mutex);
-
-    /* queue the call */
-    AWS_NAPI_ENSURE(ctx->env, napi_call_threadsafe_function(ctx->log_drain, NULL, napi_tsfn_nonblocking));
+    /* never block or fail the logging thread, if node can't keep up just count what was lost */
+    size_t pos = 0;
+    struct log_record *record = s_log_queue_claim(ctx, &pos);
+    if (!record) {
+        aws_atomic_fetch_add(&ctx->msg_queue.dropped, 1);
+        s_log_schedule_drain(ctx);
+        return AWS_OP_SUCCESS;
+    }
+
+    /* the same line the pipeline's default formatter would produce, truncated to fit the record */
+    struct aws_logging_standard_formatting_data format_data = {
+        .log_line_buffer = record->data,
+        .total_length = LOG_RECORD_SIZE,
+        .level = level,
+        .subject_name = aws_log_subject_name(subject),
+        .format = format,
+        .date_format = AWS_DATE_FORMAT_ISO_8601,
+        .allocator = ctx->allocator,
+    };
+    int result = aws_format_standard_log_line(&format_data, args);
+
+    /* the slot is ours either way, so publish it; an empty record is skipped by the drain */
+    record->len = 0;
+    if (result == AWS_OP_SUCCESS) {
+        /* a truncated line ends in the terminator snprintf left at the end of the buffer */
+        size_t len = aws_min_size(format_data.amount_written, LOG_RECORD_SIZE - 1);
+        record->len = s_log_line_trimmed_length(record->data, len);
+    }
+    s_log_queue_publish(record, pos);
+
+    s_log_schedule_drain(ctx);
+    return result;
+}
+
+/* Queues a line that has already been formatted, for lines that went through the pipeline's formatter */
+static int s_napi_log_ctx_write(struct aws_napi_logger_ctx *ctx, const struct aws_string *output) {
+    size_t len = s_log_line_trimmed_length(aws_string_c_str(output), output->len);
+
+    if (aws_atomic_load_int(&ctx->log_drain_closed)) {
+#ifdef AWS_NAPI_LOG_AFTER_SHUTDOWN
+        fprintf(stderr, "%.*s\n", (int)len, aws_string_c_str(output));
+#endif
+        return AWS_OP_SUCCESS;
+    }
+
+    size_t pos = 0;
+    struct log_record *record = s_log_queue_claim(ctx, &pos);
+    if (!record) {
+        aws_atomic_fetch_add(&ctx->msg_queue.dropped, 1);
+    } else {
+        record->len = aws_min_size(len, LOG_RECORD_SIZE);
+        memcpy(record->data, aws_string_bytes(output), record->len);
+        s_log_queue_publish(record, pos);
+    }
+
+    s_log_schedule_drain(ctx);
+    return AWS_OP_SUCCESS;
+}
+
+/***********************************************************************************************************************
+ * File sink
+ **********************************************************************************************************************/
+
+static void s_log_file_sink_write(struct aws_napi_log_file_sink *sink, const struct aws_string *output) {
+    bool notify = false;
+    aws_mutex_lock(&sink->sync.lock);
+    struct aws_byte_buf *pending = &sink->sync.pending;
+    if (pending->capacity - pending->len >= output->len) {
+        aws_byte_buf_write(pending, aws_string_bytes(output), output->len);
+    } else {
+        ++sink->sync.dropped;
+    }
+    if (!sink->sync.flush_requested && pending->len >= pending->capacity / 2) {
+        sink->sync.flush_requested = true;
+        notify = true;
+    }
+    aws_mutex_unlock(&sink->sync.lock);
+
+    if (notify) {
+        aws_condition_variable_notify_one(&sink->sync.signal);
+    }
+}
+
+/* Opens (or re-opens) the log file for appending, picking up the size of whatever is already there */
+static int s_log_file_sink_open(struct aws_napi_log_file_sink *sink) {
+    sink->file = aws_fopen(aws_string_c_str(sink->path), "ab");
+    if (!sink->file) {
+        return AWS_OP_ERR;
+    }
+
+    int64_t length = 0;
+    if (aws_file_get_length(sink->file, &length) == AWS_OP_SUCCESS && length > 0) {
+        sink->file_size = (uint64_t)length;
+    } else {
+        sink->file_size = 0;
+    }
     return AWS_OP_SUCCESS;
 }
 
+static void s_log_file_sink_rotated_name(struct aws_napi_log_file_sink *sink, size_t index, char *name, size_t size) {
+    snprintf(name, size, "%s.%llu", aws_string_c_str(sink->path), (unsigned long long)index);
+}
+
+/* Shifts path.1 ... path.N-1 up by one, moves the current file to path.1, and starts a new one */
+static void s_log_file_sink_rotate(struct aws_napi_log_file_sink *sink) {
+    fclose(sink->file);
+    sink->file = NULL;
+
+    const char *path = aws_string_c_str(sink->path);
+    size_t name_size = sink->path->len + 32;
+    char *from = aws_mem_acquire(sink->allocator, name_size * 2);
+    char *to = from + name_size;
+
+    if (sink->max_files == 0) {
+        remove(path);
+    } else {
+        for (size_t index = sink->max_files - 1; index > 0; --index) {
+            s_log_file_sink_rotated_name(sink, index, from, name_size);
+            s_log_file_sink_rotated_name(sink, index + 1, to, name_size);
+            /* rename() will not replace an existing file on every platform */
+            remove(to);
+            rename(from, to);
+        }
+        s_log_file_sink_rotated_name(sink, 1, to, name_size);
+        remove(to);
+        rename(path, to);
+    }
+    aws_mem_release(sink->allocator, from);
+
+    /* if the file can't be re-opened, logs are discarded until the next rotation attempt */
+    s_log_file_sink_open(sink);
+}
+
+static void s_log_file_sink_flush(struct aws_napi_log_file_sink *sink, const uint8_t *bytes, size_t len) {
+    if (len == 0) {
+        return;
+    }
+
+    if (!sink->file) {
+        s_log_file_sink_open(sink);
+    } else if (sink->max_file_size && sink->file_size && sink->file_size + len > sink->max_file_size) {
+        s_log_file_sink_rotate(sink);
+    }
+
+    if (!sink->file) {
+        return;
+    }
+
+    size_t written = fwrite(bytes, 1, len, sink->file);
+    fflush(sink->file);
+    sink->file_size += written;
+}
+
+static bool s_log_file_sink_should_wake(void *user_data) {
+    struct aws_napi_log_file_sink *sink = user_data;
+    return sink->sync.flush_requested || sink->sync.shutting_down;
+}
+
+static void s_log_file_sink_thread(void *user_data) {
+    struct aws_napi_log_file_sink *sink = user_data;
+
+    bool done = false;
+    while (!done) {
+        aws_mutex_lock(&sink->sync.lock);
+        /* a timeout just means it's time for a periodic flush */
+        aws_condition_variable_wait_for_pred(
+            &sink->sync.signal,
+            &sink->sync.lock,
+            (int64_t)sink->flush_interval_ns,
+            s_log_file_sink_should_wake,
+            sink);
+
+        /* swap the batch out so that loggers can keep appending while it is written */
+        struct aws_byte_buf batch = sink->sync.pending;
+        sink->sync.pending = sink->writing;
+        sink->writing = batch;
+        size_t dropped = sink->sync.dropped;
+        sink->sync.dropped = 0;
+        sink->sync.flush_requested = false;
+        done = sink->sync.shutting_down;
+        aws_mutex_unlock(&sink->sync.lock);
+
+        if (dropped) {
+            char summary[128];
+            snprintf(
+                summary,
+                sizeof(summary),
+                "[aws-crt-nodejs] %llu log messages dropped, log buffer was full\n",
+                (unsigned long long)dropped);
+            s_log_file_sink_flush(sink, (const uint8_t *)summary, strlen(summary));
+        }
+
+        s_log_file_sink_flush(sink, sink->writing.buffer, sink->writing.len);
+        aws_byte_buf_reset(&sink->writing, false);
+    }
+}
+
+static void s_log_file_sink_destroy(struct aws_napi_log_file_sink *sink) {
+    if (!sink) {
+        return;
+    }
+
+    if (aws_thread_get_detach_state(&sink->thread) == AWS_THREAD_JOINABLE) {
+        aws_mutex_lock(&sink->sync.lock);
+        sink->sync.shutting_down = true;
+        aws_mutex_unlock(&sink->sync.lock);
+        aws_condition_variable_notify_one(&sink->sync.signal);
+        aws_thread_join(&sink->thread);
+    }
+    aws_thread_clean_up(&sink->thread);
+
+    if (sink->file) {
+        fclose(sink->file);
+    }
+    aws_byte_buf_clean_up(&sink->sync.pending);
+    aws_byte_buf_clean_up(&sink->writing);
+    aws_condition_variable_clean_up(&sink->sync.signal);
+    aws_mutex_clean_up(&sink->sync.lock);
+    aws_string_destroy(sink->path);
+    aws_mem_release(sink->allocator, sink);
+}
+
+static struct aws_napi_log_file_sink *s_log_file_sink_new(
+    struct aws_allocator *allocator,
+    const struct aws_napi_log_file_options *options) {
+
+    struct aws_napi_log_file_sink *sink = aws_mem_calloc(allocator, 1, sizeof(struct aws_napi_log_file_sink));
+    if (!sink) {
+        return NULL;
+    }
+    sink->allocator = allocator;
+    sink->path = aws_string_new_from_cursor(allocator, &options->path);
+    /* a zero interval would just spin the writer thread */
+    uint64_t flush_interval_ms = aws_max_u64(options->flush_interval_ms, 1);
+    sink->flush_interval_ns = aws_timestamp_convert(flush_interval_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+    sink->max_file_size = options->max_file_size;
+    sink->max_files = options->max_files;
+    aws_mutex_init(&sink->sync.lock);
+    aws_condition_variable_init(&sink->sync.signal);
+    aws_thread_init(&sink->thread, allocator);
+
+    size_t buffer_size = aws_max_size(options->buffer_size, LOG_FILE_MIN_BUFFER_SIZE);
+    if (aws_byte_buf_init(&sink->sync.pending, allocator, buffer_size) ||
+        aws_byte_buf_init(&sink->writing, allocator, buffer_size)) {
+        goto error;
+    }
+
+    if (s_log_file_sink_open(sink)) {
+        goto error;
+    }
+
+    if (aws_thread_launch(&sink->thread, s_log_file_sink_thread, sink, NULL)) {
+        goto error;
+    }
+
+    return sink;
+
+error:
+    s_log_file_sink_destroy(sink);
+    return NULL;
+}
+
+/* Swaps in a new sink (or none), then shuts down the old one once no logger can still be using it */
+static void s_napi_logger_set_file_sink(struct aws_napi_log_file_sink *sink) {
+    aws_rw_lock_wlock(&s_napi_logger.file_sink_lock);
+    struct aws_napi_log_file_sink *old_sink = s_napi_logger.file_sink;
+    s_napi_logger.file_sink = sink;
+    aws_atomic_store_int(&s_napi_logger.file_sink_active, sink != NULL);
+    aws_rw_lock_wunlock(&s_napi_logger.file_sink_lock);
+
+    s_log_file_sink_destroy(old_sink);
+}
+
+int aws_napi_logger_enable_file(const struct aws_napi_log_file_options *options) {
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_LOGGER);
+    struct aws_napi_log_file_sink *sink = s_log_file_sink_new(allocator, options);
+    if (!sink) {
+        return AWS_OP_ERR;
+    }
+
+    s_napi_logger_set_file_sink(sink);
+    return AWS_OP_SUCCESS;
+}
+
+void aws_napi_logger_disable_file(void) {
+    s_napi_logger_set_file_sink(NULL);
+}
+
+/***********************************************************************************************************************
+ * Writer
+ **********************************************************************************************************************/
+
+/*
+ * custom aws_log_writer that writes to the file sink if there is one, otherwise via process._rawDebug() within the
+ * node env via threadsafe function
+ */
+static int s_napi_log_writer_write(struct aws_log_writer *writer, const struct aws_string *output) {
+    (void)writer;
+
+    if (aws_atomic_load_int(&s_napi_logger.file_sink_active)) {
+        bool written = false;
+        aws_rw_lock_rlock(&s_napi_logger.file_sink_lock);
+        if (s_napi_logger.file_sink) {
+            s_log_file_sink_write(s_napi_logger.file_sink, output);
+            written = true;
+        }
+        aws_rw_lock_runlock(&s_napi_logger.file_sink_lock);
+
+        if (written) {
+            return AWS_OP_SUCCESS;
+        }
+    }
+
+    /* the sink went away after the line was formatted for it, so send it to node instead */
+    if (tl_logger_ctx) {
+        return s_napi_log_ctx_write(tl_logger_ctx, output);
+    }
+
+    int result = AWS_OP_SUCCESS;
+    size_t slot = s_default_ctx_enter();
+    struct aws_napi_logger_ctx *ctx = aws_atomic_load_ptr(&s_napi_logger.default_ctx);
+    if (ctx) {
+        result = s_napi_log_ctx_write(ctx, output);
+    }
+    s_default_ctx_leave(slot);
+
+    return result;
+}
+
 static void s_napi_log_writer_clean_up(struct aws_log_writer *writer) {
     (void)writer;
 }
@@ -120,43 +635,250 @@ void aws_napi_logger_set_level(enum aws_log_level level) {
     aws_atomic_store_int(&((struct aws_logger_pipeline *)s_napi_logger.logger.p_impl)->level, level);
 }
 
-/* Allocator used to allocate buffered log messages from a ring buffer */
-static void *s_ring_buffer_mem_acquire(struct aws_allocator *allocator, size_t size) {
-    struct aws_ring_buffer *buffer = allocator->impl;
-    struct aws_byte_buf buf;
-    AWS_ZERO_STRUCT(buf);
-    /* if the ring buffer is full, fall back to the normal allocator */
-    if (aws_ring_buffer_acquire(buffer, size + sizeof(size_t), &buf)) {
-        AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_byte_buf_init(&buf, buffer->allocator, size + sizeof(size_t)));
+/***********************************************************************************************************************
+ * Per-subject filtering
+ **********************************************************************************************************************/
+
+/*
+ * Token bucket limiting how many lines per second a subject may log. Lines over the limit are counted, and the count is
+ * reported with the next line that gets through.
+ */
+struct log_rate_limiter {
+    struct aws_mutex lock;
+    /* 0 if the limit has been removed */
+    double messages_per_second;
+    double burst;
+    double tokens;
+    uint64_t last_refill_ns;
+    size_t suppressed;
+};
+
+struct log_subject_filter {
+    /* level + 1, or 0 to use the global level */
+    struct aws_atomic_var level;
+    /* struct log_rate_limiter *, allocated the first time a limit is set and kept until the logger shuts down */
+    struct aws_atomic_var limiter;
+};
+
+static struct log_subject_filter s_subject_filters[LOG_FILTER_PACKAGES * LOG_FILTER_SUBJECTS_PER_PACKAGE];
+
+static struct log_subject_filter *s_subject_filter(aws_log_subject_t subject) {
+    size_t package = subject >> AWS_LOG_SUBJECT_STRIDE_BITS;
+    size_t index = subject & (AWS_LOG_SUBJECT_STRIDE - 1);
+    if (package >= LOG_FILTER_PACKAGES || index >= LOG_FILTER_SUBJECTS_PER_PACKAGE) {
+        return NULL;
     }
-    *((size_t *)buf.buffer) = buf.capacity;
-    return buf.buffer + sizeof(size_t);
+    return &s_subject_filters[package * LOG_FILTER_SUBJECTS_PER_PACKAGE + index];
 }
 
-static void s_ring_buffer_mem_release(struct aws_allocator *allocator, void *ptr) {
-    void *addr = ((uint8_t *)ptr - sizeof(size_t));
-    size_t size = *((size_t *)addr);
-    struct aws_byte_buf buf = {
-        .allocator = allocator,
-        .buffer = addr,
-        .capacity = size,
-        .len = 0,
-    };
-    struct aws_ring_buffer *buffer = allocator->impl;
+/* Returns true if a line may be logged, and how many were suppressed since the last one that was */
+static bool s_log_rate_limiter_acquire(struct log_rate_limiter *limiter, size_t *out_suppressed) {
+    bool allowed = true;
+    *out_suppressed = 0;
 
-    /* see if the memory comes from the ring buffer */
-    if (aws_ring_buffer_buf_belongs_to_pool(buffer, &buf)) {
-        aws_ring_buffer_release(buffer, &buf);
-    } else {
-        /* release to the fallback allocator */
-        aws_mem_release(buffer->allocator, addr);
+    aws_mutex_lock(&limiter->lock);
+    if (limiter->messages_per_second > 0) {
+        uint64_t now = 0;
+        aws_high_res_clock_get_ticks(&now);
+        double elapsed_secs = (double)(now - limiter->last_refill_ns) / (double)AWS_TIMESTAMP_NANOS;
+        limiter->last_refill_ns = now;
+        limiter->tokens += elapsed_secs * limiter->messages_per_second;
+        if (limiter->tokens > limiter->burst) {
+            limiter->tokens = limiter->burst;
+        }
+
+        if (limiter->tokens >= 1.0) {
+            limiter->tokens -= 1.0;
+        } else {
+            allowed = false;
+            ++limiter->suppressed;
+        }
     }
+
+    if (allowed) {
+        *out_suppressed = limiter->suppressed;
+        limiter->suppressed = 0;
+    }
+    aws_mutex_unlock(&limiter->lock);
+
+    return allowed;
+}
+
+/*
+ * Lines for node are formatted straight into the queue of the calling thread's env, or of the default env for threads
+ * without one. Lines for the file sink go through the pipeline's formatter and channel to the writer.
+ */
+static int s_napi_logger_vlog(enum aws_log_level level, aws_log_subject_t subject, const char *format, va_list args) {
+    if (!aws_atomic_load_int(&s_napi_logger.file_sink_active)) {
+        /* node threads always log through their own env */
+        if (tl_logger_ctx) {
+            return s_napi_log_ctx_vlog(tl_logger_ctx, level, subject, format, args);
+        }
+
+        int result = AWS_OP_SUCCESS;
+        size_t slot = s_default_ctx_enter();
+        /* this can only be NULL if someone tries to log after the last env has cleaned up, drop the message */
+        struct aws_napi_logger_ctx *ctx = aws_atomic_load_ptr(&s_napi_logger.default_ctx);
+        if (ctx) {
+            result = s_napi_log_ctx_vlog(ctx, level, subject, format, args);
+        }
+        s_default_ctx_leave(slot);
+        return result;
+    }
+
+    struct aws_string *output = NULL;
+    if (s_napi_logger.formatter.vtable->format(&s_napi_logger.formatter, &output, level, subject, format, args)) {
+        return AWS_OP_ERR;
+    }
+
+    if (s_napi_logger.channel.vtable->send(&s_napi_logger.channel, output)) {
+        aws_string_destroy(output);
+        return AWS_OP_ERR;
+    }
+    return AWS_OP_SUCCESS;
 }
 
-static void *s_ring_buffer_mem_calloc(struct aws_allocator *allocator, size_t num, size_t size) {
-    void *mem = s_ring_buffer_mem_acquire(allocator, num * size);
-    memset(mem, 0, size);
-    return mem;
+static int s_napi_logger_logf(enum aws_log_level level, aws_log_subject_t subject, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int result = s_napi_logger_vlog(level, subject, format, args);
+    va_end(args);
+    return result;
+}
+
+static int s_napi_filter_logger_log(
+    struct aws_logger *logger,
+    enum aws_log_level level,
+    aws_log_subject_t subject,
+    const char *format,
+    ...) {
+    (void)logger;
+
+    /* rate limits are checked before anything is formatted */
+    struct log_subject_filter *filter = s_subject_filter(subject);
+    struct log_rate_limiter *limiter = filter ? aws_atomic_load_ptr(&filter->limiter) : NULL;
+    if (limiter) {
+        size_t suppressed = 0;
+        if (!s_log_rate_limiter_acquire(limiter, &suppressed)) {
+            return AWS_OP_SUCCESS;
+        }
+        if (suppressed) {
+            s_napi_logger_logf(
+                level, subject, "%llu log messages suppressed by rate limit", (unsigned long long)suppressed);
+        }
+    }
+
+    va_list args;
+    va_start(args, format);
+    int result = s_napi_logger_vlog(level, subject, format, args);
+    va_end(args);
+    return result;
+}
+
+static enum aws_log_level s_napi_filter_logger_get_log_level(struct aws_logger *logger, aws_log_subject_t subject) {
+    (void)logger;
+
+    struct log_subject_filter *filter = s_subject_filter(subject);
+    if (filter) {
+        size_t level = aws_atomic_load_int(&filter->level);
+        if (level) {
+            return (enum aws_log_level)(level - 1);
+        }
+    }
+    return s_napi_logger.logger.vtable->get_log_level(&s_napi_logger.logger, subject);
+}
+
+static void s_napi_filter_logger_clean_up(struct aws_logger *logger) {
+    (void)logger;
+}
+
+static struct aws_logger_vtable s_napi_filter_logger_vtable = {
+    .log = s_napi_filter_logger_log,
+    .get_log_level = s_napi_filter_logger_get_log_level,
+    .clean_up = s_napi_filter_logger_clean_up,
+};
+
+/* Drops all per-subject settings, only called once no other threads can be logging */
+static void s_subject_filters_clean_up(void) {
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_LOGGER);
+    for (size_t idx = 0; idx < AWS_ARRAY_SIZE(s_subject_filters); ++idx) {
+        aws_atomic_store_int(&s_subject_filters[idx].level, 0);
+        struct log_rate_limiter *limiter = aws_atomic_exchange_ptr(&s_subject_filters[idx].limiter, NULL);
+        if (limiter) {
+            aws_mutex_clean_up(&limiter->lock);
+            aws_mem_release(allocator, limiter);
+        }
+    }
+}
+
+int aws_napi_logger_find_subject(struct aws_byte_cursor name, aws_log_subject_t *out_subject) {
+    /* subjects are only registered with the CRT by name, so walk everything the filter table can hold */
+    for (uint32_t package = 0; package < LOG_FILTER_PACKAGES; ++package) {
+        for (uint32_t index = 0; index < LOG_FILTER_SUBJECTS_PER_PACKAGE; ++index) {
+            aws_log_subject_t subject = AWS_LOG_SUBJECT_BEGIN_RANGE(package) + index;
+            const char *subject_name = aws_log_subject_name(subject);
+            if (subject_name && aws_byte_cursor_eq_c_str(&name, subject_name)) {
+                *out_subject = subject;
+                return AWS_OP_SUCCESS;
+            }
+        }
+    }
+    return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+}
+
+int aws_napi_logger_set_subject_level(aws_log_subject_t subject, enum aws_log_level level) {
+    struct log_subject_filter *filter = s_subject_filter(subject);
+    if (!filter || (uint32_t)level >= AWS_LL_COUNT) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+    aws_atomic_store_int(&filter->level, (size_t)level + 1);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_napi_logger_clear_subject_level(aws_log_subject_t subject) {
+    struct log_subject_filter *filter = s_subject_filter(subject);
+    if (!filter) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+    aws_atomic_store_int(&filter->level, 0);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_napi_logger_set_subject_rate_limit(aws_log_subject_t subject, double messages_per_second, double burst) {
+    struct log_subject_filter *filter = s_subject_filter(subject);
+    if (!filter || !(messages_per_second >= 0)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct log_rate_limiter *limiter = aws_atomic_load_ptr(&filter->limiter);
+    if (!limiter) {
+        if (messages_per_second == 0) {
+            return AWS_OP_SUCCESS;
+        }
+
+        struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_LOGGER);
+        struct log_rate_limiter *new_limiter = aws_mem_calloc(allocator, 1, sizeof(struct log_rate_limiter));
+        aws_mutex_init(&new_limiter->lock);
+
+        /* another env may have gotten there first, in which case use theirs */
+        void *expected = NULL;
+        if (aws_atomic_compare_exchange_ptr(&filter->limiter, &expected, new_limiter)) {
+            limiter = new_limiter;
+        } else {
+            aws_mutex_clean_up(&new_limiter->lock);
+            aws_mem_release(allocator, new_limiter);
+            limiter = expected;
+        }
+    }
+
+    /* limiters stay in place once created, since loggers on other threads may be using them */
+    aws_mutex_lock(&limiter->lock);
+    limiter->messages_per_second = messages_per_second;
+    limiter->burst = burst < 1.0 ? 1.0 : burst;
+    limiter->tokens = limiter->burst;
+    aws_high_res_clock_get_ticks(&limiter->last_refill_ns);
+    aws_mutex_unlock(&limiter->lock);
+    return AWS_OP_SUCCESS;
 }
 
 /* called from every thread as its node environment shuts down */
@@ -166,87 +888,92 @@ void s_threadsafe_log_finalize(napi_env env, void *finalize_data, void *finalize
 
     struct aws_napi_logger_ctx *ctx = finalize_data;
 
-    /* empty message queue, do not need to delete messages as they all come from the ring buffer */
-    struct aws_linked_list msgs;
-    aws_linked_list_init(&msgs);
-    aws_mutex_lock(&ctx->msg_queue.mutex);
-    aws_linked_list_swap_contents(&ctx->msg_queue.messages, &msgs);
-    aws_mutex_unlock(&ctx->msg_queue.mutex);
+    /* any messages still queued are dropped, the records are freed along with the context */
+    /*
+     * Other threads may be logging through this context if it is the default. Stop them from queueing any more calls,
+     * and wait for any that are part way through one, before the function goes away.
+     */
+    aws_rw_lock_wlock(&s_napi_logger.contexts_lock);
+    aws_atomic_store_int(&ctx->log_drain_closed, 1);
+    s_default_ctx_synchronize();
+    aws_rw_lock_wunlock(&s_napi_logger.contexts_lock);
 
-    /* Drop the ref to the function. All attempts to acquire will return napi_closing after this */
+    /* Drop the ref to the function. All attempts to acquire will return napi_closing after this. */
     AWS_NAPI_ENSURE(env, napi_release_threadsafe_function(ctx->log_drain, napi_tsfn_abort));
     ctx->log_drain = NULL;
 
     /* The rest is cleaned up by the env context clean up via aws_napi_logger_destroy() */
 }
 
-/* batch drain the entire queue, subsequent queued calls will do no work */
+/* batch drain the queue, producers will queue another call for anything written after drain_pending is cleared */
 static void s_threadsafe_log_call(napi_env env, napi_value node_log_fn, void *context, void *user_data) {
     (void)user_data;
     struct aws_napi_logger_ctx *ctx = context;
 
-    /* transfer the messages under lock */
-    struct aws_linked_list msgs;
-    aws_linked_list_init(&msgs);
-    aws_mutex_lock(&ctx->msg_queue.mutex);
-    aws_linked_list_swap_contents(&ctx->msg_queue.messages, &msgs);
-    aws_mutex_unlock(&ctx->msg_queue.mutex);
-
     /*
      * If env is null, that means that the function is simply requesting that any resources be
      * freed for shutdown
      */
     if (!env) {
-        goto done;
+        return;
     }
 
-    /* nothing to do, maybe next time... */
-    if (aws_linked_list_empty(&msgs)) {
-        goto done;
-    }
+    /* clear the flag before draining, so that any record published after this point will schedule another drain */
+    aws_atomic_store_int(&ctx->msg_queue.drain_pending, 0);
 
     /*
      * Look up `process` to use as this for the _rawDebug call, if these fail it's because the function
-     * call was queued during shutdown, so we will just skip out of here.
+     * call was queued during shutdown, so the messages are just discarded.
      * Avoid printing scary looking error messages (ex: avoid use of AWS_NAPI_CALL macro).
      */
+    napi_value node_process = NULL;
     napi_value node_global = NULL;
-    if (napi_ok != napi_get_global(env, &node_global)) {
-        goto done;
+    if (napi_ok != napi_get_global(env, &node_global) ||
+        napi_ok != napi_get_named_property(env, node_global, "process", &node_process)) {
+        node_process = NULL;
     }
 
-    napi_value node_process = NULL;
-    if (napi_ok != napi_get_named_property(env, node_global, "process", &node_process)) {
-        goto done;
+    size_t dropped = aws_atomic_exchange_int(&ctx->msg_queue.dropped, 0);
+    if (dropped && node_process) {
+        char summary[128];
+        snprintf(
+            summary,
+            sizeof(summary),
+            "[aws-crt-nodejs] %llu log messages dropped, log queue was full",
+            (unsigned long long)dropped);
+        napi_value node_message = NULL;
+        if (napi_ok == napi_create_string_utf8(env, summary, NAPI_AUTO_LENGTH, &node_message)) {
+            napi_call_function(env, node_process, node_log_fn, 1, &node_message, NULL);
+        }
     }
 
-    for (struct aws_linked_list_node *list_node = aws_linked_list_begin(&msgs); list_node != aws_linked_list_end(&msgs);
-         list_node = aws_linked_list_next(list_node)) {
-
-        struct log_message *msg = AWS_CONTAINER_OF(list_node, struct log_message, node);
-
+    /* bound the work done per call so that a flood of logging from other threads can't starve the event loop */
+    struct log_record *record = NULL;
+    size_t drained = 0;
+    while (drained < LOG_QUEUE_CAPACITY && (record = s_log_queue_peek(ctx)) != NULL) {
+        /* records are left empty when formatting failed */
         napi_value node_message = NULL;
-        if (napi_ok != napi_create_string_utf8(env, aws_string_c_str(msg->message), msg->message->len, &node_message)) {
-            goto done;
+        if (record->len > 0 && node_process &&
+            napi_ok != napi_create_string_utf8(env, record->data, record->len, &node_message)) {
+            node_process = NULL;
         }
 
-        if (napi_ok != napi_call_function(env, node_process, node_log_fn, 1, &node_message, NULL)) {
-            goto done;
+        if (record->len > 0 && node_process &&
+            napi_ok != napi_call_function(env, node_process, node_log_fn, 1, &node_message, NULL)) {
+            node_process = NULL;
         }
-    }
 
-    /* clean up memory and un-pin the log drain function */
-done:
-    while (!aws_linked_list_empty(&msgs)) {
-        struct aws_linked_list_node *list_node = aws_linked_list_pop_front(&msgs);
-        struct log_message *msg = AWS_CONTAINER_OF(list_node, struct log_message, node);
-        aws_string_destroy(msg->message);
-        aws_mem_release(&ctx->buffer_allocator, msg);
+        s_log_queue_pop(ctx, record);
+        ++drained;
     }
 
-    if (env) {
-        AWS_NAPI_ENSURE(env, napi_release_threadsafe_function(ctx->log_drain, napi_tsfn_release));
+    /* more was written while draining than we were willing to process, pick it up next tick */
+    if (s_log_queue_peek(ctx) != NULL) {
+        s_log_schedule_drain(ctx);
     }
+
+    /* un-pin the log drain function */
+    AWS_NAPI_ENSURE(env, napi_release_threadsafe_function(ctx->log_drain, napi_tsfn_release));
 }
 
 void s_threadsafe_log_create(struct aws_napi_logger_ctx *ctx, napi_env env) {
@@ -283,6 +1010,7 @@ void s_threadsafe_log_create(struct aws_napi_logger_ctx *ctx, napi_env env) {
 struct aws_napi_logger_ctx *aws_napi_logger_new(struct aws_allocator *allocator, napi_env env) {
     /* The main thread can be re-initialized multiple times, so just return the one we already have */
     if (tl_logger_ctx) {
+        ++tl_logger_ctx->ref_count;
         return tl_logger_ctx;
     }
 
@@ -290,26 +1018,34 @@ struct aws_napi_logger_ctx *aws_napi_logger_new(struct aws_allocator *allocator,
     AWS_FATAL_ASSERT(ctx && "Failed to allocate new logging context");
     ctx->env = env;
     ctx->allocator = allocator;
-    aws_mutex_init(&ctx->msg_queue.mutex);
-    aws_linked_list_init(&ctx->msg_queue.messages);
+    ctx->ref_count = 1;
+    ctx->msg_queue.records = aws_mem_calloc(allocator, LOG_QUEUE_CAPACITY, sizeof(struct log_record));
+    AWS_FATAL_ASSERT(ctx->msg_queue.records && "Failed to allocate log queue");
+    for (size_t idx = 0; idx < LOG_QUEUE_CAPACITY; ++idx) {
+        aws_atomic_init_int(&ctx->msg_queue.records[idx].sequence, idx);
+    }
+    aws_atomic_init_int(&ctx->msg_queue.enqueue_pos, 0);
+    aws_atomic_init_int(&ctx->msg_queue.dropped, 0);
+    aws_atomic_init_int(&ctx->msg_queue.drain_pending, 0);
+    aws_atomic_init_int(&ctx->log_drain_closed, 0);
 
     /* store this thread's context */
     AWS_FATAL_ASSERT(tl_logger_ctx == NULL && "Cannot initialize multiple logging contexts in a single thread");
     tl_logger_ctx = ctx;
 
-    /* stand up the ring buffer allocator for copying/queueing log messages */
-    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_ring_buffer_init(&ctx->buffer, ctx->allocator, LOG_RING_BUFFER_CAPACITY));
-    ctx->buffer_allocator.mem_acquire = s_ring_buffer_mem_acquire;
-    ctx->buffer_allocator.mem_release = s_ring_buffer_mem_release;
-    ctx->buffer_allocator.mem_calloc = s_ring_buffer_mem_calloc;
-    ctx->buffer_allocator.impl = &ctx->buffer;
-
     /* create the log drain */
     s_threadsafe_log_create(ctx, ctx->env);
 
-    /* The first context created will always be the main thread, so make it the default */
-    if (s_napi_logger.default_ctx == NULL) {
-        s_napi_logger.default_ctx = ctx;
+    /* The first context created is the default until its env goes away */
+    aws_rw_lock_wlock(&s_napi_logger.contexts_lock);
+    aws_linked_list_push_back(&s_napi_logger.contexts, &ctx->node);
+    bool is_default = aws_atomic_load_ptr(&s_napi_logger.default_ctx) == NULL;
+    if (is_default) {
+        aws_atomic_store_ptr(&s_napi_logger.default_ctx, ctx);
+    }
+    aws_rw_lock_wunlock(&s_napi_logger.contexts_lock);
+
+    if (is_default) {
         /* there's only one logger, so if the aws logger isn't ours, set it */
         struct aws_logger *logger = aws_napi_logger_get();
         if (logger != aws_logger_get()) {
@@ -322,24 +1058,49 @@ struct aws_napi_logger_ctx *aws_napi_logger_new(struct aws_allocator *allocator,
 
 void aws_napi_logger_destroy(struct aws_napi_logger_ctx *ctx) {
     AWS_ASSERT(tl_logger_ctx == ctx);
+    if (--ctx->ref_count > 0) {
+        return;
+    }
+
     tl_logger_ctx = NULL;
-    if (s_napi_logger.default_ctx == ctx) {
+
+    /* hand the default off to the next oldest env, if there is one */
+    aws_rw_lock_wlock(&s_napi_logger.contexts_lock);
+    aws_linked_list_remove(&ctx->node);
+    bool no_contexts_left = false;
+    if (aws_atomic_load_ptr(&s_napi_logger.default_ctx) == ctx) {
+        struct aws_napi_logger_ctx *next_ctx = NULL;
+        if (aws_linked_list_empty(&s_napi_logger.contexts)) {
+            no_contexts_left = true;
+        } else {
+            next_ctx =
+                AWS_CONTAINER_OF(aws_linked_list_front(&s_napi_logger.contexts), struct aws_napi_logger_ctx, node);
+        }
+        aws_atomic_store_ptr(&s_napi_logger.default_ctx, next_ctx);
+
+        /* threads that picked this context up before the switch may still be writing to its queue */
+        s_default_ctx_synchronize();
+    }
+    aws_rw_lock_wunlock(&s_napi_logger.contexts_lock);
+
+    if (no_contexts_left) {
         aws_logger_set(NULL);
-        s_napi_logger.default_ctx = NULL;
+        /* flushes anything still buffered and closes the file */
+        s_napi_logger_set_file_sink(NULL);
+        s_subject_filters_clean_up();
     }
 
-    aws_mutex_clean_up(&ctx->msg_queue.mutex);
-    /* don't need to worry about cleaning up the message queue, all of the memory comes from the ring buffer */
-    aws_ring_buffer_clean_up(&ctx->buffer);
+    /* queued records hold no references, so anything left over is simply discarded */
+    aws_mem_release(ctx->allocator, ctx->msg_queue.records);
     aws_mem_release(ctx->allocator, ctx);
 }
 
 struct aws_logger *aws_napi_logger_get(void) {
     if (s_napi_logger.logger.allocator) {
-        return &s_napi_logger.logger;
+        return &s_napi_logger.filter;
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_LOGGER);
 
     s_napi_logger.writer.allocator = allocator;
     s_napi_logger.writer.vtable = &s_napi_log_writer_vtable;
@@ -354,11 +1115,15 @@ struct aws_logger *aws_napi_logger_get(void) {
 
     op_status = aws_logger_init_from_external(
         &s_napi_logger.logger,
-        aws_napi_get_allocator(),
+        aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_LOGGER),
         &s_napi_logger.formatter,
         &s_napi_logger.channel,
         &s_napi_logger.writer,
         AWS_LL_NONE);
     AWS_FATAL_ASSERT(op_status == AWS_OP_SUCCESS && "Failed to initialize logger");
-    return &s_napi_logger.logger;
+
+    s_napi_logger.filter.vtable = &s_napi_filter_logger_vtable;
+    s_napi_logger.filter.allocator = allocator;
+    s_napi_logger.filter.p_impl = NULL;
+    return &s_napi_logger.filter;
 }
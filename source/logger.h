@@ -26,4 +26,49 @@ struct aws_napi_logger_ctx *aws_napi_logger_new(struct aws_allocator *allocator,
 void aws_napi_logger_destroy(struct aws_napi_logger_ctx *logger);
 void aws_napi_logger_set_level(enum aws_log_level level);
 
+struct aws_napi_log_file_options {
+    /* file to append to, created if it does not exist */
+    struct aws_byte_cursor path;
+    /* size of each of the two batch buffers, lines that do not fit while a batch is being written are dropped */
+    size_t buffer_size;
+    /* longest time a line will wait in the buffer before being written */
+    uint64_t flush_interval_ms;
+    /* rotate the file once it would exceed this size, 0 to never rotate */
+    size_t max_file_size;
+    /* number of rotated files (path.1 ... path.N) to keep, 0 to just truncate the file on rotation */
+    size_t max_files;
+};
+
+/**
+ * Sends all logging to a file, written in batches from a dedicated native thread rather than through any node env.
+ * Replaces any file logging set up previously. Raises an aws error and returns AWS_OP_ERR if the file can't be opened.
+ */
+int aws_napi_logger_enable_file(const struct aws_napi_log_file_options *options);
+
+/**
+ * Flushes and closes the file set up by aws_napi_logger_enable_file(), if any, and goes back to logging through node.
+ * Blocks until the writer thread has finished.
+ */
+void aws_napi_logger_disable_file(void);
+
+/**
+ * Looks up a registered log subject by name (e.g. "mqtt5-client"). Only subjects from libraries that have been
+ * initialized can be found. Raises AWS_ERROR_INVALID_ARGUMENT if there is no such subject.
+ */
+int aws_napi_logger_find_subject(struct aws_byte_cursor name, aws_log_subject_t *out_subject);
+
+/**
+ * Overrides the global level for a single subject, in either direction. Lines filtered out this way are never
+ * formatted. aws_napi_logger_clear_subject_level() goes back to following the global level.
+ */
+int aws_napi_logger_set_subject_level(aws_log_subject_t subject, enum aws_log_level level);
+int aws_napi_logger_clear_subject_level(aws_log_subject_t subject);
+
+/**
+ * Limits a subject to messages_per_second lines on average, with bursts of up to burst lines. Lines over the limit are
+ * dropped before they are formatted, and a count of them is logged once lines get through again.
+ * A rate of 0 removes the limit.
+ */
+int aws_napi_logger_set_subject_rate_limit(aws_log_subject_t subject, double messages_per_second, double burst);
+
 #endif /* AWS_CRT_NODEJS_LOGGER_H */
@@ -20,23 +20,31 @@
 
 #include <aws/cal/cal.h>
 
+#include <aws/common/atomics.h>
 #include <aws/common/clock.h>
+#include <aws/common/condition_variable.h>
 #include <aws/common/environment.h>
+#include <aws/common/linked_list.h>
 #include <aws/common/logging.h>
 #include <aws/common/mutex.h>
 #include <aws/common/ref_count.h>
 #include <aws/common/rw_lock.h>
 #include <aws/common/system_info.h>
+#include <aws/common/thread.h>
 
 #include <aws/event-stream/event_stream.h>
 
 #include <aws/io/event_loop.h>
+#include <aws/io/host_resolver.h>
+#include <aws/io/io.h>
 #include <aws/io/tls_channel_handler.h>
 
 #include <aws/http/http.h>
 
 #include <aws/auth/auth.h>
 
+#include <aws/mqtt/mqtt.h>
+
 #include <uv.h>
 
 /*
@@ -56,7 +64,8 @@ AWS_STATIC_ASSERT(NAPI_VERSION >= 4);
 #define NAPI_NO_EXTERNAL_BUFFER_ENUM_VALUE 22
 
 static bool s_tsfn_enabled = false;
-static struct aws_rw_lock s_tsfn_lock;
+/* Shared by every node environment, so it is never torn down; it only guards s_tsfn_enabled */
+static struct aws_rw_lock s_tsfn_lock = AWS_RW_LOCK_INIT;
 
 /* clang-format off */
 static struct aws_error_info s_errors[] = {
@@ -69,6 +78,9 @@ static struct aws_error_info s_errors[] = {
     AWS_DEFINE_ERROR_INFO_CRT_NODEJS(
         AWS_CRT_NODEJS_ERROR_EVENT_STREAM_USER_CLOSE,
         "User invoked close on an eventstream connection."),
+    AWS_DEFINE_ERROR_INFO_CRT_NODEJS(
+        AWS_CRT_NODEJS_ERROR_THREADSAFE_QUEUE_FULL,
+        "A native event could not be delivered to node because too many events are already waiting to be delivered."),
 };
 /* clang-format on */
 
@@ -596,7 +608,58 @@ enum aws_napi_get_named_property_result aws_napi_get_named_property_buffer_lengt
     return result;
 }
 
+/*
+ * napi_get_value_string_utf8() never splits a code point, so a truncated copy can stop up to 3 bytes short of the end
+ * of the buffer (plus the null terminator). Anything shorter than that is known to be the whole string.
+ */
+#define AWS_NAPI_UTF8_MAX_TRUNCATION 4
+
+static napi_status s_byte_buf_init_from_napi_string(
+    struct aws_byte_buf *buf,
+    napi_env env,
+    napi_value node_str,
+    uint8_t *storage,
+    size_t storage_size) {
+
+    /* Try the caller's storage first, which is a single copy and no allocation for short strings */
+    if (storage != NULL && storage_size > AWS_NAPI_UTF8_MAX_TRUNCATION) {
+        size_t length = 0;
+        AWS_NAPI_CALL(env, napi_get_value_string_utf8(env, node_str, (char *)storage, storage_size, &length), {
+            return status;
+        });
+
+        if (length + AWS_NAPI_UTF8_MAX_TRUNCATION < storage_size) {
+            *buf = aws_byte_buf_from_empty_array(storage, storage_size);
+            buf->len = length;
+            return napi_ok;
+        }
+    }
+
+    size_t length = 0;
+    AWS_NAPI_CALL(env, napi_get_value_string_utf8(env, node_str, NULL, 0, &length), { return status; });
+
+    /* Node requires that the null terminator be written */
+    if (aws_byte_buf_init(buf, aws_napi_get_allocator(), length + 1)) {
+        return napi_generic_failure;
+    }
+
+    AWS_NAPI_CALL(env, napi_get_value_string_utf8(env, node_str, (char *)buf->buffer, buf->capacity, &buf->len), {
+        return status;
+    });
+    AWS_ASSERT(length == buf->len);
+    return napi_ok;
+}
+
 napi_status aws_byte_buf_init_from_napi(struct aws_byte_buf *buf, napi_env env, napi_value node_str) {
+    return aws_byte_buf_init_from_napi_with_storage(buf, env, node_str, NULL, 0);
+}
+
+napi_status aws_byte_buf_init_from_napi_with_storage(
+    struct aws_byte_buf *buf,
+    napi_env env,
+    napi_value node_str,
+    uint8_t *storage,
+    size_t storage_size) {
 
     AWS_ASSERT(buf);
 
@@ -604,23 +667,13 @@ napi_status aws_byte_buf_init_from_napi(struct aws_byte_buf *buf, napi_env env,
     AWS_NAPI_CALL(env, napi_typeof(env, node_str, &type), { return status; });
 
     if (type == napi_string) {
-
-        size_t length = 0;
-        AWS_NAPI_CALL(env, napi_get_value_string_utf8(env, node_str, NULL, 0, &length), { return status; });
-
-        /* Node requires that the null terminator be written */
-        if (aws_byte_buf_init(buf, aws_napi_get_allocator(), length + 1)) {
-            return napi_generic_failure;
-        }
-
-        AWS_NAPI_CALL(env, napi_get_value_string_utf8(env, node_str, (char *)buf->buffer, buf->capacity, &buf->len), {
-            return status;
-        });
-        AWS_ASSERT(length == buf->len);
-        return napi_ok;
+        return s_byte_buf_init_from_napi_string(buf, env, node_str, storage, storage_size);
 
     } else if (type == napi_object) {
 
+        /* the buffer is borrowed from node, there is nothing to free */
+        buf->allocator = NULL;
+
         bool is_expected = false;
 
         /* Try ArrayBuffer */
@@ -795,6 +848,96 @@ void aws_napi_throw_last_error_with_context(napi_env env, const char *context) {
     napi_throw_error(env, aws_error_str(error_code), full_msg);
 }
 
+static struct aws_mutex s_module_lock = AWS_MUTEX_INIT;
+static uint32_t s_module_initialize_count = 0;
+
+/*
+ * Number of threads in the default event loop group.  Set through io_set_default_event_loop_thread_count(), or the
+ * AWS_CRT_EVENT_LOOP_THREAD_COUNT environment variable if that was never called.  0 means one thread per processor.
+ */
+AWS_STATIC_STRING_FROM_LITERAL(s_event_loop_thread_count_env_var, "AWS_CRT_EVENT_LOOP_THREAD_COUNT");
+static uint16_t s_default_elg_thread_count = 1;
+static bool s_default_elg_thread_count_is_set = false;
+
+/*
+ * Settings for the default host resolver, which serves every connection made through the default client bootstrap.
+ * Set through io_set_default_host_resolver_options() before the default bootstrap is created.  A max TTL of 0 keeps
+ * the aws-c-io default.
+ */
+static size_t s_default_host_resolver_max_entries = 64;
+static size_t s_default_host_resolver_max_ttl_secs = 0;
+static struct aws_host_resolution_config s_default_host_resolution_config;
+
+static uint16_t s_resolve_default_elg_thread_count_locked(void) {
+    if (s_default_elg_thread_count_is_set) {
+        return s_default_elg_thread_count;
+    }
+
+    struct aws_string *value = NULL;
+    if (aws_get_environment_value(aws_default_allocator(), s_event_loop_thread_count_env_var, &value) ||
+        value == NULL) {
+        return s_default_elg_thread_count;
+    }
+
+    char *end = NULL;
+    long thread_count = strtol(aws_string_c_str(value), &end, 10);
+    if (end == aws_string_c_str(value) || *end != '\0' || thread_count < 0 || thread_count > UINT16_MAX) {
+        AWS_LOGF_WARN(
+            AWS_LS_NODEJS_CRT_GENERAL,
+            "AWS_CRT_EVENT_LOOP_THREAD_COUNT is set to invalid value: %s, using %d thread(s)",
+            aws_string_c_str(value),
+            (int)s_default_elg_thread_count);
+    } else {
+        s_default_elg_thread_count = (uint16_t)thread_count;
+    }
+    aws_string_destroy(value);
+
+    return s_default_elg_thread_count;
+}
+
+static struct aws_event_loop_group *s_get_or_create_default_elg_locked(void) {
+    if (s_node_uv_elg == NULL) {
+        aws_napi_ensure_library_initialized(AWS_NAPI_LIBRARY_IO);
+        uint16_t thread_count = s_resolve_default_elg_thread_count_locked();
+        s_node_uv_elg = aws_event_loop_group_new_default(aws_napi_get_allocator(), thread_count, NULL);
+        AWS_FATAL_ASSERT(s_node_uv_elg != NULL);
+    }
+
+    return s_node_uv_elg;
+}
+
+static struct aws_client_bootstrap *s_get_or_create_default_client_bootstrap_locked(void) {
+    if (s_default_client_bootstrap == NULL) {
+        struct aws_allocator *allocator = aws_napi_get_allocator();
+
+        /*
+         * Default host resolver and client bootstrap to use if none specific at the javascript level.  In most
+         * cases the user doesn't even need to know about these, so let's let them leave it out completely.
+         */
+        AWS_FATAL_ASSERT(s_default_host_resolver == NULL);
+
+        struct aws_host_resolver_default_options resolver_options = {
+            .max_entries = s_default_host_resolver_max_entries,
+            .el_group = s_get_or_create_default_elg_locked(),
+        };
+        s_default_host_resolver = aws_host_resolver_new_default(allocator, &resolver_options);
+        AWS_FATAL_ASSERT(s_default_host_resolver != NULL);
+
+        aws_napi_init_host_resolution_config(&s_default_host_resolution_config, s_default_host_resolver_max_ttl_secs);
+
+        struct aws_client_bootstrap_options bootstrap_options = {
+            .event_loop_group = s_node_uv_elg,
+            .host_resolver = s_default_host_resolver,
+            .host_resolution_config = &s_default_host_resolution_config,
+        };
+
+        s_default_client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
+        AWS_FATAL_ASSERT(s_default_client_bootstrap != NULL);
+    }
+
+    return s_default_client_bootstrap;
+}
+
 struct uv_loop_s *aws_napi_get_node_uv_loop(void) {
     return s_node_uv_loop;
 }
@@ -804,11 +947,135 @@ struct aws_event_loop *aws_napi_get_node_event_loop(void) {
 }
 
 struct aws_event_loop_group *aws_napi_get_node_elg(void) {
-    return s_node_uv_elg;
+    aws_mutex_lock(&s_module_lock);
+    struct aws_event_loop_group *elg = s_get_or_create_default_elg_locked();
+    aws_mutex_unlock(&s_module_lock);
+
+    return elg;
 }
 
 struct aws_client_bootstrap *aws_napi_get_default_client_bootstrap(void) {
-    return s_default_client_bootstrap;
+    aws_mutex_lock(&s_module_lock);
+    struct aws_client_bootstrap *bootstrap = s_get_or_create_default_client_bootstrap_locked();
+    aws_mutex_unlock(&s_module_lock);
+
+    return bootstrap;
+}
+
+struct aws_host_resolver *aws_napi_get_default_host_resolver(struct aws_host_resolution_config *out_config) {
+    aws_mutex_lock(&s_module_lock);
+    s_get_or_create_default_client_bootstrap_locked();
+    struct aws_host_resolver *resolver = s_default_host_resolver;
+    *out_config = s_default_host_resolution_config;
+    aws_mutex_unlock(&s_module_lock);
+
+    return resolver;
+}
+
+void aws_napi_init_host_resolution_config(struct aws_host_resolution_config *config, size_t max_ttl_secs) {
+    /* the same settings aws_client_bootstrap uses when it is not given any */
+    AWS_ZERO_STRUCT(*config);
+    config->impl = aws_default_dns_resolve;
+    config->max_ttl = max_ttl_secs > 0 ? max_ttl_secs : AWS_NAPI_DEFAULT_DNS_TTL_SECS;
+}
+
+napi_value aws_napi_io_set_default_event_loop_thread_count(napi_env env, napi_callback_info info) {
+    napi_value node_args[1];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    AWS_NAPI_CALL(env, napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL), {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    });
+    if (num_args != 1) {
+        napi_throw_error(env, NULL, "io_set_default_event_loop_thread_count needs exactly 1 argument");
+        return NULL;
+    }
+
+    uint32_t thread_count = 0;
+    AWS_NAPI_CALL(env, napi_get_value_uint32(env, node_args[0], &thread_count), {
+        napi_throw_type_error(env, NULL, "thread_count must be a non-negative integer");
+        return NULL;
+    });
+    if (thread_count > UINT16_MAX) {
+        napi_throw_range_error(env, NULL, "thread_count is too large");
+        return NULL;
+    }
+
+    aws_mutex_lock(&s_module_lock);
+    const bool already_created = s_node_uv_elg != NULL;
+    if (!already_created) {
+        s_default_elg_thread_count = (uint16_t)thread_count;
+        s_default_elg_thread_count_is_set = true;
+    }
+    aws_mutex_unlock(&s_module_lock);
+
+    if (already_created) {
+        napi_throw_error(
+            env,
+            NULL,
+            "The default event loop group has already been created, the thread count must be set before the first "
+            "connection or client bootstrap is created");
+    }
+
+    return NULL;
+}
+
+napi_value aws_napi_io_set_default_host_resolver_options(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    AWS_NAPI_CALL(env, napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL), {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    });
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "io_set_default_host_resolver_options needs exactly 2 arguments");
+        return NULL;
+    }
+
+    /* undefined leaves a setting as it is */
+    uint32_t max_entries = 0;
+    bool has_max_entries = !aws_napi_is_null_or_undefined(env, node_args[0]);
+    if (has_max_entries) {
+        AWS_NAPI_CALL(env, napi_get_value_uint32(env, node_args[0], &max_entries), {
+            napi_throw_type_error(env, NULL, "max_entries must be a positive integer");
+            return NULL;
+        });
+        if (max_entries == 0) {
+            napi_throw_range_error(env, NULL, "max_entries must be a positive integer");
+            return NULL;
+        }
+    }
+
+    uint32_t max_ttl_secs = 0;
+    bool has_max_ttl = !aws_napi_is_null_or_undefined(env, node_args[1]);
+    if (has_max_ttl) {
+        AWS_NAPI_CALL(env, napi_get_value_uint32(env, node_args[1], &max_ttl_secs), {
+            napi_throw_type_error(env, NULL, "max_ttl_secs must be a non-negative integer");
+            return NULL;
+        });
+    }
+
+    aws_mutex_lock(&s_module_lock);
+    const bool already_created = s_default_host_resolver != NULL;
+    if (!already_created) {
+        if (has_max_entries) {
+            s_default_host_resolver_max_entries = max_entries;
+        }
+        if (has_max_ttl) {
+            s_default_host_resolver_max_ttl_secs = max_ttl_secs;
+        }
+    }
+    aws_mutex_unlock(&s_module_lock);
+
+    if (already_created) {
+        napi_throw_error(
+            env,
+            NULL,
+            "The default host resolver has already been created, its options must be set before the first "
+            "connection or client bootstrap is created");
+    }
+
+    return NULL;
 }
 
 /* The napi_status enum has grown, and is not bound by N-API versioning */
@@ -1000,6 +1267,37 @@ napi_status aws_napi_create_external_arraybuffer(
     return napi_ok;
 }
 
+/* Calls into JS from a threadsafe function callback. Must be called with s_tsfn_lock held for reading. */
+static napi_status s_call_threadsafe_function_js(
+    napi_env env,
+    napi_value this_ptr,
+    napi_value function,
+    size_t argc,
+    napi_value *argv) {
+
+    napi_status call_status = napi_ok;
+    if (!this_ptr) {
+        AWS_NAPI_ENSURE(env, napi_get_undefined(env, &this_ptr));
+    }
+    AWS_NAPI_CALL(env, napi_call_function(env, this_ptr, function, argc, argv, NULL), {
+        call_status = status;
+        s_handle_failed_callback(env, function, status);
+    });
+
+    return call_status;
+}
+
+/*
+ * Drops the reference taken by aws_napi_queue_threadsafe_function(). Must be called with s_tsfn_lock held for
+ * reading.
+ */
+static napi_status s_complete_threadsafe_function_call(napi_env env, napi_threadsafe_function tsfn) {
+    /* main thread can exit now */
+    napi_unref_threadsafe_function(env, tsfn);
+    /* Must always decrement the ref count, or the function will be pinned */
+    return napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+}
+
 napi_status aws_napi_dispatch_threadsafe_function(
     napi_env env,
     napi_threadsafe_function tsfn,
@@ -1011,18 +1309,8 @@ napi_status aws_napi_dispatch_threadsafe_function(
     aws_rw_lock_rlock(&s_tsfn_lock);
     napi_status result = napi_ok;
     if (s_tsfn_enabled) {
-        napi_status call_status = napi_ok;
-        if (!this_ptr) {
-            AWS_NAPI_ENSURE(env, napi_get_undefined(env, &this_ptr));
-        }
-        AWS_NAPI_CALL(env, napi_call_function(env, this_ptr, function, argc, argv, NULL), {
-            call_status = status;
-            s_handle_failed_callback(env, function, status);
-        });
-        /* main thread can exit now */
-        napi_unref_threadsafe_function(env, tsfn);
-        /* Must always decrement the ref count, or the function will be pinned */
-        napi_status release_status = napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+        napi_status call_status = s_call_threadsafe_function_js(env, this_ptr, function, argc, argv);
+        napi_status release_status = s_complete_threadsafe_function_call(env, tsfn);
         result = (call_status != napi_ok) ? call_status : release_status;
     }
     aws_rw_lock_runlock(&s_tsfn_lock);
@@ -1090,17 +1378,272 @@ napi_status aws_napi_queue_threadsafe_function(napi_threadsafe_function function
     napi_status result = napi_ok;
     aws_rw_lock_rlock(&s_tsfn_lock);
     if (s_tsfn_enabled && function) {
-        /* increase the ref count, gets decreased when the call completes */
-        AWS_NAPI_ENSURE(NULL, napi_acquire_threadsafe_function(function));
-        result = napi_call_threadsafe_function(function, user_data, napi_tsfn_nonblocking);
+        /*
+         * Increase the ref count, gets decreased when the call completes. If the function's environment is shutting
+         * down (a worker thread exiting, for instance) this returns napi_closing, and the call is dropped.
+         */
+        result = napi_acquire_threadsafe_function(function);
+        if (result == napi_ok) {
+            result = napi_call_threadsafe_function(function, user_data, napi_tsfn_nonblocking);
+            if (result != napi_ok) {
+                napi_release_threadsafe_function(function, napi_tsfn_release);
+            }
+        }
     }
     aws_rw_lock_runlock(&s_tsfn_lock);
     return result;
 }
 
+struct aws_napi_threadsafe_batch {
+    struct aws_allocator *allocator;
+    napi_threadsafe_function function;
+    struct aws_napi_threadsafe_batch_options options;
+
+    /* items pushed from any thread, drained on the node thread */
+    struct {
+        struct aws_mutex mutex;
+        struct aws_linked_list items;
+        /* true while a drain call is queued, so that only one call is in flight at a time */
+        bool drain_scheduled;
+        /* true between crossing the high watermark and draining back down to the low watermark */
+        bool above_high_watermark;
+        /* set by release, after which the owner may be gone and on_watermark must not be called */
+        bool released;
+        /* items in the list, and items taken by the current drain which are not yet delivered */
+        size_t queued_count;
+        size_t in_flight_count;
+        size_t peak_pending_count;
+        uint64_t dropped_count;
+        uint64_t delivered_count;
+    } queue;
+};
+
+static void s_threadsafe_batch_destroy_items(struct aws_napi_threadsafe_batch *batch, struct aws_linked_list *items) {
+    while (!aws_linked_list_empty(items)) {
+        struct aws_linked_list_node *item = aws_linked_list_pop_front(items);
+        batch->options.item_destroy(item, batch->options.user_data);
+    }
+}
+
+static void s_threadsafe_batch_deliver(
+    napi_env env,
+    struct aws_napi_threadsafe_batch *batch,
+    napi_value function,
+    struct aws_linked_list *items) {
+
+    napi_value params[2];
+    size_t num_params = 0;
+
+    if (batch->options.prepare != NULL) {
+        if (batch->options.prepare(env, batch->options.user_data, &params[num_params])) {
+            return;
+        }
+        ++num_params;
+    }
+
+    if (batch->options.deliver_as_array) {
+        napi_value node_items = NULL;
+        AWS_NAPI_CALL(env, napi_create_array(env, &node_items), { return; });
+
+        uint32_t index = 0;
+        while (!aws_linked_list_empty(items)) {
+            struct aws_linked_list_node *item = aws_linked_list_pop_front(items);
+            napi_value node_item = NULL;
+            if (batch->options.item_to_js(env, item, batch->options.user_data, &node_item) == AWS_OP_SUCCESS) {
+                AWS_NAPI_CALL(env, napi_set_element(env, node_items, index++, node_item), { return; });
+            }
+        }
+
+        params[num_params++] = node_items;
+        s_call_threadsafe_function_js(env, NULL, function, num_params, params);
+        return;
+    }
+
+    while (!aws_linked_list_empty(items)) {
+        struct aws_linked_list_node *item = aws_linked_list_pop_front(items);
+        if (batch->options.item_to_js(env, item, batch->options.user_data, &params[num_params]) == AWS_OP_SUCCESS) {
+            s_call_threadsafe_function_js(env, NULL, function, num_params + 1, params);
+        }
+    }
+}
+
+static void s_threadsafe_batch_drain(napi_env env, napi_value function, void *context, void *user_data) {
+    (void)user_data;
+    struct aws_napi_threadsafe_batch *batch = context;
+
+    /* transfer the items under lock, anything pushed after this will schedule another drain */
+    struct aws_linked_list items;
+    aws_linked_list_init(&items);
+    aws_mutex_lock(&batch->queue.mutex);
+    aws_linked_list_swap_contents(&batch->queue.items, &items);
+    batch->queue.drain_scheduled = false;
+    batch->queue.in_flight_count = batch->queue.queued_count;
+    batch->queue.queued_count = 0;
+    aws_mutex_unlock(&batch->queue.mutex);
+
+    /* If env is null, the function is being released and the items just need to be freed */
+    if (env) {
+        aws_rw_lock_rlock(&s_tsfn_lock);
+        if (s_tsfn_enabled) {
+            s_threadsafe_batch_deliver(env, batch, function, &items);
+            s_complete_threadsafe_function_call(env, batch->function);
+        }
+        aws_rw_lock_runlock(&s_tsfn_lock);
+    }
+
+    s_threadsafe_batch_destroy_items(batch, &items);
+
+    aws_mutex_lock(&batch->queue.mutex);
+    batch->queue.delivered_count += batch->queue.in_flight_count;
+    batch->queue.in_flight_count = 0;
+    if (batch->queue.above_high_watermark && batch->queue.queued_count <= batch->options.low_watermark) {
+        batch->queue.above_high_watermark = false;
+
+        /*
+         * The owner may have released the batch and freed user_data while items were in flight. A null env means the
+         * function is being torn down, which only happens after release. Calling back under the lock means release
+         * can't complete, and the owner can't be freed, until the callback returns.
+         */
+        if (env != NULL && !batch->queue.released) {
+            batch->options.on_watermark(false, batch->options.user_data);
+        }
+    }
+    aws_mutex_unlock(&batch->queue.mutex);
+}
+
+static void s_threadsafe_batch_finalize(napi_env env, void *finalize_data, void *finalize_hint) {
+    (void)env;
+    (void)finalize_hint;
+    struct aws_napi_threadsafe_batch *batch = finalize_data;
+
+    s_threadsafe_batch_destroy_items(batch, &batch->queue.items);
+    aws_mutex_clean_up(&batch->queue.mutex);
+    aws_mem_release(batch->allocator, batch);
+}
+
+struct aws_napi_threadsafe_batch *aws_napi_threadsafe_batch_new(
+    struct aws_allocator *allocator,
+    napi_env env,
+    napi_value function,
+    const char *name,
+    const struct aws_napi_threadsafe_batch_options *options) {
+
+    AWS_FATAL_ASSERT(options->item_to_js != NULL && options->item_destroy != NULL);
+    AWS_FATAL_ASSERT(options->on_watermark == NULL || options->low_watermark < options->high_watermark);
+
+    struct aws_napi_threadsafe_batch *batch = aws_mem_calloc(allocator, 1, sizeof(struct aws_napi_threadsafe_batch));
+    batch->allocator = allocator;
+    batch->options = *options;
+    aws_mutex_init(&batch->queue.mutex);
+    aws_linked_list_init(&batch->queue.items);
+
+    napi_value resource_name = NULL;
+    AWS_NAPI_ENSURE(env, napi_create_string_utf8(env, name, NAPI_AUTO_LENGTH, &resource_name));
+
+    /* from here on, the batch is freed by the threadsafe function's finalizer */
+    AWS_NAPI_CALL(
+        env,
+        napi_create_threadsafe_function(
+            env,
+            function,
+            NULL /*async_resource*/,
+            resource_name,
+            0 /*max_queue_size - at most one drain is ever queued*/,
+            1 /*initial_thread_count*/,
+            batch /*thread_finalize_data*/,
+            s_threadsafe_batch_finalize,
+            batch,
+            s_threadsafe_batch_drain,
+            &batch->function),
+        {
+            aws_mutex_clean_up(&batch->queue.mutex);
+            aws_mem_release(allocator, batch);
+            aws_raise_error(AWS_CRT_NODEJS_ERROR_NAPI_FAILURE);
+            return NULL;
+        });
+
+    return batch;
+}
+
+int aws_napi_threadsafe_batch_push(struct aws_napi_threadsafe_batch *batch, struct aws_linked_list_node *item) {
+    bool schedule_drain = false;
+    bool above_high_watermark = false;
+
+    aws_mutex_lock(&batch->queue.mutex);
+    size_t pending_count = batch->queue.queued_count + batch->queue.in_flight_count;
+    if (batch->options.max_pending > 0 && pending_count >= batch->options.max_pending) {
+        ++batch->queue.dropped_count;
+        aws_mutex_unlock(&batch->queue.mutex);
+        return aws_raise_error(AWS_CRT_NODEJS_ERROR_THREADSAFE_QUEUE_FULL);
+    }
+
+    aws_linked_list_push_back(&batch->queue.items, item);
+    ++batch->queue.queued_count;
+    ++pending_count;
+    batch->queue.peak_pending_count = aws_max_size(batch->queue.peak_pending_count, pending_count);
+
+    if (batch->options.on_watermark != NULL && !batch->queue.above_high_watermark &&
+        pending_count >= batch->options.high_watermark) {
+        batch->queue.above_high_watermark = true;
+        above_high_watermark = true;
+    }
+
+    if (!batch->queue.drain_scheduled) {
+        batch->queue.drain_scheduled = true;
+        schedule_drain = true;
+    }
+    aws_mutex_unlock(&batch->queue.mutex);
+
+    if (above_high_watermark) {
+        batch->options.on_watermark(true, batch->options.user_data);
+    }
+
+    if (schedule_drain) {
+        napi_status status = aws_napi_queue_threadsafe_function(batch->function, NULL);
+        if (status != napi_ok) {
+            /* the function is shutting down, hand the item back to the caller */
+            aws_mutex_lock(&batch->queue.mutex);
+            aws_linked_list_remove(item);
+            --batch->queue.queued_count;
+            batch->queue.drain_scheduled = false;
+            aws_mutex_unlock(&batch->queue.mutex);
+            return aws_raise_error(AWS_CRT_NODEJS_ERROR_NAPI_FAILURE);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_napi_threadsafe_batch_get_statistics(
+    struct aws_napi_threadsafe_batch *batch,
+    struct aws_napi_threadsafe_batch_statistics *stats) {
+
+    aws_mutex_lock(&batch->queue.mutex);
+    stats->pending_count = batch->queue.queued_count + batch->queue.in_flight_count;
+    stats->peak_pending_count = batch->queue.peak_pending_count;
+    stats->dropped_count = batch->queue.dropped_count;
+    stats->delivered_count = batch->queue.delivered_count;
+    aws_mutex_unlock(&batch->queue.mutex);
+}
+
+void aws_napi_threadsafe_batch_release(struct aws_napi_threadsafe_batch *batch) {
+    if (batch == NULL) {
+        return;
+    }
+
+    /* waits for a drain that is in the middle of a watermark callback, and stops any later drain from making one */
+    aws_mutex_lock(&batch->queue.mutex);
+    batch->queue.released = true;
+    aws_mutex_unlock(&batch->queue.mutex);
+
+    /* any items still queued are freed by the finalizer */
+    AWS_NAPI_ENSURE(NULL, aws_napi_release_threadsafe_function(batch->function, napi_tsfn_abort));
+}
+
 AWS_STATIC_STRING_FROM_LITERAL(s_mem_tracing_env_var, "AWS_CRT_MEMORY_TRACING");
+/* The process-wide allocator: either the default allocator, or a tracer wrapping it when tracing is enabled */
 static struct aws_allocator *s_allocator = NULL;
-struct aws_allocator *aws_napi_get_allocator(void) {
+static struct aws_allocator *s_get_base_allocator(void) {
     if (AWS_UNLIKELY(s_allocator == NULL)) {
         struct aws_string *value = NULL;
         if (aws_get_environment_value(aws_default_allocator(), s_mem_tracing_env_var, &value) || value == NULL) {
@@ -1121,26 +1664,721 @@ struct aws_allocator *aws_napi_get_allocator(void) {
     return s_allocator;
 }
 
-napi_value aws_napi_native_memory(napi_env env, napi_callback_info info) {
-    (void)info;
-    napi_value node_allocated = NULL;
-    size_t allocated = 0;
-    if (aws_napi_get_allocator() != aws_default_allocator()) {
-        allocated = aws_mem_tracer_bytes(aws_napi_get_allocator());
-    }
-    AWS_NAPI_CALL(env, napi_create_int64(env, allocated, &node_allocated), { return NULL; });
-    return node_allocated;
-}
-
+/*
+ * Every allocation made through the bindings is prefixed with a header recording its size and tag, so that each tag
+ * can keep running totals without a lookup on release. Since the header travels with the memory, it does not matter
+ * which tagged allocator frees it: the tag it was charged to is the one that gets credited.
+ */
+struct aws_napi_memory_tag_header {
+    size_t size;
+    size_t tag;
+};
+
+struct aws_napi_memory_tag_stats {
+    struct aws_atomic_var bytes_active;
+    struct aws_atomic_var allocations_active;
+    struct aws_atomic_var bytes_peak;
+};
+
+static struct aws_napi_memory_tag_stats s_memory_tag_stats[AWS_NAPI_MEMORY_TAG_COUNT];
+
+static const char *s_memory_tag_names[AWS_NAPI_MEMORY_TAG_COUNT] = {
+    [AWS_NAPI_MEMORY_TAG_GENERAL] = "general",
+    [AWS_NAPI_MEMORY_TAG_MQTT5] = "mqtt5",
+    [AWS_NAPI_MEMORY_TAG_MQTT3] = "mqtt3",
+    [AWS_NAPI_MEMORY_TAG_HTTP] = "http",
+    [AWS_NAPI_MEMORY_TAG_EVENT_STREAM] = "event_stream",
+    [AWS_NAPI_MEMORY_TAG_AUTH] = "auth",
+    [AWS_NAPI_MEMORY_TAG_IO] = "io",
+    [AWS_NAPI_MEMORY_TAG_LOGGER] = "logger",
+};
+
+static void s_memory_tag_charge(size_t tag, size_t size) {
+    struct aws_napi_memory_tag_stats *stats = &s_memory_tag_stats[tag];
+    size_t bytes_active = aws_atomic_fetch_add(&stats->bytes_active, size) + size;
+    aws_atomic_fetch_add(&stats->allocations_active, 1);
+
+    size_t bytes_peak = aws_atomic_load_int(&stats->bytes_peak);
+    while (bytes_active > bytes_peak &&
+           !aws_atomic_compare_exchange_int(&stats->bytes_peak, &bytes_peak, bytes_active)) {
+    }
+}
+
+static void s_memory_tag_credit(size_t tag, size_t size) {
+    struct aws_napi_memory_tag_stats *stats = &s_memory_tag_stats[tag];
+    aws_atomic_fetch_sub(&stats->bytes_active, size);
+    aws_atomic_fetch_sub(&stats->allocations_active, 1);
+}
+
+static void *s_tagged_mem_acquire(struct aws_allocator *allocator, size_t size) {
+    size_t tag = (size_t)allocator->impl;
+
+    struct aws_napi_memory_tag_header *header =
+        aws_mem_acquire(s_get_base_allocator(), sizeof(struct aws_napi_memory_tag_header) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+
+    header->size = size;
+    header->tag = tag;
+    s_memory_tag_charge(tag, size);
+
+    return header + 1;
+}
+
+static void *s_tagged_mem_calloc(struct aws_allocator *allocator, size_t num, size_t size) {
+    size_t total = 0;
+    if (aws_mul_size_checked(num, size, &total)) {
+        return NULL;
+    }
+
+    void *mem = s_tagged_mem_acquire(allocator, total);
+    if (mem != NULL) {
+        memset(mem, 0, total);
+    }
+
+    return mem;
+}
+
+static void s_tagged_mem_release(struct aws_allocator *allocator, void *ptr) {
+    (void)allocator;
+
+    struct aws_napi_memory_tag_header *header = (struct aws_napi_memory_tag_header *)ptr - 1;
+    s_memory_tag_credit(header->tag, header->size);
+
+    aws_mem_release(s_get_base_allocator(), header);
+}
+
+#define AWS_NAPI_TAGGED_ALLOCATOR(TAG)                                                                                 \
+    {                                                                                                                  \
+        .mem_acquire = s_tagged_mem_acquire,                                                                           \
+        .mem_release = s_tagged_mem_release,                                                                           \
+        .mem_calloc = s_tagged_mem_calloc,                                                                             \
+        .impl = (void *)(size_t)(TAG),                                                                                 \
+    }
+
+static struct aws_allocator s_tagged_allocators[AWS_NAPI_MEMORY_TAG_COUNT] = {
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_GENERAL),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_MQTT5),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_MQTT3),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_HTTP),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_EVENT_STREAM),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_AUTH),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_IO),
+    AWS_NAPI_TAGGED_ALLOCATOR(AWS_NAPI_MEMORY_TAG_LOGGER),
+};
+
+struct aws_allocator *aws_napi_get_tagged_allocator(enum aws_napi_memory_tag tag) {
+    AWS_FATAL_ASSERT((size_t)tag < AWS_NAPI_MEMORY_TAG_COUNT);
+    return &s_tagged_allocators[tag];
+}
+
+struct aws_allocator *aws_napi_get_allocator(void) {
+    return aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_GENERAL);
+}
+
+napi_value aws_napi_native_memory(napi_env env, napi_callback_info info) {
+    (void)info;
+    napi_value node_allocated = NULL;
+    size_t allocated = 0;
+    if (s_get_base_allocator() != aws_default_allocator()) {
+        allocated = aws_mem_tracer_bytes(s_get_base_allocator());
+    }
+    AWS_NAPI_CALL(env, napi_create_int64(env, allocated, &node_allocated), { return NULL; });
+    return node_allocated;
+}
+
 napi_value aws_napi_native_memory_dump(napi_env env, napi_callback_info info) {
     (void)info;
     (void)env;
-    if (aws_napi_get_allocator() != aws_default_allocator()) {
-        aws_mem_tracer_dump(aws_napi_get_allocator());
+    if (s_get_base_allocator() != aws_default_allocator()) {
+        aws_mem_tracer_dump(s_get_base_allocator());
     }
     return NULL;
 }
 
+napi_value aws_napi_native_memory_breakdown(napi_env env, napi_callback_info info) {
+    (void)info;
+
+    napi_value node_breakdown = NULL;
+    AWS_NAPI_CALL(env, napi_create_object(env, &node_breakdown), { return NULL; });
+
+    for (size_t tag = 0; tag < AWS_NAPI_MEMORY_TAG_COUNT; ++tag) {
+        struct aws_napi_memory_tag_stats *stats = &s_memory_tag_stats[tag];
+
+        napi_value node_stats = NULL;
+        AWS_NAPI_CALL(env, napi_create_object(env, &node_stats), { return NULL; });
+
+        if (aws_napi_attach_object_property_u64(
+                node_stats, env, "bytes_active", aws_atomic_load_int(&stats->bytes_active)) ||
+            aws_napi_attach_object_property_u64(
+                node_stats, env, "allocations_active", aws_atomic_load_int(&stats->allocations_active)) ||
+            aws_napi_attach_object_property_u64(
+                node_stats, env, "bytes_peak", aws_atomic_load_int(&stats->bytes_peak))) {
+            napi_throw_error(env, NULL, "Unable to build native memory breakdown");
+            return NULL;
+        }
+
+        AWS_NAPI_CALL(env, napi_set_named_property(env, node_breakdown, s_memory_tag_names[tag], node_stats), {
+            return NULL;
+        });
+    }
+
+    return node_breakdown;
+}
+
+/*
+ * Pool for the small per-event structs that are allocated on event loop threads and freed on the node thread.
+ *
+ * Each thread gets its own cache of free blocks per size class, so allocating never takes a lock. A block freed by the
+ * thread that allocated it goes straight back on that thread's free list. A block freed on any other thread (the usual
+ * case: allocated on an event loop, freed on the node thread) is pushed onto its owner's lock-free return stack, which
+ * the owner takes in one exchange the next time its free list runs dry. Either way a cache keeps at most
+ * AWS_NAPI_SMALL_OBJECT_CACHE_LIMIT free blocks per size class, and hands anything beyond that back to the parent
+ * allocator. Every block carries a header naming its owning cache and size class. Requests above the largest size
+ * class get a header too, but go straight to the parent allocator.
+ *
+ * When a CRT thread exits, or a node environment goes away on its thread, that thread's cache is orphaned: its free
+ * blocks are released, and blocks freed to it afterwards go straight back to the parent allocator. The next thread to
+ * need a cache adopts an orphan rather than making a new one, so threads coming and going (event loop groups created
+ * per bootstrap, for instance) don't grow the pool. Caches are registered in a global list so they can be counted,
+ * adopted and freed at module clean up, and are never freed before then since blocks can be returned to a cache after
+ * its thread has exited.
+ */
+#define AWS_NAPI_SMALL_OBJECT_MIN_SIZE 64
+#define AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES 4 /* 64, 128, 256 and 512 bytes */
+#define AWS_NAPI_SMALL_OBJECT_OVERSIZED AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES
+/* free blocks a thread keeps per size class before handing them back to the parent allocator */
+#define AWS_NAPI_SMALL_OBJECT_CACHE_LIMIT 256
+
+struct small_object_cache;
+
+struct small_object_header {
+    struct small_object_cache *owner;
+    struct small_object_header *next;
+    size_t size_class;
+    size_t padding; /* keeps the object that follows 16 byte aligned on 64 bit platforms */
+};
+
+/*
+ * The free lists and the use counters are only written by the owning thread, the counters atomically so that statistics
+ * can read them from any thread. bytes_reserved is also lowered by threads releasing blocks to an orphaned cache.
+ */
+struct small_object_cache {
+    struct aws_linked_list_node node;
+    struct small_object_header *free_list[AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES];
+    size_t free_count[AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES];
+    /* struct small_object_header *, blocks freed by other threads */
+    struct aws_atomic_var returned[AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES];
+    /* 1 once the owning thread is gone, until another thread adopts the cache */
+    struct aws_atomic_var orphaned;
+
+    struct aws_atomic_var reused_count;
+    struct aws_atomic_var new_count;
+    struct aws_atomic_var oversized_count;
+    struct aws_atomic_var bytes_reserved;
+};
+
+static struct {
+    struct aws_allocator *parent;
+    struct aws_mutex lock;
+    struct aws_linked_list caches;
+    /* bumped whenever the caches are freed, so that threads know their cached pointer is stale */
+    size_t generation;
+    bool initialized;
+} s_small_object_pool = {
+    .lock = AWS_MUTEX_INIT,
+};
+
+static AWS_THREAD_LOCAL struct small_object_cache *tl_small_object_cache;
+static AWS_THREAD_LOCAL size_t tl_small_object_cache_generation;
+
+static size_t s_small_object_class_size(size_t size_class) {
+    return (size_t)AWS_NAPI_SMALL_OBJECT_MIN_SIZE << size_class;
+}
+
+static size_t s_small_object_block_size(size_t size_class) {
+    return sizeof(struct small_object_header) + s_small_object_class_size(size_class);
+}
+
+static size_t s_small_object_size_class(size_t size) {
+    size_t size_class = 0;
+    while (size_class < AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES && size > s_small_object_class_size(size_class)) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+static void s_small_object_counter_add(struct aws_atomic_var *counter, size_t amount) {
+    aws_atomic_store_int_explicit(
+        counter, aws_atomic_load_int_explicit(counter, aws_memory_order_relaxed) + amount, aws_memory_order_relaxed);
+}
+
+/* This thread's cache, or NULL if it hasn't made one since the caches were last freed or it was orphaned */
+static struct small_object_cache *s_small_object_cache_current(void) {
+    if (tl_small_object_cache_generation != s_small_object_pool.generation) {
+        return NULL;
+    }
+    return tl_small_object_cache;
+}
+
+/* Hands a block back to the parent allocator, and stops counting it against its cache. Safe from any thread. */
+static void s_small_object_block_free(struct small_object_cache *cache, struct small_object_header *header) {
+    aws_atomic_fetch_sub_explicit(
+        &cache->bytes_reserved, s_small_object_block_size(header->size_class), aws_memory_order_relaxed);
+    aws_mem_release(s_small_object_pool.parent, header);
+}
+
+/* Frees everything on a cache's return stacks. Safe from any thread, since each block is taken by one exchange. */
+static void s_small_object_cache_free_returned(struct small_object_cache *cache) {
+    for (size_t i = 0; i < AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES; ++i) {
+        struct small_object_header *header = aws_atomic_exchange_ptr(&cache->returned[i], NULL);
+        while (header != NULL) {
+            struct small_object_header *next = header->next;
+            s_small_object_block_free(cache, header);
+            header = next;
+        }
+    }
+}
+
+/*
+ * Run on a cache's own thread as the thread exits or its node environment goes away. Releases the cache's free blocks
+ * and marks it orphaned, so that blocks freed to it from then on go straight back to the parent allocator.
+ */
+static void s_small_object_cache_orphan(void *user_data) {
+    struct small_object_cache *cache = user_data;
+
+    /* the pool may have been cleaned up, or the cache orphaned already, since the exit hook was registered */
+    if (cache == NULL || cache != s_small_object_cache_current()) {
+        return;
+    }
+    tl_small_object_cache = NULL;
+
+    for (size_t i = 0; i < AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES; ++i) {
+        while (cache->free_list[i] != NULL) {
+            struct small_object_header *header = cache->free_list[i];
+            cache->free_list[i] = header->next;
+            s_small_object_block_free(cache, header);
+        }
+        cache->free_count[i] = 0;
+    }
+
+    /* blocks pushed before other threads see the flag are collected here, the rest are freed by those threads */
+    aws_atomic_store_int(&cache->orphaned, 1);
+    s_small_object_cache_free_returned(cache);
+}
+
+static struct small_object_cache *s_small_object_cache_get(void) {
+    struct small_object_cache *cache = s_small_object_cache_current();
+    if (AWS_LIKELY(cache != NULL)) {
+        return cache;
+    }
+
+    aws_mutex_lock(&s_small_object_pool.lock);
+
+    /* take over the cache of a thread that has gone, if there is one */
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&s_small_object_pool.caches);
+         node != aws_linked_list_end(&s_small_object_pool.caches);
+         node = aws_linked_list_next(node)) {
+        struct small_object_cache *orphan = AWS_CONTAINER_OF(node, struct small_object_cache, node);
+        size_t expected = 1;
+        if (aws_atomic_compare_exchange_int(&orphan->orphaned, &expected, 0)) {
+            cache = orphan;
+            break;
+        }
+    }
+
+    if (cache == NULL) {
+        cache = aws_mem_calloc(s_small_object_pool.parent, 1, sizeof(struct small_object_cache));
+        if (!cache) {
+            aws_mutex_unlock(&s_small_object_pool.lock);
+            return NULL;
+        }
+        for (size_t i = 0; i < AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES; ++i) {
+            aws_atomic_init_ptr(&cache->returned[i], NULL);
+        }
+        aws_atomic_init_int(&cache->orphaned, 0);
+        aws_atomic_init_int(&cache->reused_count, 0);
+        aws_atomic_init_int(&cache->new_count, 0);
+        aws_atomic_init_int(&cache->oversized_count, 0);
+        aws_atomic_init_int(&cache->bytes_reserved, 0);
+        aws_linked_list_push_back(&s_small_object_pool.caches, &cache->node);
+    }
+
+    tl_small_object_cache_generation = s_small_object_pool.generation;
+    aws_mutex_unlock(&s_small_object_pool.lock);
+
+    tl_small_object_cache = cache;
+
+    /*
+     * Only threads started by the CRT can register an exit hook. Node's own threads keep their cache until their
+     * environment is torn down (see s_napi_context_finalize), so a failure here is expected and not reported.
+     */
+    int last_error = aws_last_error();
+    if (aws_thread_current_at_exit(s_small_object_cache_orphan, cache)) {
+        aws_raise_error(last_error);
+    }
+
+    return cache;
+}
+
+static void *s_small_object_mem_acquire(struct aws_allocator *allocator, size_t size) {
+    (void)allocator;
+
+    struct small_object_cache *cache = s_small_object_cache_get();
+    if (!cache) {
+        return NULL;
+    }
+
+    size_t size_class = s_small_object_size_class(size);
+    if (size_class == AWS_NAPI_SMALL_OBJECT_OVERSIZED) {
+        struct small_object_header *header =
+            aws_mem_acquire(s_small_object_pool.parent, sizeof(struct small_object_header) + size);
+        if (!header) {
+            return NULL;
+        }
+        header->owner = NULL;
+        header->size_class = AWS_NAPI_SMALL_OBJECT_OVERSIZED;
+        s_small_object_counter_add(&cache->oversized_count, 1);
+        return header + 1;
+    }
+
+    /* out of local blocks, collect everything other threads have freed since last time, keeping up to the limit */
+    if (cache->free_list[size_class] == NULL) {
+        struct small_object_header *returned = aws_atomic_exchange_ptr(&cache->returned[size_class], NULL);
+        while (returned != NULL) {
+            struct small_object_header *next = returned->next;
+            if (cache->free_count[size_class] >= AWS_NAPI_SMALL_OBJECT_CACHE_LIMIT) {
+                s_small_object_block_free(cache, returned);
+            } else {
+                returned->next = cache->free_list[size_class];
+                cache->free_list[size_class] = returned;
+                ++cache->free_count[size_class];
+            }
+            returned = next;
+        }
+    }
+
+    struct small_object_header *header = cache->free_list[size_class];
+    if (header != NULL) {
+        cache->free_list[size_class] = header->next;
+        --cache->free_count[size_class];
+        s_small_object_counter_add(&cache->reused_count, 1);
+        return header + 1;
+    }
+
+    size_t block_size = s_small_object_block_size(size_class);
+    header = aws_mem_acquire(s_small_object_pool.parent, block_size);
+    if (!header) {
+        return NULL;
+    }
+    header->owner = cache;
+    header->size_class = size_class;
+    s_small_object_counter_add(&cache->new_count, 1);
+    aws_atomic_fetch_add_explicit(&cache->bytes_reserved, block_size, aws_memory_order_relaxed);
+    return header + 1;
+}
+
+static void s_small_object_mem_release(struct aws_allocator *allocator, void *ptr) {
+    (void)allocator;
+
+    struct small_object_header *header = (struct small_object_header *)ptr - 1;
+    struct small_object_cache *owner = header->owner;
+    size_t size_class = header->size_class;
+    if (owner == NULL) {
+        aws_mem_release(s_small_object_pool.parent, header);
+        return;
+    }
+
+    if (owner != s_small_object_cache_current()) {
+        if (aws_atomic_load_int(&owner->orphaned)) {
+            s_small_object_block_free(owner, header);
+            return;
+        }
+
+        struct small_object_header *expected = aws_atomic_load_ptr(&owner->returned[size_class]);
+        do {
+            header->next = expected;
+        } while (!aws_atomic_compare_exchange_ptr(&owner->returned[size_class], (void **)&expected, header));
+
+        /* the owner may have been orphaned after the check above and missed this block, so nobody else will take it */
+        if (aws_atomic_load_int(&owner->orphaned)) {
+            s_small_object_cache_free_returned(owner);
+        }
+        return;
+    }
+
+    if (owner->free_count[size_class] >= AWS_NAPI_SMALL_OBJECT_CACHE_LIMIT) {
+        s_small_object_block_free(owner, header);
+        return;
+    }
+
+    header->next = owner->free_list[size_class];
+    owner->free_list[size_class] = header;
+    ++owner->free_count[size_class];
+}
+
+static struct aws_allocator s_small_object_allocator = {
+    .mem_acquire = s_small_object_mem_acquire,
+    .mem_release = s_small_object_mem_release,
+};
+
+struct aws_allocator *aws_napi_get_small_object_allocator(void) {
+    AWS_FATAL_ASSERT(s_small_object_pool.initialized && "Small object pool used before module initialization");
+    return &s_small_object_allocator;
+}
+
+static void s_small_object_pool_init(struct aws_allocator *allocator) {
+    aws_mutex_lock(&s_small_object_pool.lock);
+    if (!s_small_object_pool.initialized) {
+        s_small_object_pool.parent = allocator;
+        aws_linked_list_init(&s_small_object_pool.caches);
+        s_small_object_pool.initialized = true;
+    }
+    aws_mutex_unlock(&s_small_object_pool.lock);
+}
+
+/* Releases a list of free blocks to the parent allocator, returning how many there were */
+static size_t s_small_object_free_blocks(struct small_object_header *header) {
+    size_t count = 0;
+    while (header != NULL) {
+        struct small_object_header *next = header->next;
+        aws_mem_release(s_small_object_pool.parent, header);
+        header = next;
+        ++count;
+    }
+    return count;
+}
+
+/*
+ * Called once every env is gone and the native threads have been joined. Frees every cached block and cache, unless
+ * node still holds blocks in externals that haven't been finalized yet. In that case the caches are left as they are,
+ * rather than pulling memory out from under those externals, and the next module init keeps using them.
+ */
+static void s_small_object_pool_clean_up(void) {
+    aws_mutex_lock(&s_small_object_pool.lock);
+
+    size_t bytes_reserved = 0;
+    size_t bytes_free = 0;
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&s_small_object_pool.caches);
+         node != aws_linked_list_end(&s_small_object_pool.caches);
+         node = aws_linked_list_next(node)) {
+        struct small_object_cache *cache = AWS_CONTAINER_OF(node, struct small_object_cache, node);
+        bytes_reserved += aws_atomic_load_int(&cache->bytes_reserved);
+
+        for (size_t i = 0; i < AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES; ++i) {
+            size_t block_size = s_small_object_block_size(i);
+            bytes_free += cache->free_count[i] * block_size;
+            for (struct small_object_header *header = aws_atomic_load_ptr(&cache->returned[i]); header != NULL;
+                 header = header->next) {
+                bytes_free += block_size;
+            }
+        }
+    }
+
+    if (bytes_free == bytes_reserved) {
+        while (!aws_linked_list_empty(&s_small_object_pool.caches)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&s_small_object_pool.caches);
+            struct small_object_cache *cache = AWS_CONTAINER_OF(node, struct small_object_cache, node);
+            for (size_t i = 0; i < AWS_NAPI_SMALL_OBJECT_SIZE_CLASSES; ++i) {
+                s_small_object_free_blocks(cache->free_list[i]);
+                s_small_object_free_blocks(aws_atomic_load_ptr(&cache->returned[i]));
+            }
+            aws_mem_release(s_small_object_pool.parent, cache);
+        }
+        ++s_small_object_pool.generation;
+        s_small_object_pool.initialized = false;
+    }
+
+    aws_mutex_unlock(&s_small_object_pool.lock);
+}
+
+napi_value aws_napi_native_memory_pool_statistics(napi_env env, napi_callback_info info) {
+    (void)info;
+
+    uint64_t reused_count = 0;
+    uint64_t new_count = 0;
+    uint64_t oversized_count = 0;
+    uint64_t bytes_reserved = 0;
+    uint64_t thread_count = 0;
+
+    aws_mutex_lock(&s_small_object_pool.lock);
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&s_small_object_pool.caches);
+         node != aws_linked_list_end(&s_small_object_pool.caches);
+         node = aws_linked_list_next(node)) {
+        struct small_object_cache *cache = AWS_CONTAINER_OF(node, struct small_object_cache, node);
+        reused_count += aws_atomic_load_int_explicit(&cache->reused_count, aws_memory_order_relaxed);
+        new_count += aws_atomic_load_int_explicit(&cache->new_count, aws_memory_order_relaxed);
+        oversized_count += aws_atomic_load_int_explicit(&cache->oversized_count, aws_memory_order_relaxed);
+        bytes_reserved += aws_atomic_load_int_explicit(&cache->bytes_reserved, aws_memory_order_relaxed);
+        if (!aws_atomic_load_int(&cache->orphaned)) {
+            ++thread_count;
+        }
+    }
+    aws_mutex_unlock(&s_small_object_pool.lock);
+
+    napi_value node_stats = NULL;
+    AWS_NAPI_CALL(env, napi_create_object(env, &node_stats), { return NULL; });
+
+    if (aws_napi_attach_object_property_u64(node_stats, env, "reused_count", reused_count) ||
+        aws_napi_attach_object_property_u64(node_stats, env, "new_count", new_count) ||
+        aws_napi_attach_object_property_u64(node_stats, env, "oversized_count", oversized_count) ||
+        aws_napi_attach_object_property_u64(node_stats, env, "bytes_reserved", bytes_reserved) ||
+        aws_napi_attach_object_property_u64(node_stats, env, "thread_count", thread_count)) {
+        napi_throw_error(env, NULL, "Unable to build memory pool statistics");
+        return NULL;
+    }
+
+    return node_stats;
+}
+
+/*
+ * Shared between the node thread and the worker thread started by aws_napi_native_memory_pool_exercise. Each round the
+ * worker allocates count blocks and hands them over, and the node thread frees them all before the next round.
+ */
+struct small_object_pool_exercise {
+    struct aws_mutex lock;
+    struct aws_condition_variable signal;
+    size_t rounds;
+    size_t count;
+    void **blocks;
+    /* true while the worker's blocks are waiting to be freed by the node thread */
+    bool blocks_ready;
+    size_t max_bytes_kept;
+};
+
+static bool s_small_object_pool_exercise_blocks_ready(void *user_data) {
+    struct small_object_pool_exercise *exercise = user_data;
+    return exercise->blocks_ready;
+}
+
+static bool s_small_object_pool_exercise_blocks_freed(void *user_data) {
+    struct small_object_pool_exercise *exercise = user_data;
+    return !exercise->blocks_ready;
+}
+
+static void s_small_object_pool_exercise_worker(void *user_data) {
+    struct small_object_pool_exercise *exercise = user_data;
+    struct aws_allocator *allocator = aws_napi_get_small_object_allocator();
+
+    for (size_t round = 0; round < exercise->rounds; ++round) {
+        aws_mutex_lock(&exercise->lock);
+        aws_condition_variable_wait_pred(
+            &exercise->signal, &exercise->lock, s_small_object_pool_exercise_blocks_freed, exercise);
+        aws_mutex_unlock(&exercise->lock);
+
+        for (size_t i = 0; i < exercise->count; ++i) {
+            exercise->blocks[i] = aws_mem_acquire(allocator, 64);
+            if (i == 0) {
+                /* the first acquire of a round collects everything the node thread freed in the last one */
+                size_t bytes_kept = aws_atomic_load_int(&s_small_object_cache_current()->bytes_reserved);
+                exercise->max_bytes_kept = aws_max_size(exercise->max_bytes_kept, bytes_kept);
+            }
+        }
+
+        aws_mutex_lock(&exercise->lock);
+        exercise->blocks_ready = true;
+        aws_mutex_unlock(&exercise->lock);
+        aws_condition_variable_notify_one(&exercise->signal);
+    }
+}
+
+napi_value aws_napi_native_memory_pool_exercise(napi_env env, napi_callback_info info) {
+    napi_value node_args[2];
+    size_t num_args = AWS_ARRAY_SIZE(node_args);
+    AWS_NAPI_CALL(env, napi_get_cb_info(env, info, &num_args, node_args, NULL, NULL), {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    });
+    if (num_args != AWS_ARRAY_SIZE(node_args)) {
+        napi_throw_error(env, NULL, "native_memory_pool_exercise needs exactly 2 arguments");
+        return NULL;
+    }
+
+    uint32_t rounds = 0;
+    uint32_t count = 0;
+    AWS_NAPI_CALL(env, napi_get_value_uint32(env, node_args[0], &rounds), {
+        napi_throw_type_error(env, NULL, "rounds must be a non-negative integer");
+        return NULL;
+    });
+    AWS_NAPI_CALL(env, napi_get_value_uint32(env, node_args[1], &count), {
+        napi_throw_type_error(env, NULL, "count must be a non-negative integer");
+        return NULL;
+    });
+    if (count == 0) {
+        napi_throw_range_error(env, NULL, "count must be at least 1");
+        return NULL;
+    }
+
+    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *small_object_allocator = aws_napi_get_small_object_allocator();
+
+    struct small_object_pool_exercise exercise;
+    AWS_ZERO_STRUCT(exercise);
+    exercise.rounds = rounds;
+    exercise.count = count;
+    exercise.blocks = aws_mem_calloc(allocator, count, sizeof(void *));
+    aws_mutex_init(&exercise.lock);
+    aws_condition_variable_init(&exercise.signal);
+
+    struct aws_thread worker;
+    aws_thread_init(&worker, allocator);
+    bool launched = aws_thread_launch(&worker, s_small_object_pool_exercise_worker, &exercise, NULL) == AWS_OP_SUCCESS;
+
+    for (size_t round = 0; launched && round < rounds; ++round) {
+        aws_mutex_lock(&exercise.lock);
+        aws_condition_variable_wait_pred(
+            &exercise.signal, &exercise.lock, s_small_object_pool_exercise_blocks_ready, &exercise);
+        aws_mutex_unlock(&exercise.lock);
+
+        for (size_t i = 0; i < count; ++i) {
+            aws_mem_release(small_object_allocator, exercise.blocks[i]);
+        }
+
+        aws_mutex_lock(&exercise.lock);
+        exercise.blocks_ready = false;
+        aws_mutex_unlock(&exercise.lock);
+        aws_condition_variable_notify_one(&exercise.signal);
+    }
+
+    if (launched) {
+        aws_thread_join(&worker);
+    }
+    aws_thread_clean_up(&worker);
+    aws_condition_variable_clean_up(&exercise.signal);
+    aws_mutex_clean_up(&exercise.lock);
+    aws_mem_release(allocator, exercise.blocks);
+
+    if (!launched) {
+        aws_napi_throw_last_error_with_context(env, "Unable to launch memory pool worker thread");
+        return NULL;
+    }
+
+    uint64_t cache_count = 0;
+    aws_mutex_lock(&s_small_object_pool.lock);
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&s_small_object_pool.caches);
+         node != aws_linked_list_end(&s_small_object_pool.caches);
+         node = aws_linked_list_next(node)) {
+        ++cache_count;
+    }
+    aws_mutex_unlock(&s_small_object_pool.lock);
+
+    size_t cache_limit_bytes =
+        AWS_NAPI_SMALL_OBJECT_CACHE_LIMIT * s_small_object_block_size(s_small_object_size_class(64));
+
+    napi_value node_result = NULL;
+    AWS_NAPI_CALL(env, napi_create_object(env, &node_result), { return NULL; });
+
+    if (aws_napi_attach_object_property_u64(node_result, env, "max_bytes_kept", exercise.max_bytes_kept) ||
+        aws_napi_attach_object_property_u64(node_result, env, "cache_limit_bytes", cache_limit_bytes) ||
+        aws_napi_attach_object_property_u64(node_result, env, "cache_count", cache_count)) {
+        napi_throw_error(env, NULL, "Unable to build memory pool exercise results");
+        return NULL;
+    }
+
+    return node_result;
+}
+
 #if defined(_WIN32)
 #    include <windows.h>
 static LONG WINAPI s_print_stack_trace(struct _EXCEPTION_POINTERS *exception_pointers) {
@@ -1187,13 +2425,14 @@ static void s_uninstall_crash_handler(void) {
 #endif
 }
 
-static struct aws_mutex s_module_lock = AWS_MUTEX_INIT;
-static uint32_t s_module_initialize_count = 0;
 
 static void s_napi_context_finalize(napi_env env, void *user_data, void *finalize_hint) {
     (void)env;
     (void)finalize_hint;
 
+    /* node threads can't register an exit hook, so give up this thread's pool cache along with its environment */
+    s_small_object_cache_orphan(s_small_object_cache_current());
+
     aws_mutex_lock(&s_module_lock);
     AWS_FATAL_ASSERT(s_module_initialize_count > 0);
     --s_module_initialize_count;
@@ -1211,30 +2450,25 @@ static void s_napi_context_finalize(napi_env env, void *user_data, void *finaliz
 
         aws_thread_join_all_managed();
 
+        s_small_object_pool_clean_up();
+
         aws_unregister_log_subject_info_list(&s_log_subject_list);
         aws_unregister_error_info(&s_error_list);
-        aws_event_stream_library_clean_up();
-        aws_auth_library_clean_up();
-        aws_mqtt_library_clean_up();
+        s_library_clean_up();
+        aws_common_library_clean_up();
 
         s_uninstall_crash_handler();
-        // clean up threadsafe function lock
-        aws_rw_lock_clean_up(&s_tsfn_lock);
     }
 
     struct aws_napi_context *ctx = user_data;
     aws_napi_logger_destroy(ctx->logger);
-    struct aws_allocator *ctx_allocator = ctx->allocator;
     aws_mem_release(ctx->allocator, ctx);
 
-    if (s_module_initialize_count == 0) {
-        if (ctx_allocator != aws_default_allocator()) {
-            if (s_allocator == ctx_allocator) {
-                s_allocator = NULL;
-            }
-            aws_mem_tracer_destroy(ctx_allocator);
-        }
-    }
+    /*
+     * The base allocator (and the tracer, if enabled) lives for the life of the process. Worker threads can take the
+     * initialize count to 0 and back many times, and finalizers from an environment that is going away may still
+     * release memory after the count has hit 0.
+     */
     aws_mutex_unlock(&s_module_lock);
 }
 
@@ -1251,16 +2485,107 @@ static struct aws_napi_context *s_napi_context_new(struct aws_allocator *allocat
     return ctx;
 }
 
+/*
+ * Libraries that have been initialized, as a mask of enum aws_napi_library. Only grows between module initialization
+ * and the final clean up, so the fast path is a single load.
+ */
+static struct aws_atomic_var s_initialized_libraries = AWS_ATOMIC_INIT_INT(0);
+static struct aws_mutex s_library_lock = AWS_MUTEX_INIT;
+
+void aws_napi_ensure_library_initialized(uint32_t libraries) {
+    if ((aws_atomic_load_int(&s_initialized_libraries) & libraries) == libraries) {
+        return;
+    }
+
+    aws_mutex_lock(&s_library_lock);
+
+    size_t initialized = aws_atomic_load_int(&s_initialized_libraries);
+    uint32_t missing = libraries & ~(uint32_t)initialized;
+    struct aws_allocator *allocator = aws_napi_get_allocator();
+
+    /* each of these initializes its own dependencies */
+    if (missing & AWS_NAPI_LIBRARY_CAL) {
+        aws_cal_library_init(allocator);
+    }
+    if (missing & AWS_NAPI_LIBRARY_IO) {
+        aws_io_library_init(allocator);
+    }
+    if (missing & AWS_NAPI_LIBRARY_HTTP) {
+        aws_http_library_init(allocator);
+    }
+    if (missing & AWS_NAPI_LIBRARY_MQTT) {
+        aws_mqtt_library_init(allocator);
+    }
+    if (missing & AWS_NAPI_LIBRARY_AUTH) {
+        aws_auth_library_init(allocator);
+    }
+    if (missing & AWS_NAPI_LIBRARY_EVENT_STREAM) {
+        aws_event_stream_library_init(allocator);
+    }
+
+    aws_atomic_store_int(&s_initialized_libraries, initialized | libraries);
+
+    aws_mutex_unlock(&s_library_lock);
+}
+
+/* Cleans up whichever libraries were initialized, in reverse dependency order */
+static void s_library_clean_up(void) {
+    aws_mutex_lock(&s_library_lock);
+
+    size_t initialized = aws_atomic_load_int(&s_initialized_libraries);
+
+    if (initialized & AWS_NAPI_LIBRARY_EVENT_STREAM) {
+        aws_event_stream_library_clean_up();
+    }
+    if (initialized & AWS_NAPI_LIBRARY_AUTH) {
+        aws_auth_library_clean_up();
+    }
+    if (initialized & AWS_NAPI_LIBRARY_MQTT) {
+        aws_mqtt_library_clean_up();
+    }
+    if (initialized & AWS_NAPI_LIBRARY_HTTP) {
+        aws_http_library_clean_up();
+    }
+    if (initialized & AWS_NAPI_LIBRARY_IO) {
+        aws_io_library_clean_up();
+    }
+    if (initialized & AWS_NAPI_LIBRARY_CAL) {
+        aws_cal_library_clean_up();
+    }
+
+    aws_atomic_store_int(&s_initialized_libraries, 0);
+
+    aws_mutex_unlock(&s_library_lock);
+}
+
+/* An exported function, along with the libraries it needs initialized before it runs */
+struct aws_napi_library_function {
+    napi_callback fn;
+    uint32_t libraries;
+};
+
+static napi_value s_call_library_function(napi_env env, napi_callback_info info) {
+    const struct aws_napi_library_function *function = NULL;
+    AWS_NAPI_CALL(env, napi_get_cb_info(env, info, NULL, NULL, NULL, (void **)&function), {
+        napi_throw_error(env, NULL, "Failed to retrieve callback information");
+        return NULL;
+    });
+
+    aws_napi_ensure_library_initialized(function->libraries);
+    return function->fn(env, info);
+}
+
 /** Helper for creating and registering a function */
 static bool s_create_and_register_function(
     napi_env env,
     napi_value exports,
     napi_callback fn,
+    void *data,
     const char *fn_name,
     size_t fn_name_len) {
 
     napi_value napi_fn;
-    AWS_NAPI_CALL(env, napi_create_function(env, fn_name, fn_name_len, fn, NULL, &napi_fn), {
+    AWS_NAPI_CALL(env, napi_create_function(env, fn_name, fn_name_len, fn, data, &napi_fn), {
         napi_throw_error(env, NULL, "Unable to wrap native function");
         return false;
     });
@@ -1286,52 +2611,21 @@ static bool s_create_and_register_function(
     struct aws_allocator *allocator = aws_napi_get_allocator();
 
     if (s_module_initialize_count == 0) {
-        aws_rw_lock_init(&s_tsfn_lock);
         s_aws_enable_threadsafe_function();
 
         s_install_crash_handler();
 
-        aws_mqtt_library_init(allocator);
-        aws_auth_library_init(allocator);
-        aws_event_stream_library_init(allocator);
+        s_small_object_pool_init(allocator);
+
+        /* The rest of the native libraries are initialized by the first binding that needs them */
+        aws_common_library_init(allocator);
         aws_register_error_info(&s_error_list);
         aws_register_log_subject_info_list(&s_log_subject_list);
 
-        /* Initialize the event loop group */
         /*
-         * We don't currently support multi-init of the module, but we should.
-         * Things that would need to be solved:
-         *    (1) global objects (event loop group, logger, allocator, more)
-         *    (2) multi-init/multi-cleanup of aws-c-*
-         *    (3) allocator cross-talk/lifetimes
-         */
-        AWS_FATAL_ASSERT(s_node_uv_elg == NULL);
-        s_node_uv_elg = aws_event_loop_group_new_default(allocator, 1, NULL);
-        AWS_FATAL_ASSERT(s_node_uv_elg != NULL);
-
-        /*
-         * Default host resolver and client bootstrap to use if none specific at the javascript level.  In most
-         * cases the user doesn't even need to know about these, so let's let them leave it out completely.
+         * The default event loop group, host resolver and client bootstrap are created lazily on first use, so that
+         * the event loop thread count can be configured after the module is loaded.
          */
-        AWS_FATAL_ASSERT(s_default_host_resolver == NULL);
-
-        struct aws_host_resolver_default_options resolver_options = {
-            .max_entries = 64,
-            .el_group = s_node_uv_elg,
-        };
-        s_default_host_resolver = aws_host_resolver_new_default(allocator, &resolver_options);
-        AWS_FATAL_ASSERT(s_default_host_resolver != NULL);
-
-        AWS_FATAL_ASSERT(s_default_client_bootstrap == NULL);
-
-        struct aws_client_bootstrap_options bootstrap_options = {
-            .event_loop_group = s_node_uv_elg,
-            .host_resolver = s_default_host_resolver,
-        };
-
-        s_default_client_bootstrap = aws_client_bootstrap_new(allocator, &bootstrap_options);
-
-        AWS_FATAL_ASSERT(s_default_client_bootstrap != NULL);
     }
 
     ++s_module_initialize_count;
@@ -1345,96 +2639,140 @@ static bool s_create_and_register_function(
     napi_get_null(env, &null);
 
 #define CREATE_AND_REGISTER_FN(fn)                                                                                     \
-    if (!s_create_and_register_function(env, exports, aws_napi_##fn, #fn, sizeof(#fn))) {                              \
+    if (!s_create_and_register_function(env, exports, aws_napi_##fn, NULL, #fn, sizeof(#fn))) {                        \
         return null;                                                                                                   \
     }
 
+/* Same as CREATE_AND_REGISTER_FN, but initializes the given libraries before the first call */
+#define CREATE_AND_REGISTER_LIBRARY_FN(fn, libs)                                                                       \
+    {                                                                                                                  \
+        static const struct aws_napi_library_function s_library_fn = {.fn = aws_napi_##fn, .libraries = (libs)};       \
+        if (!s_create_and_register_function(                                                                           \
+                env, exports, s_call_library_function, (void *)&s_library_fn, #fn, sizeof(#fn))) {                     \
+            return null;                                                                                               \
+        }                                                                                                              \
+    }
+
     /* Common */
     CREATE_AND_REGISTER_FN(native_memory)
     CREATE_AND_REGISTER_FN(native_memory_dump)
-    CREATE_AND_REGISTER_FN(error_code_to_string)
-    CREATE_AND_REGISTER_FN(error_code_to_name)
+    CREATE_AND_REGISTER_FN(native_memory_breakdown)
+    CREATE_AND_REGISTER_FN(native_memory_pool_statistics)
+    CREATE_AND_REGISTER_FN(native_memory_pool_exercise)
+    CREATE_AND_REGISTER_LIBRARY_FN(error_code_to_string, AWS_NAPI_LIBRARY_ALL)
+    CREATE_AND_REGISTER_LIBRARY_FN(error_code_to_name, AWS_NAPI_LIBRARY_ALL)
     CREATE_AND_REGISTER_FN(disable_threadsafe_function)
 
     /* IO */
-    CREATE_AND_REGISTER_FN(io_logging_enable)
-    CREATE_AND_REGISTER_FN(is_alpn_available)
-    CREATE_AND_REGISTER_FN(io_client_bootstrap_new)
-    CREATE_AND_REGISTER_FN(io_tls_ctx_new)
-    CREATE_AND_REGISTER_FN(io_tls_connection_options_new);
-    CREATE_AND_REGISTER_FN(io_socket_options_new)
-    CREATE_AND_REGISTER_FN(io_input_stream_new)
-    CREATE_AND_REGISTER_FN(io_input_stream_append)
-    CREATE_AND_REGISTER_FN(io_pkcs11_lib_new)
-    CREATE_AND_REGISTER_FN(io_pkcs11_lib_close)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_enable, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_enable_file, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_disable_file, AWS_NAPI_LIBRARY_IO)
+    /* subjects are looked up by name, so every library needs to have registered its subjects */
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_set_subject_level, AWS_NAPI_LIBRARY_ALL)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_set_subject_rate_limit, AWS_NAPI_LIBRARY_ALL)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_get_subject_level, AWS_NAPI_LIBRARY_ALL)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_logging_log, AWS_NAPI_LIBRARY_ALL)
+    CREATE_AND_REGISTER_LIBRARY_FN(is_alpn_available, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_client_bootstrap_new, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_set_default_event_loop_thread_count, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_set_default_host_resolver_options, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_host_resolver_new, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_host_resolver_resolve, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_host_resolver_prefetch, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_tls_ctx_new, AWS_NAPI_LIBRARY_IO | AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_FN(io_tls_ctx_cache_statistics)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_tls_connection_options_new, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_socket_options_new, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_new, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_append, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_new_from_file, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_get_length, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_read, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_is_end_of_stream, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_input_stream_seek, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_pkcs11_lib_new, AWS_NAPI_LIBRARY_IO)
+    CREATE_AND_REGISTER_LIBRARY_FN(io_pkcs11_lib_close, AWS_NAPI_LIBRARY_IO)
 
     /* MQTT5 Client */
-    CREATE_AND_REGISTER_FN(mqtt5_client_new)
-    CREATE_AND_REGISTER_FN(mqtt5_client_start)
-    CREATE_AND_REGISTER_FN(mqtt5_client_stop)
-    CREATE_AND_REGISTER_FN(mqtt5_client_subscribe)
-    CREATE_AND_REGISTER_FN(mqtt5_client_unsubscribe)
-    CREATE_AND_REGISTER_FN(mqtt5_client_publish)
-    CREATE_AND_REGISTER_FN(mqtt5_client_get_queue_statistics)
-    CREATE_AND_REGISTER_FN(mqtt5_client_close)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_new, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_start, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_stop, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_subscribe, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_unsubscribe, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_publish, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_get_queue_statistics, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt5_client_close, AWS_NAPI_LIBRARY_MQTT)
 
     /* MQTT Client */
-    CREATE_AND_REGISTER_FN(mqtt_client_new)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_new, AWS_NAPI_LIBRARY_MQTT)
 
     /* MQTT Client Connection */
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_new)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_connect)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_reconnect)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_publish)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_subscribe)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_on_message)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_on_closed)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_unsubscribe)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_disconnect)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_close)
-    CREATE_AND_REGISTER_FN(mqtt_client_connection_get_queue_statistics)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_new, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_connect, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_reconnect, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_publish, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_subscribe, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_on_message, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_on_closed, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_unsubscribe, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_disconnect, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_close, AWS_NAPI_LIBRARY_MQTT)
+    CREATE_AND_REGISTER_LIBRARY_FN(mqtt_client_connection_get_queue_statistics, AWS_NAPI_LIBRARY_MQTT)
 
     /* Crypto */
-    CREATE_AND_REGISTER_FN(hash_md5_new)
-    CREATE_AND_REGISTER_FN(hash_sha1_new)
-    CREATE_AND_REGISTER_FN(hash_sha256_new)
-    CREATE_AND_REGISTER_FN(hash_update)
-    CREATE_AND_REGISTER_FN(hash_digest)
-    CREATE_AND_REGISTER_FN(hash_md5_compute)
-    CREATE_AND_REGISTER_FN(hash_sha1_compute)
-    CREATE_AND_REGISTER_FN(hash_sha256_compute)
-    CREATE_AND_REGISTER_FN(hmac_sha256_new)
-    CREATE_AND_REGISTER_FN(hmac_update)
-    CREATE_AND_REGISTER_FN(hmac_digest)
-    CREATE_AND_REGISTER_FN(hmac_sha256_compute)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_md5_new, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha1_new, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha256_new, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_update, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_digest, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_md5_compute, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha1_compute, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha256_compute, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hmac_sha256_new, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hmac_update, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hmac_digest, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hmac_sha256_compute, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_md5_compute_async, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha1_compute_async, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha256_compute_async, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hmac_sha256_compute_async, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_update_async, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hmac_update_async, AWS_NAPI_LIBRARY_CAL)
+    CREATE_AND_REGISTER_LIBRARY_FN(hash_sha256_many, AWS_NAPI_LIBRARY_CAL)
 
     /* Checksums */
     CREATE_AND_REGISTER_FN(checksums_crc32)
     CREATE_AND_REGISTER_FN(checksums_crc32c)
+    CREATE_AND_REGISTER_FN(checksums_crc32_combine)
+    CREATE_AND_REGISTER_FN(checksums_crc32c_combine)
+    CREATE_AND_REGISTER_FN(checksums_crc32_async)
+    CREATE_AND_REGISTER_FN(checksums_crc32c_async)
+    CREATE_AND_REGISTER_FN(checksums_crc32c_parts)
 
     /* HTTP */
-    CREATE_AND_REGISTER_FN(http_proxy_options_new)
-    CREATE_AND_REGISTER_FN(http_connection_new)
-    CREATE_AND_REGISTER_FN(http_connection_close)
-    CREATE_AND_REGISTER_FN(http_stream_new)
-    CREATE_AND_REGISTER_FN(http_stream_activate)
-    CREATE_AND_REGISTER_FN(http_stream_close)
-    CREATE_AND_REGISTER_FN(http_connection_manager_new)
-    CREATE_AND_REGISTER_FN(http_connection_manager_close)
-    CREATE_AND_REGISTER_FN(http_connection_manager_acquire)
-    CREATE_AND_REGISTER_FN(http_connection_manager_release)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_proxy_options_new, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_connection_new, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_connection_close, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_stream_new, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_stream_activate, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_stream_close, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_connection_manager_new, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_connection_manager_close, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_connection_manager_acquire, AWS_NAPI_LIBRARY_HTTP)
+    CREATE_AND_REGISTER_LIBRARY_FN(http_connection_manager_release, AWS_NAPI_LIBRARY_HTTP)
 
     /* Event stream */
-    CREATE_AND_REGISTER_FN(event_stream_client_connection_new)
-    CREATE_AND_REGISTER_FN(event_stream_client_connection_connect)
-    CREATE_AND_REGISTER_FN(event_stream_client_connection_close)
-    CREATE_AND_REGISTER_FN(event_stream_client_connection_close_internal)
-    CREATE_AND_REGISTER_FN(event_stream_client_connection_send_protocol_message)
-    CREATE_AND_REGISTER_FN(event_stream_client_stream_new)
-    CREATE_AND_REGISTER_FN(event_stream_client_stream_close)
-    CREATE_AND_REGISTER_FN(event_stream_client_stream_activate)
-    CREATE_AND_REGISTER_FN(event_stream_client_stream_send_message)
-
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_connection_new, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_connection_connect, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_connection_close, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_connection_close_internal, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_connection_send_protocol_message, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_stream_new, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_stream_close, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_stream_activate, AWS_NAPI_LIBRARY_EVENT_STREAM)
+    CREATE_AND_REGISTER_LIBRARY_FN(event_stream_client_stream_send_message, AWS_NAPI_LIBRARY_EVENT_STREAM)
+
+#undef CREATE_AND_REGISTER_LIBRARY_FN
 #undef CREATE_AND_REGISTER_FN
 
     AWS_NAPI_ENSURE(env, aws_napi_http_headers_bind(env, exports));
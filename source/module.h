@@ -30,11 +30,14 @@
 struct aws_client_bootstrap;
 struct aws_event_loop;
 struct aws_event_loop_group;
+struct aws_host_resolution_config;
+struct aws_host_resolver;
 
 enum aws_crt_nodejs_errors {
     AWS_CRT_NODEJS_ERROR_THREADSAFE_FUNCTION_NULL_NAPI_ENV = AWS_ERROR_ENUM_BEGIN_RANGE(AWS_CRT_NODEJS_PACKAGE_ID),
     AWS_CRT_NODEJS_ERROR_NAPI_FAILURE,
     AWS_CRT_NODEJS_ERROR_EVENT_STREAM_USER_CLOSE,
+    AWS_CRT_NODEJS_ERROR_THREADSAFE_QUEUE_FULL,
 
     AWS_CRT_NODEJS_ERROR_END_RANGE = AWS_ERROR_ENUM_END_RANGE(AWS_CRT_NODEJS_PACKAGE_ID)
 };
@@ -206,6 +209,24 @@ int aws_napi_get_property_array_size(
     size_t *array_size_out);
 
 napi_status aws_byte_buf_init_from_napi(struct aws_byte_buf *buf, napi_env env, napi_value node_str);
+
+/*
+ * Suggested size for stack storage passed to aws_byte_buf_init_from_napi_with_storage(). Covers topics, header names
+ * and values and most small hash inputs.
+ */
+#define AWS_NAPI_SMALL_STRING_STORAGE_SIZE 256
+
+/*
+ * Same as aws_byte_buf_init_from_napi(), except that a string short enough to fit in storage is copied there instead
+ * of into a new allocation. storage must outlive buf. buf->allocator is NULL whenever nothing was allocated, so
+ * aws_byte_buf_clean_up() is always safe to call on the result.
+ */
+napi_status aws_byte_buf_init_from_napi_with_storage(
+    struct aws_byte_buf *buf,
+    napi_env env,
+    napi_value node_str,
+    uint8_t *storage,
+    size_t storage_size);
 struct aws_string *aws_string_new_from_napi(napi_env env, napi_value node_str);
 /** Copies data from cur into a new ArrayBuffer, then returns a DataView to the buffer. */
 napi_status aws_napi_create_dataview_from_byte_cursor(
@@ -220,9 +241,40 @@ void aws_napi_throw_last_error_with_context(napi_env env, const char *context);
 
 struct uv_loop_s *aws_napi_get_node_uv_loop(void);
 struct aws_event_loop *aws_napi_get_node_event_loop(void);
+/*
+ * The default event loop group and client bootstrap are created on first use.  The thread count of the default event
+ * loop group comes from io_set_default_event_loop_thread_count(), the AWS_CRT_EVENT_LOOP_THREAD_COUNT environment
+ * variable, or defaults to 1.
+ */
 struct aws_event_loop_group *aws_napi_get_node_elg(void);
 struct aws_client_bootstrap *aws_napi_get_default_client_bootstrap(void);
 
+/*
+ * The host resolver behind the default client bootstrap, created along with it.  Its size and TTL come from
+ * io_set_default_host_resolver_options().  out_config receives the resolution settings the default bootstrap uses.
+ * The resolver is not acquired on the caller's behalf.
+ */
+struct aws_host_resolver *aws_napi_get_default_host_resolver(struct aws_host_resolution_config *out_config);
+
+/* TTL aws_client_bootstrap applies to resolved addresses when it is given no resolution config */
+#define AWS_NAPI_DEFAULT_DNS_TTL_SECS 30
+
+/*
+ * Fills in resolution settings using the default DNS implementation.  A max_ttl_secs of 0 uses
+ * AWS_NAPI_DEFAULT_DNS_TTL_SECS.
+ */
+void aws_napi_init_host_resolution_config(struct aws_host_resolution_config *config, size_t max_ttl_secs);
+
+/**
+ * Sets the thread count of the default event loop group.  Throws if the default group has already been created.
+ */
+napi_value aws_napi_io_set_default_event_loop_thread_count(napi_env env, napi_callback_info info);
+
+/**
+ * Sets the size and TTL of the default host resolver.  Throws if the default resolver has already been created.
+ */
+napi_value aws_napi_io_set_default_host_resolver_options(napi_env env, napi_callback_info info);
+
 const char *aws_napi_status_to_str(napi_status status);
 
 /*
@@ -250,6 +302,77 @@ napi_status aws_napi_create_external_arraybuffer(
  */
 struct aws_allocator *aws_napi_get_allocator(void);
 
+/*
+ * Native libraries that are initialized on first use by the bindings that need them, so that loading the module stays
+ * cheap for processes that only use part of it.
+ */
+enum aws_napi_library {
+    AWS_NAPI_LIBRARY_CAL = 1 << 0,
+    AWS_NAPI_LIBRARY_IO = 1 << 1,
+    AWS_NAPI_LIBRARY_HTTP = 1 << 2,
+    AWS_NAPI_LIBRARY_MQTT = 1 << 3,
+    AWS_NAPI_LIBRARY_AUTH = 1 << 4,
+    AWS_NAPI_LIBRARY_EVENT_STREAM = 1 << 5,
+
+    AWS_NAPI_LIBRARY_ALL = (1 << 6) - 1,
+};
+
+/**
+ * Initializes the given libraries (a mask of enum aws_napi_library), if they aren't already. Can be called from any
+ * thread, and is a single atomic load once the libraries are up. Functions registered with the module declare the
+ * libraries they need, as do class binder constructors and methods (aws_napi_method_info::libraries), so bindings
+ * only need to call this from entry points outside of both.
+ */
+void aws_napi_ensure_library_initialized(uint32_t libraries);
+
+/*
+ * Subsystems that native memory is charged to. Each binding allocates through its own tag so that
+ * native_memory_breakdown() can show where memory is being held.
+ */
+enum aws_napi_memory_tag {
+    AWS_NAPI_MEMORY_TAG_GENERAL,
+    AWS_NAPI_MEMORY_TAG_MQTT5,
+    AWS_NAPI_MEMORY_TAG_MQTT3,
+    AWS_NAPI_MEMORY_TAG_HTTP,
+    AWS_NAPI_MEMORY_TAG_EVENT_STREAM,
+    AWS_NAPI_MEMORY_TAG_AUTH,
+    AWS_NAPI_MEMORY_TAG_IO,
+    AWS_NAPI_MEMORY_TAG_LOGGER,
+
+    AWS_NAPI_MEMORY_TAG_COUNT,
+};
+
+/**
+ * Gets an allocator that charges everything it allocates to the given tag. aws_napi_get_allocator() is the
+ * AWS_NAPI_MEMORY_TAG_GENERAL allocator. Memory from any tagged allocator may be released through any other.
+ */
+struct aws_allocator *aws_napi_get_tagged_allocator(enum aws_napi_memory_tag tag);
+
+/**
+ * Returns an object with the active bytes, active allocation count and peak bytes for each memory tag.
+ */
+napi_value aws_napi_native_memory_breakdown(napi_env env, napi_callback_info info);
+
+/**
+ * Gets a pooled allocator for the small, fixed-size structs that carry events from native threads to the node thread.
+ * Each thread allocates from its own cache without locking. Memory may be freed on a different thread than it was
+ * allocated on, in which case it is handed back to the allocating thread's cache. Requests larger than the pool's
+ * size classes fall through to aws_napi_get_allocator().
+ */
+struct aws_allocator *aws_napi_get_small_object_allocator(void);
+
+/**
+ * Returns how many small object allocations reused a cached block, needed a new one, or were too large to pool, along
+ * with the bytes reserved by and the number of thread caches.
+ */
+napi_value aws_napi_native_memory_pool_statistics(napi_env env, napi_callback_info info);
+
+/**
+ * Test hook: a worker thread allocates `count` small blocks per round for `rounds` rounds, which the calling thread
+ * frees. Returns the most the worker's cache kept between rounds, the cache limit in bytes, and the number of caches.
+ */
+napi_value aws_napi_native_memory_pool_exercise(napi_env env, napi_callback_info info);
+
 /**
  * Wrapper around napi_call_function that automatically substitutes undefined for a null this_ptr
  * and un-pins the function reference when the call completes. Also handles known recoverable
@@ -309,6 +432,94 @@ napi_status aws_napi_unref_threadsafe_function(napi_env env, napi_threadsafe_fun
  */
 napi_status aws_napi_queue_threadsafe_function(napi_threadsafe_function function, void *user_data);
 
+/*
+ * A batched threadsafe function. Items are pushed from any thread into a queue, and at most one call into node is
+ * queued at a time. When it runs, everything pending is delivered within that single call, either as one array
+ * argument, or by invoking the JS function once per item.
+ *
+ * The JS function is invoked as fn([prepared,] item) or fn([prepared,] [items...]), where the optional leading
+ * argument comes from the prepare callback.
+ */
+struct aws_napi_threadsafe_batch;
+struct aws_linked_list_node;
+
+/* Converts a queued item to a JS value. Ownership of the item passes to this callback, whether it succeeds or not. */
+typedef int(aws_napi_threadsafe_batch_item_to_js_fn)(
+    napi_env env,
+    struct aws_linked_list_node *item,
+    void *user_data,
+    napi_value *result);
+
+/* Frees an item that will never be delivered to node, e.g. because the function was released */
+typedef void(aws_napi_threadsafe_batch_item_destroy_fn)(struct aws_linked_list_node *item, void *user_data);
+
+/* Optional, produces the leading argument once per drain. Failing causes the drained items to be dropped. */
+typedef int(aws_napi_threadsafe_batch_prepare_fn)(napi_env env, void *user_data, napi_value *result);
+
+/*
+ * Optional, invoked with true on the pushing thread when the number of undelivered items reaches the high watermark,
+ * and with false on the node thread once it has drained back down to the low watermark. Producers can use this to
+ * stop and restart reading. The false call is made with the batch's lock held, so it must not push or query
+ * statistics, and it is never made once aws_napi_threadsafe_batch_release() has returned.
+ */
+typedef void(aws_napi_threadsafe_batch_watermark_fn)(bool above_high_watermark, void *user_data);
+
+struct aws_napi_threadsafe_batch_options {
+    aws_napi_threadsafe_batch_item_to_js_fn *item_to_js;
+    aws_napi_threadsafe_batch_item_destroy_fn *item_destroy;
+    aws_napi_threadsafe_batch_prepare_fn *prepare;
+    void *user_data;
+
+    /* If true, the JS function receives all drained items as a single array, otherwise it is called once per item */
+    bool deliver_as_array;
+
+    /* Maximum number of undelivered items, 0 for no limit. Pushing beyond it fails with THREADSAFE_QUEUE_FULL. */
+    size_t max_pending;
+
+    /* Only used if on_watermark is set, low_watermark must be less than high_watermark */
+    size_t high_watermark;
+    size_t low_watermark;
+    aws_napi_threadsafe_batch_watermark_fn *on_watermark;
+};
+
+struct aws_napi_threadsafe_batch_statistics {
+    /* Items pushed but not yet delivered to node */
+    size_t pending_count;
+    size_t peak_pending_count;
+    /* Items rejected because max_pending was reached */
+    uint64_t dropped_count;
+    uint64_t delivered_count;
+};
+
+/**
+ * Creates a batched threadsafe function bound to a JS function. Must be called from the node thread.
+ */
+struct aws_napi_threadsafe_batch *aws_napi_threadsafe_batch_new(
+    struct aws_allocator *allocator,
+    napi_env env,
+    napi_value function,
+    const char *name,
+    const struct aws_napi_threadsafe_batch_options *options);
+
+/**
+ * Queues an item for delivery to node. Can be called from any thread. If this fails, ownership of the item stays with
+ * the caller.
+ */
+int aws_napi_threadsafe_batch_push(struct aws_napi_threadsafe_batch *batch, struct aws_linked_list_node *item);
+
+/**
+ * Gets a snapshot of the queue depth and delivery counters. Can be called from any thread.
+ */
+void aws_napi_threadsafe_batch_get_statistics(
+    struct aws_napi_threadsafe_batch *batch,
+    struct aws_napi_threadsafe_batch_statistics *stats);
+
+/**
+ * Releases the batch. Items that have not been delivered are destroyed once node finalizes the function. No items
+ * may be pushed, and on_watermark will not be called, after this returns, so user_data may be freed. NULL is allowed.
+ */
+void aws_napi_threadsafe_batch_release(struct aws_napi_threadsafe_batch *batch);
+
 /**
  * Disable the thread safe function operations. The function will prevent any access to threadsafe function
  * including acquire, release, function call and so on.
@@ -8,6 +8,7 @@
 #include "http_message.h"
 #include "io.h"
 
+#include <aws/common/linked_list.h>
 #include <aws/http/proxy.h>
 #include <aws/io/socket.h>
 #include <aws/io/tls_channel_handler.h>
@@ -95,6 +96,10 @@ static const char *AWS_NAPI_KEY_OUTBOUND_BEHAVIOR = "outboundBehavior";
 static const char *AWS_NAPI_KEY_OUTBOUND_CACHE_MAX_SIZE = "outboundCacheMaxSize";
 static const char *AWS_NAPI_KEY_INBOUND_BEHAVIOR = "inboundBehavior";
 static const char *AWS_NAPI_KEY_INBOUND_CACHE_MAX_SIZE = "inboundCacheMaxSize";
+static const char *AWS_NAPI_KEY_MAX_PENDING_MESSAGES = "maxPendingMessages";
+static const char *AWS_NAPI_KEY_PENDING_MESSAGE_COUNT = "pendingMessageCount";
+static const char *AWS_NAPI_KEY_PEAK_PENDING_MESSAGE_COUNT = "peakPendingMessageCount";
+static const char *AWS_NAPI_KEY_DROPPED_MESSAGE_COUNT = "droppedMessageCount";
 
 /*
  * Binding object that outlives the associated napi wrapper object.  When that object finalizes, then it's a signal
@@ -136,7 +141,13 @@ struct aws_mqtt5_client_binding {
     napi_threadsafe_function on_connection_success;
     napi_threadsafe_function on_connection_failure;
     napi_threadsafe_function on_disconnection;
-    napi_threadsafe_function on_message_received;
+
+    /*
+     * Received messages are batched so that bursts are delivered in one threadsafe function call, and bounded by
+     * max_pending_messages (0 for no bound) so that a stalled node thread can't buffer without limit.
+     */
+    struct aws_napi_threadsafe_batch *on_message_received;
+    uint32_t max_pending_messages;
 
     napi_threadsafe_function transform_websocket;
 };
@@ -153,7 +164,8 @@ static void s_aws_mqtt5_client_binding_destroy(struct aws_mqtt5_client_binding *
     AWS_CLEAN_THREADSAFE_FUNCTION(binding, on_connection_success);
     AWS_CLEAN_THREADSAFE_FUNCTION(binding, on_connection_failure);
     AWS_CLEAN_THREADSAFE_FUNCTION(binding, on_disconnection);
-    AWS_CLEAN_THREADSAFE_FUNCTION(binding, on_message_received);
+    aws_napi_threadsafe_batch_release(binding->on_message_received);
+    binding->on_message_received = NULL;
     AWS_CLEAN_THREADSAFE_FUNCTION(binding, transform_websocket);
 
     aws_mem_release(binding->allocator, binding);
@@ -214,6 +226,8 @@ static void s_aws_mqtt5_client_extern_finalize(napi_env env, void *finalize_data
 }
 
 struct on_message_received_user_data {
+    struct aws_linked_list_node node;
+    /* allocator for the packet storage and binary buffers, the struct itself comes from the small object allocator */
     struct aws_allocator *allocator;
     struct aws_mqtt5_client_binding *binding;
     struct aws_mqtt5_packet_publish_storage publish_storage;
@@ -240,7 +254,7 @@ static void s_on_message_received_user_data_destroy(struct on_message_received_u
         aws_mem_release(user_data->allocator, user_data->correlation_data);
     }
 
-    aws_mem_release(user_data->allocator, user_data);
+    aws_mem_release(aws_napi_get_small_object_allocator(), user_data);
 }
 
 static struct on_message_received_user_data *s_on_message_received_user_data_new(
@@ -248,7 +262,7 @@ static struct on_message_received_user_data *s_on_message_received_user_data_new
     const struct aws_mqtt5_packet_publish_view *publish_packet) {
 
     struct on_message_received_user_data *user_data =
-        aws_mem_calloc(binding->allocator, 1, sizeof(struct on_message_received_user_data));
+        aws_mem_calloc(aws_napi_get_small_object_allocator(), 1, sizeof(struct on_message_received_user_data));
     user_data->allocator = binding->allocator;
 
     /*
@@ -305,7 +319,15 @@ static void s_on_publish_received(const struct aws_mqtt5_packet_publish_view *pu
     }
 
     /* queue a callback in node's libuv thread */
-    AWS_NAPI_ENSURE(NULL, aws_napi_queue_threadsafe_function(binding->on_message_received, message_received_ud));
+    if (aws_napi_threadsafe_batch_push(binding->on_message_received, &message_received_ud->node)) {
+        AWS_LOGF_WARN(
+            AWS_LS_NODEJS_CRT_GENERAL,
+            "id=%p s_on_publish_received - dropping received message, error %d(%s)",
+            (void *)binding->client,
+            aws_last_error(),
+            aws_error_debug_str(aws_last_error()));
+        s_on_message_received_user_data_destroy(message_received_ud);
+    }
 }
 
 struct on_simple_event_user_data {
@@ -1179,47 +1201,73 @@ static int s_create_napi_publish_packet(
     return AWS_OP_SUCCESS;
 }
 
-/* in-node/libuv-thread function to trigger the emission of a PUBLISH packet on the messageReceived event */
-static void s_napi_on_message_received(napi_env env, napi_value function, void *context, void *user_data) {
-    (void)context;
+/* in-node/libuv-thread function that resolves the mqtt5 client once for a batch of received messages */
+static int s_napi_on_message_received_prepare(napi_env env, void *user_data, napi_value *result) {
+    struct aws_mqtt5_client_binding *binding = user_data;
 
-    struct on_message_received_user_data *on_message_received_ud = user_data;
-    struct aws_mqtt5_client_binding *binding = on_message_received_ud->binding;
+    /*
+     * If we can't resolve the weak ref to the mqtt5 client, then it's been garbage collected and we should not
+     * do anything.
+     */
+    *result = NULL;
+    if (napi_get_reference_value(env, binding->node_mqtt5_client_ref, result) != napi_ok || *result == NULL) {
+        AWS_LOGF_INFO(
+            AWS_LS_NODEJS_CRT_GENERAL,
+            "id=%p s_napi_on_message_received_prepare - mqtt5_client node wrapper no longer resolvable",
+            (void *)binding->client);
+        return AWS_OP_ERR;
+    }
 
-    if (env) {
-        napi_value params[2];
-        const size_t num_params = AWS_ARRAY_SIZE(params);
+    return AWS_OP_SUCCESS;
+}
 
-        /*
-         * If we can't resolve the weak ref to the mqtt5 client, then it's been garbage collected and we should not
-         * do anything.
-         */
-        params[0] = NULL;
-        if (napi_get_reference_value(env, binding->node_mqtt5_client_ref, &params[0]) != napi_ok || params[0] == NULL) {
-            AWS_LOGF_INFO(
-                AWS_LS_NODEJS_CRT_GENERAL,
-                "id=%p s_napi_on_message_received - mqtt5_client node wrapper no longer resolvable",
-                (void *)binding->client);
-            goto done;
-        }
+/* in-node/libuv-thread function to build the PUBLISH packet emitted on the messageReceived event */
+static int s_napi_on_message_received(
+    napi_env env,
+    struct aws_linked_list_node *item,
+    void *user_data,
+    napi_value *result) {
+    (void)user_data;
 
-        if (s_create_napi_publish_packet(env, on_message_received_ud, &params[1])) {
-            AWS_LOGF_ERROR(
-                AWS_LS_NODEJS_CRT_GENERAL,
-                "id=%p s_napi_on_message_received - failed to create publish object",
-                (void *)binding->client);
-            goto done;
-        }
+    struct on_message_received_user_data *on_message_received_ud =
+        AWS_CONTAINER_OF(item, struct on_message_received_user_data, node);
+    struct aws_mqtt5_client_binding *binding = on_message_received_ud->binding;
 
-        AWS_NAPI_ENSURE(
-            env,
-            aws_napi_dispatch_threadsafe_function(
-                env, binding->on_message_received, NULL, function, num_params, params));
+    int create_result = s_create_napi_publish_packet(env, on_message_received_ud, result);
+    if (create_result) {
+        AWS_LOGF_ERROR(
+            AWS_LS_NODEJS_CRT_GENERAL,
+            "id=%p s_napi_on_message_received - failed to create publish object",
+            (void *)binding->client);
     }
 
-done:
-
     s_on_message_received_user_data_destroy(on_message_received_ud);
+
+    return create_result;
+}
+
+static void s_on_message_received_item_destroy(struct aws_linked_list_node *item, void *user_data) {
+    (void)user_data;
+
+    s_on_message_received_user_data_destroy(AWS_CONTAINER_OF(item, struct on_message_received_user_data, node));
+}
+
+static void s_on_message_received_watermark(bool above_high_watermark, void *user_data) {
+    struct aws_mqtt5_client_binding *binding = user_data;
+
+    if (above_high_watermark) {
+        AWS_LOGF_WARN(
+            AWS_LS_NODEJS_CRT_GENERAL,
+            "id=%p received messages are backing up waiting for the node thread, messages will be dropped if %u are "
+            "pending",
+            (void *)binding->client,
+            binding->max_pending_messages);
+    } else {
+        AWS_LOGF_INFO(
+            AWS_LS_NODEJS_CRT_GENERAL,
+            "id=%p received message backlog has drained below the low watermark",
+            (void *)binding->client);
+    }
 }
 
 /*
@@ -1250,7 +1298,7 @@ static int s_aws_mqtt5_user_properties_extract_from_js_object(
         return AWS_OP_SUCCESS;
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     /* len of js array */
     uint32_t user_property_count = 0;
@@ -2002,6 +2050,13 @@ static int s_init_client_configuration_from_js_client_configuration(
             env, node_client_config, AWS_NAPI_KEY_ACK_TIMEOUT_SECONDS, &client_options->ack_timeout_seconds),
         {});
 
+    PARSE_OPTIONAL_NAPI_PROPERTY(
+        AWS_NAPI_KEY_MAX_PENDING_MESSAGES,
+        "s_init_client_configuration_from_js_client_configuration",
+        aws_napi_get_named_property_as_uint32(
+            env, node_client_config, AWS_NAPI_KEY_MAX_PENDING_MESSAGES, &binding->max_pending_messages),
+        {});
+
     napi_value napi_value_connect = NULL;
     if (AWS_NGNPR_VALID_VALUE ==
         aws_napi_get_named_property(
@@ -2110,7 +2165,7 @@ napi_value aws_napi_mqtt5_client_new(napi_env env, napi_callback_info info) {
 
     napi_value napi_client_wrapper = NULL;
     napi_value node_external = NULL;
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     struct aws_mqtt5_client_binding *binding = aws_mem_calloc(allocator, 1, sizeof(struct aws_mqtt5_client_binding));
     binding->allocator = allocator;
@@ -2262,12 +2317,28 @@ napi_value aws_napi_mqtt5_client_new(napi_env env, napi_callback_info info) {
         goto cleanup;
     }
 
-    if (s_init_event_handler_threadsafe_function(
-            env,
-            on_message_received_event_handler,
-            "aws_mqtt5_client_on_message_received",
-            s_napi_on_message_received,
-            &binding->on_message_received)) {
+    struct aws_napi_threadsafe_batch_options on_message_received_options = {
+        .item_to_js = s_napi_on_message_received,
+        .item_destroy = s_on_message_received_item_destroy,
+        .prepare = s_napi_on_message_received_prepare,
+        .user_data = binding,
+        /* one JS call per drained batch rather than per message */
+        .deliver_as_array = true,
+        .max_pending = binding->max_pending_messages,
+    };
+    if (binding->max_pending_messages > 0) {
+        on_message_received_options.high_watermark = binding->max_pending_messages - binding->max_pending_messages / 4;
+        on_message_received_options.low_watermark = binding->max_pending_messages / 4;
+        on_message_received_options.on_watermark = s_on_message_received_watermark;
+    }
+
+    binding->on_message_received = aws_napi_threadsafe_batch_new(
+        allocator,
+        env,
+        on_message_received_event_handler,
+        "aws_mqtt5_client_on_message_received",
+        &on_message_received_options);
+    if (binding->on_message_received == NULL) {
         napi_throw_error(env, NULL, "mqtt5_client_new - failed to initialize on_message_received event handler");
         goto cleanup;
     }
@@ -2692,7 +2763,7 @@ static void s_on_subscribe_complete(
     int error_code,
     void *complete_ctx) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
     struct aws_napi_mqtt5_operation_binding *binding = complete_ctx;
 
     binding->error_code = error_code;
@@ -2815,7 +2886,7 @@ static int s_aws_mqtt5_packet_subscribe_storage_init_from_napi(
         }
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     if (aws_array_list_init_dynamic(
             &subscribe_storage->subscriptions,
@@ -2886,7 +2957,7 @@ static int s_aws_mqtt5_packet_subscribe_storage_init_from_napi(
 }
 
 napi_value aws_napi_mqtt5_client_subscribe(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     napi_value node_args[3];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
@@ -3086,7 +3157,7 @@ static void s_on_unsubscribe_complete(
     int error_code,
     void *complete_ctx) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
     struct aws_napi_mqtt5_operation_binding *binding = complete_ctx;
 
     binding->error_code = error_code;
@@ -3151,19 +3222,22 @@ static int s_aws_mqtt5_packet_unsubscribe_storage_init_from_napi(
         napi_value napi_topic_filter = NULL;
         AWS_NAPI_CALL(env, napi_get_element(env, napi_topic_filters, i, &napi_topic_filter), { return AWS_OP_ERR; });
 
+        uint8_t topic_filter_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
         struct aws_byte_buf topic_filter_buf;
         AWS_ZERO_STRUCT(topic_filter_buf);
 
-        AWS_NAPI_CALL(env, aws_byte_buf_init_from_napi(&topic_filter_buf, env, napi_topic_filter), {
-            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-        });
+        AWS_NAPI_CALL(
+            env,
+            aws_byte_buf_init_from_napi_with_storage(
+                &topic_filter_buf, env, napi_topic_filter, topic_filter_storage, sizeof(topic_filter_storage)),
+            { return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT); });
 
         topic_filter_length_sum += topic_filter_buf.len;
 
         aws_byte_buf_clean_up(&topic_filter_buf);
     }
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     if (aws_array_list_init_dynamic(
             &unsubscribe_storage->topic_filter_cursors,
@@ -3181,12 +3255,15 @@ static int s_aws_mqtt5_packet_unsubscribe_storage_init_from_napi(
         napi_value napi_topic_filter = NULL;
         AWS_NAPI_CALL(env, napi_get_element(env, napi_topic_filters, i, &napi_topic_filter), { return AWS_OP_ERR; });
 
+        uint8_t topic_filter_storage[AWS_NAPI_SMALL_STRING_STORAGE_SIZE];
         struct aws_byte_buf topic_filter_buf;
         AWS_ZERO_STRUCT(topic_filter_buf);
 
-        AWS_NAPI_CALL(env, aws_byte_buf_init_from_napi(&topic_filter_buf, env, napi_topic_filter), {
-            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-        });
+        AWS_NAPI_CALL(
+            env,
+            aws_byte_buf_init_from_napi_with_storage(
+                &topic_filter_buf, env, napi_topic_filter, topic_filter_storage, sizeof(topic_filter_storage)),
+            { return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT); });
 
         struct aws_byte_cursor topic_filter = aws_byte_cursor_from_buf(&topic_filter_buf);
 
@@ -3222,7 +3299,7 @@ static int s_aws_mqtt5_packet_unsubscribe_storage_init_from_napi(
 }
 
 napi_value aws_napi_mqtt5_client_unsubscribe(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     napi_value node_args[3];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
@@ -3403,7 +3480,7 @@ static void s_on_publish_complete(
     int error_code,
     void *complete_ctx) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
     struct aws_napi_mqtt5_operation_binding *binding = complete_ctx;
 
     binding->error_code = error_code;
@@ -3423,7 +3500,7 @@ static void s_on_publish_complete(
 }
 
 napi_value aws_napi_mqtt5_client_publish(napi_env env, napi_callback_info info) {
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT5);
 
     napi_value node_args[3];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
@@ -3514,6 +3591,7 @@ done:
 static int s_create_napi_mqtt5_client_statistics(
     napi_env env,
     const struct aws_mqtt5_client_operation_statistics *stats,
+    const struct aws_napi_threadsafe_batch_statistics *message_stats,
     napi_value *stats_out) {
 
     if (env == NULL) {
@@ -3544,6 +3622,21 @@ static int s_create_napi_mqtt5_client_statistics(
         return AWS_OP_ERR;
     };
 
+    if (aws_napi_attach_object_property_u64(
+            napi_stats, env, AWS_NAPI_KEY_PENDING_MESSAGE_COUNT, message_stats->pending_count)) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_napi_attach_object_property_u64(
+            napi_stats, env, AWS_NAPI_KEY_PEAK_PENDING_MESSAGE_COUNT, message_stats->peak_pending_count)) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_napi_attach_object_property_u64(
+            napi_stats, env, AWS_NAPI_KEY_DROPPED_MESSAGE_COUNT, message_stats->dropped_count)) {
+        return AWS_OP_ERR;
+    }
+
     *stats_out = napi_stats;
 
     return AWS_OP_SUCCESS;
@@ -3589,8 +3682,14 @@ napi_value aws_napi_mqtt5_client_get_queue_statistics(napi_env env, napi_callbac
 
     aws_mqtt5_client_get_stats(client_binding->client, &stats);
 
+    struct aws_napi_threadsafe_batch_statistics message_stats;
+    AWS_ZERO_STRUCT(message_stats);
+    if (client_binding->on_message_received != NULL) {
+        aws_napi_threadsafe_batch_get_statistics(client_binding->on_message_received, &message_stats);
+    }
+
     napi_value napi_stats = NULL;
-    if (s_create_napi_mqtt5_client_statistics(env, &stats, &napi_stats)) {
+    if (s_create_napi_mqtt5_client_statistics(env, &stats, &message_stats, &napi_stats)) {
         napi_throw_error(env, NULL, "aws_napi_mqtt5_client_get_queue_statistics - failed to build statistics value");
         return NULL;
     }
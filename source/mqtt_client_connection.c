@@ -379,7 +379,7 @@ static void s_on_connection_failure(struct aws_mqtt_client_connection *connectio
 
 napi_value aws_napi_mqtt_client_connection_new(napi_env env, napi_callback_info cb_info) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT3);
 
     napi_value node_args[14];
     size_t num_args = AWS_ARRAY_SIZE(node_args);
@@ -1164,7 +1164,7 @@ static void s_on_publish_complete(
 
 napi_value aws_napi_mqtt_client_connection_publish(napi_env env, napi_callback_info info) {
 
-    struct aws_allocator *allocator = aws_napi_get_allocator();
+    struct aws_allocator *allocator = aws_napi_get_tagged_allocator(AWS_NAPI_MEMORY_TAG_MQTT3);
 
     struct puback_args *args = aws_mem_calloc(allocator, 1, sizeof(struct puback_args));
     AWS_FATAL_ASSERT(args);
@@ -1371,6 +1371,7 @@ static void s_on_publish_user_data_clean_up(void *user_data) {
 
 /* arguments for publish callbacks */
 struct on_publish_args {
+    /* allocator for the topic and payload, the struct itself comes from the small object allocator */
     struct aws_allocator *allocator;
     struct aws_byte_buf topic;    /* owned by this */
     struct aws_byte_buf *payload; /* owned by this until the external array buffer in the direct callback is created */
@@ -1399,7 +1400,7 @@ static void s_destroy_on_publish_args(struct on_publish_args *args) {
 
     aws_byte_buf_clean_up(&args->topic);
 
-    aws_mem_release(args->allocator, args);
+    aws_mem_release(aws_napi_get_small_object_allocator(), args);
 }
 
 static void s_publish_external_arraybuffer_finalizer(napi_env env, void *finalize_data, void *finalize_hint) {
@@ -1474,7 +1475,8 @@ static void s_on_publish(
     AWS_NAPI_ENSURE(NULL, napi_get_threadsafe_function_context(sub->on_publish, (void **)&binding));
 
     struct aws_allocator *allocator = binding->allocator;
-    struct on_publish_args *args = aws_mem_calloc(allocator, 1, sizeof(struct on_publish_args));
+    struct on_publish_args *args =
+        aws_mem_calloc(aws_napi_get_small_object_allocator(), 1, sizeof(struct on_publish_args));
     AWS_FATAL_ASSERT(args);
 
     args->allocator = allocator;